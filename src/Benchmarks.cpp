@@ -0,0 +1,523 @@
+#include <algorithm>
+#include <iostream>
+#include <vector>
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "Benchmarks.h"
+#include "ProgressiveMesh.h"
+
+#pragma warning(disable: 4018)  // signed/unsigned mismatch
+
+using namespace std;
+
+extern double get_wall_time();
+extern size_t get_peak_rss();
+
+// Mesh with the vertex traits VertexHeapT needs
+typedef OpenMesh::TriMesh_ArrayKernelT<OpenMesh::Decimater::DefaultTraits> HeapTraitsMesh;
+
+// Initial collapse priority of every vertex: the smallest quadric
+// error over its outgoing halfedges (no legality test).
+static void compute_priorities(PM& mesh, vector<float>& prios)
+{
+	Quadrics modQuadric(mesh);
+	modQuadric.initialize();
+
+	prios.assign(mesh.n_vertices(), -1.0f);
+
+	for (PM::VertexIter vit = mesh.vertices_begin(); vit != mesh.vertices_end(); ++vit)
+	{
+		PM::VertexHandle vh = mesh.handle(*vit);
+		float best = FLT_MAX;
+
+		for (PM::VertexOHalfedgeIter voh_it(mesh, vh); voh_it; ++voh_it)
+		{
+			Quadrics::CollapseInfo ci(mesh, voh_it.handle());
+			float prio = modQuadric.collapse_priority(ci);
+			if (prio >= 0.0f && prio < best) best = prio;
+		}
+
+		if (best < FLT_MAX) prios[vh.idx()] = best;
+	}
+}
+
+// Replays a decimation-like workload on a heap: insert all vertices,
+// then repeatedly pop the cheapest one and raise the priority of its
+// one-ring (as the quadric of the collapsed vertex would). Returns the
+// number of heap operations.
+template <class Heap, class Mesh>
+static unsigned int heap_workload(Mesh& mesh, const vector<float>& prios)
+{
+	vector<float> prio(prios);
+	unsigned int ops = 0;
+
+	Heap heap(mesh);
+	heap.reserve(mesh.n_vertices());
+
+	for (int i = 0; i < prio.size(); i++)
+	{
+		if (prio[i] < 0.0f) continue;
+		heap.insert(typename Mesh::VertexHandle(i), prio[i]);
+		ops++;
+	}
+
+	while (!heap.empty())
+	{
+		typename Mesh::VertexHandle vh = heap.front();
+		float p = heap.front_priority();
+		heap.pop_front();
+		ops++;
+
+		for (typename Mesh::VertexVertexIter vv_it = mesh.vv_iter(vh); vv_it; ++vv_it)
+		{
+			typename Mesh::VertexHandle n = vv_it.handle();
+			if (!heap.is_stored(n)) continue;
+
+			prio[n.idx()] += p;
+			heap.update(n, prio[n.idx()]);
+			ops++;
+		}
+	}
+
+	return ops;
+}
+
+template <class Heap, class Mesh>
+static void time_heap(const char* name, Mesh& mesh, const vector<float>& prios, int runs)
+{
+	unsigned int ops = 0;
+	Timer t;
+
+	for (int r = 0; r < runs; r++)
+		ops += heap_workload<Heap, Mesh>(mesh, prios);
+
+	double secs = t.get_elapsed();
+	cout << "  " << name << ": " << ops << " ops, " << secs << "s, "
+		<< (secs > 0.0 ? ops / secs : 0.0) << " ops/sec" << endl;
+}
+
+void bench_heap(const char* filename)
+{
+	cout << "\nBenchmark [bench_heap] " << filename << ".." << endl;
+
+	PM mesh;
+	OpenMesh::MeshIO::read_mesh(mesh, filename);
+
+	if (mesh.n_vertices() == 0) return;
+
+	vector<float> prios;
+	compute_priorities(mesh, prios);
+
+	const int runs = 10;
+	cout << "  " << mesh.n_vertices() << " vertices, " << runs << " runs" << endl;
+
+	// PM has no priority/heap_position traits, the original heap gets
+	// its own copy of the mesh that has them
+	HeapTraitsMesh traitsMesh;
+	OpenMesh::MeshIO::read_mesh(traitsMesh, filename);
+
+	time_heap< OpenMesh::Decimater::VertexHeapT<HeapTraitsMesh> >("HeapT<Vertex*>", traitsMesh, prios, runs);
+	time_heap< OpenMesh::Decimater::DAryHeapT<PM,2> >("2-ary", mesh, prios, runs);
+	time_heap< OpenMesh::Decimater::DAryHeapT<PM,4> >("4-ary", mesh, prios, runs);
+	time_heap< OpenMesh::Decimater::DAryHeapT<PM,8> >("8-ary", mesh, prios, runs);
+}
+
+// Closed torus of nu x nv vertices, for meshes larger than the models
+static void make_torus(PM& mesh, int nu, int nv)
+{
+	const float pi = 3.14159265f;
+	mesh.clear();
+
+	vector<PM::VertexHandle> vhandles(nu * nv);
+	for (int i = 0; i < nu; i++)
+	{
+		float u = 2.0f * pi * i / nu;
+		for (int j = 0; j < nv; j++)
+		{
+			// a little noise so the quadrics are not all zero
+			float v = 2.0f * pi * j / nv;
+			float r = 1.0f + 0.01f * sinf(7.0f * u) * cosf(5.0f * v);
+			vhandles[i * nv + j] = mesh.add_vertex(PM::Point(
+				(3.0f + r * cosf(v)) * cosf(u), (3.0f + r * cosf(v)) * sinf(u), r * sinf(v)));
+		}
+	}
+
+	for (int i = 0; i < nu; i++)
+	{
+		int i1 = (i + 1) % nu;
+		for (int j = 0; j < nv; j++)
+		{
+			int j1 = (j + 1) % nv;
+			mesh.add_face(vhandles[i * nv + j], vhandles[i1 * nv + j], vhandles[i1 * nv + j1]);
+			mesh.add_face(vhandles[i * nv + j], vhandles[i1 * nv + j1], vhandles[i * nv + j1]);
+		}
+	}
+}
+
+// Decimates mesh as far as it goes, the way buildPM() does, and prints
+// one line of key=value pairs:
+//
+//   BENCH decimate model=<name> mode=<serial|parallel> vertices=<n>
+//     collapses=<n> seconds=<wall> collapses_per_sec=<x> heap_ops=<n>
+//     legality_rejected=<n> priority_evals=<n> legality_evals=<n>
+//     peak_rss=<bytes>
+//
+// peak_rss is the peak of the whole process so far.
+static void time_decimate(const char* name, PM& mesh, bool parallel)
+{
+	mesh.update_face_normals();
+
+	int vertices = mesh.n_vertices();
+	double start = get_wall_time();
+
+	Decimater decimater(mesh);
+	Quadrics modQuadric(mesh);
+	modQuadric.set_parallel_initialize(parallel);
+	decimater.registrate(modQuadric);
+	decimater.initialize();
+	decimater.cache_priorities(true);
+	decimater.parallel_independent_sets(parallel);
+
+	unsigned int collapses = decimater.decimate();
+
+	double secs = get_wall_time() - start;
+	const Decimater::Statistics& stats = decimater.statistics();
+
+	cout << "BENCH decimate model=" << name
+		<< " mode=" << (parallel ? "parallel" : "serial")
+		<< " vertices=" << vertices
+		<< " collapses=" << collapses
+		<< " seconds=" << secs
+		<< " collapses_per_sec=" << (secs > 0.0 ? collapses / secs : 0.0)
+		<< " heap_ops=" << stats.n_heap_ops
+		<< " legality_rejected=" << stats.n_legality_rejected
+		<< " priority_evals=" << stats.n_priority_evals
+		<< " legality_evals=" << stats.n_legality_evals
+		<< " peak_rss=" << get_peak_rss() << endl;
+}
+
+void bench_decimate(const char* filename)
+{
+	const char* name = strrchr(filename, '/');
+	name = name ? name + 1 : filename;
+
+	for (int parallel = 0; parallel < 2; parallel++)
+	{
+#if !defined(_OPENMP)
+		if (parallel) break;
+#endif
+		PM mesh;
+		OpenMesh::MeshIO::read_mesh(mesh, filename);
+		if (mesh.n_vertices() == 0) return;
+
+		time_decimate(name, mesh, parallel != 0);
+	}
+}
+
+void bench_decimate_torus(int nu, int nv)
+{
+	char name[64];
+	sprintf(name, "torus-%dx%d", nu, nv);
+
+	for (int parallel = 0; parallel < 2; parallel++)
+	{
+#if !defined(_OPENMP)
+		if (parallel) break;
+#endif
+		PM mesh;
+		make_torus(mesh, nu, nv);
+
+		time_decimate(name, mesh, parallel != 0);
+	}
+}
+
+// Gives the sweep benchmark the split records
+class SweepPM : public ProgressiveMesh
+{
+public:
+	/// Make coarsen() look up every halfedge again
+	void forgetHalfedges()
+	{
+		for (int i = 0; i < pmInfos.size(); i++)
+			pmInfos[i].v0v1 = PM::HalfedgeHandle();
+	}
+};
+
+// Level sweeps from the finest to the coarsest level and back, one line
+// per sweep:
+//
+//   BENCH sweep model=<name> mode=stored|lookup direction=coarsen|refine
+//     levels=<n> seconds=<s> levels_per_sec=<n>
+//
+// mode=stored coarsens with the halfedges the splits recorded,
+// mode=lookup with find_halfedge() for every collapse.
+void bench_sweep(const char* filename, int runs)
+{
+	const char* name = strrchr(filename, '/');
+	name = name ? name + 1 : filename;
+
+	SweepPM pm;
+	if (!pm.readFile(filename)) return;
+	pm.buildPM();
+
+	int levels = pm.getMaxLevel() - pm.getMinLevel();
+
+	for (int run = 0; run < runs; run++)
+	{
+		for (int lookup = 0; lookup < 2; lookup++)
+		{
+			if (lookup) pm.forgetHalfedges();
+
+			double start = get_wall_time();
+			pm.coarsenToLevelN(pm.getMinLevel());
+			double coarsenSecs = get_wall_time() - start;
+
+			start = get_wall_time();
+			pm.refineToLevelN(pm.getMaxLevel());
+			double refineSecs = get_wall_time() - start;
+
+			const char* mode = lookup ? "lookup" : "stored";
+			cout << "BENCH sweep model=" << name << " mode=" << mode
+				<< " direction=coarsen levels=" << levels
+				<< " seconds=" << coarsenSecs
+				<< " levels_per_sec=" << (coarsenSecs > 0.0 ? levels / coarsenSecs : 0.0) << endl;
+			cout << "BENCH sweep model=" << name << " mode=" << mode
+				<< " direction=refine levels=" << levels
+				<< " seconds=" << refineSecs
+				<< " levels_per_sec=" << (refineSecs > 0.0 ? levels / refineSecs : 0.0) << endl;
+		}
+	}
+}
+
+// Gives the replay benchmark the compiled program and the positions
+class ReplayPM : public ProgressiveMesh
+{
+public:
+	void compile() { compileReplay(); }
+	int getReplaySplits() { return replay.getSplitCount(); }
+	size_t getReplayBytes() { return replay.getMemoryUsage(); }
+	size_t getBandBytes() { return bands.getMemoryUsage(); }
+
+	void getPoints(vector<PM::Point>& points)
+	{
+		points.resize(mesh.n_vertices());
+		for (int i = 0; i < points.size(); i++)
+			points[i] = mesh.point(PM::VertexHandle(i));
+	}
+
+	void setPoints(const vector<PM::Point>& points)
+	{
+		for (int i = 0; i < points.size(); i++)
+			mesh.set_point(PM::VertexHandle(i), points[i]);
+	}
+
+	/// Scale the detail vectors of the splits that add a vertex near
+	/// center, as FXGLPM::applyOperation() with the sphere on does
+	void scaleDetailsNear(const PM::Point& center, float radius, float factor, vector<int>& splits)
+	{
+		splits.clear();
+		for (int r = 0; r < vertexOrdering.size(); r++)
+		{
+			if ((mesh.point(vertexOrdering[r]) - center).norm() > radius) continue;
+			details.scale(r, factor);
+			splits.push_back(r);
+		}
+	}
+
+	PM::Point getCenter() { return (bbox_min + bbox_max) * 0.5f; }
+	float getDiagonal() { return (bbox_max - bbox_min).norm(); }
+};
+
+// Filter apply latency: restoring all levels after the detail vectors
+// changed, as FXGLPM::applyOperation() does. One line per run and mode:
+//
+//   BENCH replay model=<name> mode=compile splits=<n> seconds=<s> bytes=<n>
+//   BENCH replay model=<name> mode=restore|replay splits=<n> seconds=<s>
+//     max_diff=<d>
+//
+// mode=restore coarsens and walks the hierarchy with restoreDetailVectors(),
+// mode=replay runs the compiled program. Both start from the same
+// positions; max_diff is the largest coordinate difference between them.
+void bench_replay(const char* filename, int runs)
+{
+	const char* name = strrchr(filename, '/');
+	name = name ? name + 1 : filename;
+
+	ReplayPM pm;
+	if (!pm.readFile(filename)) return;
+	pm.buildPM();
+
+	double start = get_wall_time();
+	pm.compile();
+	double compileSecs = get_wall_time() - start;
+	int splits = pm.getReplaySplits();
+
+	cout << "BENCH replay model=" << name << " mode=compile splits=" << splits
+		<< " seconds=" << compileSecs << " bytes=" << pm.getReplayBytes() << endl;
+
+	vector<PM::Point> before, restored, replayed;
+	for (int run = 0; run < runs; run++)
+	{
+		pm.getPoints(before);
+
+		start = get_wall_time();
+		pm.coarsenToLevelN(pm.getMinLevel());
+		pm.restoreDetailVectors(pm.getMaxLevel());
+		double restoreSecs = get_wall_time() - start;
+		pm.getPoints(restored);
+
+		pm.setPoints(before);
+		start = get_wall_time();
+		pm.replayDetailVectors();
+		double replaySecs = get_wall_time() - start;
+		pm.getPoints(replayed);
+
+		float maxDiff = 0.0f;
+		for (int i = 0; i < restored.size(); i++)
+			for (int k = 0; k < 3; k++)
+				maxDiff = max(maxDiff, float(fabs(restored[i][k] - replayed[i][k])));
+
+		cout << "BENCH replay model=" << name << " mode=restore splits=" << splits
+			<< " seconds=" << restoreSecs << endl;
+		cout << "BENCH replay model=" << name << " mode=replay splits=" << splits
+			<< " seconds=" << replaySecs << " max_diff=" << maxDiff << endl;
+	}
+}
+
+// Filter latency with the sphere on, replaying only the splits the
+// changed detail vectors reach, for spheres of growing radius (as a
+// fraction of the bounding box diagonal) around the middle of the model:
+//
+//   BENCH region model=<name> radius=<f> changed=<n> evaluated=<n>
+//     splits=<n> seconds=<s> full_seconds=<s>
+//
+// full_seconds replays everything, for comparison.
+void bench_region(const char* filename)
+{
+	const char* name = strrchr(filename, '/');
+	name = name ? name + 1 : filename;
+
+	ReplayPM pm;
+	if (!pm.readFile(filename)) return;
+	pm.buildPM();
+
+	// the baseline
+	pm.replayDetailVectors();
+
+	float radii[] = { 0.02f, 0.05f, 0.1f, 0.25f, 0.5f };
+	for (int i = 0; i < sizeof(radii) / sizeof(radii[0]); i++)
+	{
+		vector<int> changed;
+		pm.scaleDetailsNear(pm.getCenter(), radii[i] * pm.getDiagonal(), 0.5f, changed);
+
+		double start = get_wall_time();
+		int evaluated = pm.replayDetailVectors(changed);
+		double secs = get_wall_time() - start;
+
+		// undo, so every radius starts from the same detail vectors
+		pm.scaleDetailsNear(pm.getCenter(), radii[i] * pm.getDiagonal(), 2.0f, changed);
+		pm.replayDetailVectors(changed);
+
+		start = get_wall_time();
+		pm.replayDetailVectors();
+		double fullSecs = get_wall_time() - start;
+
+		cout << "BENCH region model=" << name << " radius=" << radii[i]
+			<< " changed=" << changed.size() << " evaluated=" << evaluated
+			<< " splits=" << pm.getReplaySplits() << " seconds=" << secs 
+			<< " full_seconds=" << fullSecs << endl;
+	}
+}
+
+// Filter latency without the sphere, from precomputed detail bands
+// (--bands), against replaying all detail vectors:
+//
+//   BENCH bands model=<name> bands=<K> build_seconds=<s> seconds=<s>
+//     replay_seconds=<s> bytes=<n>
+//
+// build_seconds is the first apply, which builds the bands; seconds a
+// later one.
+void bench_bands(const char* filename)
+{
+	const char* name = strrchr(filename, '/');
+	name = name ? name + 1 : filename;
+
+	ReplayPM pm;
+	if (!pm.readFile(filename)) return;
+	pm.buildPM();
+
+	int counts[] = { 4, 8, 16 };
+	for (int i = 0; i < sizeof(counts) / sizeof(counts[0]); i++)
+	{
+		// the baseline the bands are built from
+		double start = get_wall_time();
+		pm.replayDetailVectors();
+		double replaySecs = get_wall_time() - start;
+
+		pm.setDetailBands(counts[i]);
+		vector<float> factors(counts[i], 1.0f);
+
+		start = get_wall_time();
+		pm.applyDetailBands(factors);
+		double buildSecs = get_wall_time() - start;
+
+		factors[counts[i] - 1] = 0.5f;
+		start = get_wall_time();
+		pm.applyDetailBands(factors);
+		double secs = get_wall_time() - start;
+
+		cout << "BENCH bands model=" << name << " bands=" << counts[i]
+			<< " build_seconds=" << buildSecs << " seconds=" << secs
+			<< " replay_seconds=" << replaySecs << " bytes=" << pm.getBandBytes() << endl;
+	}
+}
+
+// The files in models/
+static const char* models[] = {
+	"models/bunny.obj",
+	"models/manifold-cow.obj",
+	"models/mannequin.obj",
+	"models/pawn.obj",
+	"models/v1.obj",
+	NULL
+};
+
+void run_benchmarks(const char* which)
+{
+	cout << "Running benchmarks..." << endl;
+
+	if (!which || strcmp(which, "heap") == 0)
+	{
+		bench_heap("models/manifold-cow.obj");
+		bench_heap("models/bunny.obj");
+	}
+
+	if (!which || strcmp(which, "decimate") == 0)
+	{
+		for (int i = 0; models[i]; i++)
+			bench_decimate(models[i]);
+
+		bench_decimate_torus(256, 256);
+		bench_decimate_torus(1024, 512);
+	}
+
+	if (!which || strcmp(which, "sweep") == 0)
+		bench_sweep("models/manifold-cow.obj", 3);
+
+	if (!which || strcmp(which, "replay") == 0)
+		bench_replay("models/manifold-cow.obj", 3);
+
+	if (!which || strcmp(which, "region") == 0)
+	{
+		bench_region("models/manifold-cow.obj");
+		bench_region("models/bunny.obj");
+	}
+
+	if (!which || strcmp(which, "bands") == 0)
+	{
+		bench_bands("models/manifold-cow.obj");
+		bench_bands("models/bunny.obj");
+	}
+}
@@ -0,0 +1,11 @@
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#include <stddef.h>
+
+// Unautomated benchmarks, run with "--bench" on the command line.
+// which selects one group ("heap", "decimate", "sweep", "replay",
+// "region", "bands"), NULL runs all.
+void run_benchmarks(const char* which = NULL);
+
+#endif
@@ -0,0 +1,281 @@
+//=============================================================================
+//
+//                               OpenMesh
+//        Copyright (C) 2002 by Computer Graphics Group, RWTH Aachen
+//                           www.openmesh.org
+//
+//-----------------------------------------------------------------------------
+//
+//                                License
+//
+//   This library is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU Library General Public License as published
+//   by the Free Software Foundation, version 2.
+//
+//   This library is distributed in the hope that it will be useful, but
+//   WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Library General Public License for more details.
+//
+//   You should have received a copy of the GNU Library General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+//=============================================================================
+
+/** \file DecimaterHeapT.hh
+
+    Priority queues for DecimaterT, selected by its second template
+    parameter. Both are keyed on vertex handles and offer the same
+    interface:
+
+      reserve(n), empty(), size(), is_stored(vh),
+      insert(vh, prio), update(vh, prio), remove(vh),
+      front(), front_priority(), pop_front()
+
+    VertexHeapT is the original OpenMesh heap: it stores Mesh::Vertex*
+    and keeps priority and heap position in the vertex traits.
+
+    DAryHeapT is a D-ary heap over compact (priority, vertex index)
+    pairs, with the heap positions in a separate dense array. A sift
+    never touches the vertex records, and with D = 4 or 8 a level of
+    children shares one or two cache lines.
+ */
+
+#ifndef OPENMESH_DECIMATER_DECIMATERHEAPT_HH
+#define OPENMESH_DECIMATER_DECIMATERHEAPT_HH
+
+
+//== INCLUDES =================================================================
+
+#include <vector>
+#include <OpenMeshTools/Utils/HeapT.hh>
+
+
+//== NAMESPACE ================================================================
+
+namespace OpenMesh { // BEGIN_NS_OPENMESH
+namespace Decimater { // BEGIN_NS_DECIMATER
+
+
+//== CLASS DEFINITION =========================================================
+
+
+/** Utils::HeapT on Mesh::Vertex*. Needs the vertex traits \c priority
+    and \c heap_position (see Decimater::DefaultTraits).
+ */
+template <class Mesh>
+class VertexHeapT
+{
+public:
+
+   typedef typename Mesh::VertexHandle  VertexHandle;
+   typedef typename Mesh::Vertex        Vertex;
+
+   VertexHeapT(Mesh& _mesh) : mesh_(_mesh) {}
+
+   /// Reserve space for all vertices, reset their heap positions
+   void reserve(unsigned int _n)
+   {
+      heap_.reserve(_n);
+
+      typename Mesh::VertexIter v_it, v_end(mesh_.vertices_end());
+      for (v_it = mesh_.vertices_begin(); v_it != v_end; ++v_it)
+         heap_.reset_heap_position(&(*v_it));
+   }
+
+   bool empty() const         { return heap_.empty(); }
+   unsigned int size() const  { return heap_.size(); }
+
+   bool is_stored(VertexHandle _vh)
+   { return heap_.is_stored(&mesh_.vertex(_vh)); }
+
+   void insert(VertexHandle _vh, float _prio)
+   {
+      Vertex* vp = &mesh_.vertex(_vh);
+      vp->priority = _prio;
+      heap_.insert(vp);
+   }
+
+   void update(VertexHandle _vh, float _prio)
+   {
+      Vertex* vp = &mesh_.vertex(_vh);
+      vp->priority = _prio;
+      heap_.update(vp);
+   }
+
+   void remove(VertexHandle _vh)
+   {
+      Vertex* vp = &mesh_.vertex(_vh);
+      heap_.remove(vp);
+      vp->priority = -1;
+   }
+
+   VertexHandle front() const   { return mesh_.handle(*heap_.front()); }
+   float front_priority() const { return heap_.front()->priority; }
+   void pop_front()             { heap_.pop_front(); }
+
+private:
+
+   // heap interface
+   struct HeapInterface
+   {
+      static inline bool
+      less( const Vertex* _vp0, const Vertex* _vp1 )
+      { return (_vp0->priority < _vp1->priority); }
+
+      static inline bool
+      greater( const Vertex* _vp0, const Vertex* _vp1 )
+      { return (_vp0->priority > _vp1->priority); }
+
+      static inline int
+      get_heap_position(const Vertex* _vp)
+      { return _vp->heap_position; }
+
+      static inline void
+      set_heap_position(Vertex* _vp, int _pos)
+      { _vp->heap_position = _pos; }
+   };
+
+   Mesh&                                 mesh_;
+   Utils::HeapT<Vertex*, HeapInterface>  heap_;
+};
+
+
+//== CLASS DEFINITION =========================================================
+
+
+/** D-ary min-heap over (priority, vertex index) pairs. Heap positions
+    live in a dense array indexed by vertex index (-1 = not stored).
+    Does not need any vertex traits.
+ */
+template <class Mesh, int D = 4>
+class DAryHeapT
+{
+public:
+
+   typedef typename Mesh::VertexHandle  VertexHandle;
+
+   DAryHeapT(Mesh& /* _mesh */) {}
+
+   /// Reserve space for _n vertices, none of them stored
+   void reserve(unsigned int _n)
+   {
+      entries_.clear();
+      entries_.reserve(_n);
+      position_.assign(_n, -1);
+   }
+
+   bool empty() const         { return entries_.empty(); }
+   unsigned int size() const  { return entries_.size(); }
+
+   bool is_stored(VertexHandle _vh) const
+   { return position_[_vh.idx()] != -1; }
+
+   void insert(VertexHandle _vh, float _prio)
+   {
+      Entry  e(_prio, _vh.idx());
+
+      entries_.push_back(e);
+      sift_up(int(entries_.size()) - 1, e);
+   }
+
+   void update(VertexHandle _vh, float _prio)
+   {
+      int    pos = position_[_vh.idx()];
+      Entry  e(_prio, _vh.idx());
+
+      if (_prio < entries_[pos].priority)  sift_up(pos, e);
+      else                                 sift_down(pos, e);
+   }
+
+   void remove(VertexHandle _vh)
+   {
+      int    pos  = position_[_vh.idx()];
+      float  prio = entries_[pos].priority;
+      Entry  last = entries_.back();
+
+      position_[_vh.idx()] = -1;
+      entries_.pop_back();
+
+      // move the last entry into the hole
+      if (pos < int(entries_.size()))
+      {
+         if (last.priority < prio)  sift_up(pos, last);
+         else                       sift_down(pos, last);
+      }
+   }
+
+   VertexHandle front() const   { return VertexHandle(entries_[0].idx); }
+   float front_priority() const { return entries_[0].priority; }
+   void pop_front()             { remove(front()); }
+
+private:
+
+   struct Entry
+   {
+      Entry(float _prio, int _idx) : priority(_prio), idx(_idx) {}
+
+      float  priority;
+      int    idx;
+   };
+
+   /// Place _e at the hole _pos, moving it towards the root
+   void sift_up(int _pos, const Entry& _e)
+   {
+      while (_pos > 0)
+      {
+         int parent = (_pos - 1) / D;
+         if (!(_e.priority < entries_[parent].priority))
+            break;
+
+         place(_pos, entries_[parent]);
+         _pos = parent;
+      }
+      place(_pos, _e);
+   }
+
+   /// Place _e at the hole _pos, moving it towards the leaves
+   void sift_down(int _pos, const Entry& _e)
+   {
+      const int n = int(entries_.size());
+
+      for (;;)
+      {
+         int first = D * _pos + 1;
+         if (first >= n)
+            break;
+
+         // smallest child
+         int last = first + D < n ? first + D : n;
+         int best = first;
+         for (int c = first + 1; c < last; ++c)
+            if (entries_[c].priority < entries_[best].priority)
+               best = c;
+
+         if (!(entries_[best].priority < _e.priority))
+            break;
+
+         place(_pos, entries_[best]);
+         _pos = best;
+      }
+      place(_pos, _e);
+   }
+
+   void place(int _pos, const Entry& _e)
+   {
+      entries_[_pos]     = _e;
+      position_[_e.idx]  = _pos;
+   }
+
+   std::vector<Entry>  entries_;
+   std::vector<int>    position_;
+};
+
+
+//=============================================================================
+} // END_NS_DECIMATER
+} // END_NS_OPENMESH
+//=============================================================================
+#endif // OPENMESH_DECIMATER_DECIMATERHEAPT_HH defined
+//=============================================================================
@@ -1,450 +1,886 @@
-//=============================================================================
-//                                                                            
-//                               OpenMesh                                     
-//        Copyright (C) 2002 by Computer Graphics Group, RWTH Aachen          
-//                           www.openmesh.org                                 
-//                                                                            
-//-----------------------------------------------------------------------------
-//                                                                            
-//                                License                                     
-//                                                                            
-//   This library is free software; you can redistribute it and/or modify it 
-//   under the terms of the GNU Library General Public License as published  
-//   by the Free Software Foundation, version 2.                             
-//                                                                             
-//   This library is distributed in the hope that it will be useful, but       
-//   WITHOUT ANY WARRANTY; without even the implied warranty of                
-//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         
-//   Library General Public License for more details.                          
-//                                                                            
-//   You should have received a copy of the GNU Library General Public         
-//   License along with this library; if not, write to the Free Software       
-//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 
-//                                                                            
-//-----------------------------------------------------------------------------
-//                                                                            
-//   $Revision: 1.3 $
-//   $Date: 2002/12/05 06:45:26 $
-//                                                                            
-//=============================================================================
-
-/** \file DecimaterT.cc
- */
-
-
-//=============================================================================
-//
-//  CLASS DecimaterT - IMPLEMENTATION
-//
-//=============================================================================
-
-#define OPENMESH_DECIMATER_DECIMATERT_CC
-
-
-//== INCLUDES =================================================================
-
-#include "Config.hh"
-#include <vector>
-#include <float.h>
-#include "DecimaterT.hh"
-
-
-//== NAMESPACE =============================================================== 
-
-
-namespace OpenMesh { // BEGIN_NS_OPENMESH
-namespace Decimater { // BEGIN_NS_DECIMATER
-
-   
-//== IMPLEMENTATION ========================================================== 
-
-  
-
-/*--- get local configuration ---
-  
-           vl
-           * 
-	  / \
-         /   \
-        / fl  \
-    v0 *------>* v1
-        \ fr  /
-         \   /
-          \ /
-	   * 
-           vr
-*/
-
-template <class Mesh>
-CollapseInfoT<Mesh>::
-CollapseInfoT(Mesh& _mesh, typename Mesh::HalfedgeHandle _heh) :
-
-  mesh(_mesh),
-  v0v1(_heh),
-  v1v0(_mesh.opposite_halfedge_handle(v0v1)),
-  v0(_mesh.to_vertex_handle(v1v0)),
-  v1(_mesh.to_vertex_handle(v0v1)),
-  p0(_mesh.point(v0)),
-  p1(_mesh.point(v1)),
-  fl(_mesh.face_handle(v0v1)),
-  fr(_mesh.face_handle(v1v0))
-
-{
-  // get vl
-  if (fl.is_valid())
-  {
-    vlv1 = mesh.next_halfedge_handle(v0v1);
-    v0vl = mesh.next_halfedge_handle(vlv1);
-    vl   = mesh.to_vertex_handle(vlv1);
-    vlv1 = mesh.opposite_halfedge_handle(vlv1);
-    v0vl = mesh.opposite_halfedge_handle(v0vl);
-  }
-
-
-  // get vr
-  if (fr.is_valid())
-  {
-    vrv0 = mesh.next_halfedge_handle(v1v0);
-    v1vr = mesh.next_halfedge_handle(vrv0);
-    vr   = mesh.to_vertex_handle(vrv0);
-    vrv0 = mesh.opposite_halfedge_handle(vrv0);
-    v1vr = mesh.opposite_halfedge_handle(v1vr);
-  }
-}  
-
-
-//-----------------------------------------------------------------------------
-
-
-template <class Mesh>
-void
-DecimaterT<Mesh>::initialize()
-{
-   typename ModuleList::iterator m_it, m_end = bmodules_.end();
-
-   for (m_it=bmodules_.begin(); m_it != m_end; ++m_it)
-      (*m_it)->initialize();
-   cmodule_->initialize();
-}
-
-
-//-----------------------------------------------------------------------------
-
-// Moved to header
-/*
-template <typename Mesh>
-template< typename ModuleType > 
-bool
-DecimaterT<Mesh>::registrate(const ModuleType& _mod) 
-{
-   if ( _mod.is_binary() )
-   {
-      bmodules_.push_back( new ModuleType(_mod) );
-   }
-   else      
-   {
-      delete cmodule_;
-      cmodule_ = new ModuleType(_mod);
-   }
-   return true;
-}
-*/
-
-//-----------------------------------------------------------------------------
-
-template <class Mesh>
-bool
-DecimaterT<Mesh>::is_collapse_legal(const CollapseInfo& _ci)
-{
-
-  // locked ? deleted ?
-  if (mesh_.vertex(_ci.v0).locked() || 
-      mesh_.vertex(_ci.v0).deleted())
-    return false;
-
-
-
-  //--- feature test ---
-
-//   if (mesh_.vertex(_ci.v0).feature() &&
-//       !mesh_.vertex(_ci.v1).feature())
-//     return false;
-
-  if (mesh_.vertex(_ci.v0).feature() &&
-      !mesh_.edge(mesh_.edge_handle(_ci.v0v1)).feature())
-    return false;
-
-
-
-  //--- test one ring intersection ---
-
-  typename Mesh::VertexVertexIter  vv_it;
-  
-  for (vv_it = mesh_.vv_iter(_ci.v0); vv_it; ++vv_it)
-    vv_it->set_tagged(false);
-
-  for (vv_it = mesh_.vv_iter(_ci.v1); vv_it; ++vv_it)
-    vv_it->set_tagged(true);
-
-  for (vv_it = mesh_.vv_iter(_ci.v0); vv_it; ++vv_it)
-    if (vv_it->tagged() && 
-	vv_it.handle() != _ci.vl && 
-	vv_it.handle() != _ci.vr)
-      return false;
-
-  // if both are invalid OR equal -> fail
-  if (_ci.vl == _ci.vr) return false;
-
-
-  //--- test boundary cases ---
-
-  bool b0 = mesh_.is_boundary(_ci.v0),
-       b1 = mesh_.is_boundary(_ci.v1);
-
-  if (b0)
-  {
-    // don't collapse a boundary vertex to an inner one
-    if (!b1)  
-      return false;
-
-    else 
-    {
-      // edge between two boundary vertices has to be a boundary edge
-      if (!(mesh_.is_boundary(_ci.v0v1) || 
-	    mesh_.is_boundary(_ci.v1v0)))
-	return false;
-    }
-
-    // only one one ring intersection
-    if (_ci.vl.is_valid() && 
-	_ci.vr.is_valid())
-      return false;
-  }
-
-  // v0vl and v1vl must not both be boundary edges
-  if (_ci.vl.is_valid() &&
-      mesh_.is_boundary(_ci.vlv1) && 
-      mesh_.is_boundary(_ci.v0v1))
-    return false;
-  
-  // v0vr and v1vr must not be both boundary edges
-  if (_ci.vr.is_valid() &&
-      mesh_.is_boundary(_ci.vrv0) && 
-      mesh_.is_boundary(_ci.v1vr))
-    return false;
-  
-  // there have to be at least 2 incident faces at v0
-  if (mesh_.cw_rotated_halfedge_handle(
-       mesh_.cw_rotated_halfedge_handle(_ci.v0v1)) == _ci.v0v1)
-    return false;
-
-
-  // collapse passed all tests -> ok
-  return true;
-}
-
-
-//-----------------------------------------------------------------------------
-
-
-template <class Mesh>
-float
-DecimaterT<Mesh>::collapse_priority(const CollapseInfo& _ci)
-{
-  typename ModuleList::iterator m_it, m_end = bmodules_.end();
-
-  for (m_it = bmodules_.begin(); m_it != m_end; ++m_it)
-  {                         
-     if ( (*m_it)->collapse_priority(_ci) < 0.0)
-        return -1.0;
-  }     
-  return cmodule_->collapse_priority(_ci);
-}
-
-
-//-----------------------------------------------------------------------------
-
-
-template <class Mesh>
-void
-DecimaterT<Mesh>::heap_vertex(typename Mesh::VertexHandle _vh)
-{
-  typename Mesh::Vertex&          v(mesh_.vertex(_vh));
-  float                           prio, best_prio(FLT_MAX);
-  typename Mesh::HalfedgeHandle   heh, collapse_target;
-
-
-  // find best target in one ring
-  typename Mesh::VertexOHalfedgeIter voh_it(mesh_, _vh);
-  for (; voh_it; ++voh_it)
-  {
-    heh = voh_it.handle();
-    CollapseInfo  ci(mesh_, heh);
-
-    if (is_collapse_legal(ci))
-    {
-      prio = collapse_priority(ci);
-      if (prio >= 0.0 && prio < best_prio)
-      {
-	best_prio = prio;
-	collapse_target = heh;
-      }
-    }
-  }
-
-
-
-  // target found -> put vertex on heap
-  if (collapse_target.is_valid())
-  {
-    v.collapse_target = collapse_target;
-    v.priority        = best_prio;
-
-    if (heap_->is_stored(&v))  heap_->update(&v);
-    else                       heap_->insert(&v);
-  }
-
-  // not valid -> remove from heap
-  else
-  {
-    if (heap_->is_stored(&v))  heap_->remove(&v);
-
-    v.collapse_target = collapse_target;
-    v.priority        = -1;
-  }
-}
-
-
-//-----------------------------------------------------------------------------
-
-
-template <class Mesh>
-unsigned int
-DecimaterT<Mesh>::decimate( unsigned int _n_collapses )
-{
-   typename Mesh::VertexIter         v_it, v_end(mesh_.vertices_end());
-   typename Mesh::Vertex             *vp;
-   typename Mesh::HalfedgeHandle     v0v1;
-   typename Mesh::VertexVertexIter   vv_it;
-   typename Mesh::VertexFaceIter     vf_it;
-   unsigned int                      n_collapses(0);
-   ProgMeshInfo                      pminfo;
-
-   typedef std::vector<typename Mesh::VertexHandle>  Support;
-   typedef typename Support::iterator                SupportIterator;
-   
-   Support            support(15);
-   SupportIterator    s_it, s_end;
-
-
-   // check _n_collapses
-   if (!_n_collapses) _n_collapses = mesh_.n_vertices();
-
-  
-   // initialize heap
-   heap_ = new DeciHeap();
-   heap_->reserve(mesh_.n_vertices());
-
-   for (v_it = mesh_.vertices_begin(); v_it != v_end; ++v_it)
-   {
-      heap_->reset_heap_position(&(*v_it));
-      if (!v_it->deleted())
-         heap_vertex(v_it.handle());         
-   }
-
-
-   // reserve mem for prog mesh info
-   if (progmesh_info_)
-      progmesh_info_->reserve(_n_collapses);
-
-
-
-   // process heap
-   while ((!heap_->empty()) && (n_collapses < _n_collapses))
-   {
-      // get 1st heap entry
-      vp   = heap_->front();
-      v0v1 = vp->collapse_target;
-      heap_->pop_front();
-
-
-      // setup collapse info
-      CollapseInfo ci(mesh_, v0v1);
-
-
-      // check topological correctness AGAIN !
-      if (!is_collapse_legal(ci))
-         continue;
-    
-
-      // store support (= one ring of *vp)
-      vv_it = mesh_.vv_iter(ci.v0);
-      support.clear();
-      for (; vv_it; ++vv_it)
-         support.push_back(vv_it.handle());
-    
-
-      // store collapse/split information
-      if (progmesh_info_)
-      {
-         pminfo.v0 = ci.v0;
-         pminfo.v1 = ci.v1;
-         pminfo.vl = ci.vl;
-         pminfo.vr = ci.vr;
-
-         progmesh_info_->push_back(pminfo);
-      }
-
-
-      // perform collapse
-      mesh_.collapse(v0v1);
-      ++n_collapses;
-
-
-      // update triangle normals
-      vf_it = mesh_.vf_iter(ci.v1);
-      for (; vf_it; ++vf_it)
-         if (!vf_it->deleted())
-            vf_it->set_normal(mesh_.calc_face_normal(vf_it.handle()));
-
-    
-      // update quality modules
-      update_modules(ci);
-
-      // independent sets -> lock one ring of target vertex
-      if (independent_sets_)
-      {
-         mesh_.vertex(ci.v1).set_locked(true);
-         vv_it = mesh_.vv_iter(ci.v1);
-         for (; vv_it; ++vv_it)
-            vv_it->set_locked(true);
-      }
-
-
-      // update heap (former one ring of decimated vertex)
-      for (s_it = support.begin(), s_end = support.end();
-           s_it != s_end; ++s_it)
-      {
-         assert(!mesh_.vertex(*s_it).deleted());
-         heap_vertex(*s_it);
-      }
-   }
-
-
-   // delete heap
-   delete heap_;
-   heap_ = NULL;
-
-
-   // DON'T do garbage collection here! It's up to the application.
-
-
-   return n_collapses;
-}
-
-
-//=============================================================================
-} // END_NS_DECIMATER
-} // END_NS_OPENMESH
-//=============================================================================
-
+//=============================================================================
+//                                                                            
+//                               OpenMesh                                     
+//        Copyright (C) 2002 by Computer Graphics Group, RWTH Aachen          
+//                           www.openmesh.org                                 
+//                                                                            
+//-----------------------------------------------------------------------------
+//                                                                            
+//                                License                                     
+//                                                                            
+//   This library is free software; you can redistribute it and/or modify it 
+//   under the terms of the GNU Library General Public License as published  
+//   by the Free Software Foundation, version 2.                             
+//                                                                             
+//   This library is distributed in the hope that it will be useful, but       
+//   WITHOUT ANY WARRANTY; without even the implied warranty of                
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         
+//   Library General Public License for more details.                          
+//                                                                            
+//   You should have received a copy of the GNU Library General Public         
+//   License along with this library; if not, write to the Free Software       
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 
+//                                                                            
+//-----------------------------------------------------------------------------
+//                                                                            
+//   $Revision: 1.3 $
+//   $Date: 2002/12/05 06:45:26 $
+//                                                                            
+//=============================================================================
+
+/** \file DecimaterT.cc
+ */
+
+
+//=============================================================================
+//
+//  CLASS DecimaterT - IMPLEMENTATION
+//
+//=============================================================================
+
+#define OPENMESH_DECIMATER_DECIMATERT_CC
+
+
+//== INCLUDES =================================================================
+
+#include "Config.hh"
+#include <vector>
+#include <algorithm>
+#include <float.h>
+#include "DecimaterT.hh"
+
+extern double get_wall_time();
+
+
+//== NAMESPACE =============================================================== 
+
+
+namespace OpenMesh { // BEGIN_NS_OPENMESH
+namespace Decimater { // BEGIN_NS_DECIMATER
+
+   
+//== IMPLEMENTATION ========================================================== 
+
+  
+
+/*--- get local configuration ---
+  
+           vl
+           * 
+	  / \
+         /   \
+        / fl  \
+    v0 *------>* v1
+        \ fr  /
+         \   /
+          \ /
+	   * 
+           vr
+*/
+
+template <class Mesh>
+CollapseInfoT<Mesh>::
+CollapseInfoT(Mesh& _mesh, typename Mesh::HalfedgeHandle _heh) :
+
+  mesh(_mesh),
+  v0v1(_heh),
+  v1v0(_mesh.opposite_halfedge_handle(v0v1)),
+  v0(_mesh.to_vertex_handle(v1v0)),
+  v1(_mesh.to_vertex_handle(v0v1)),
+  p0(_mesh.point(v0)),
+  p1(_mesh.point(v1)),
+  fl(_mesh.face_handle(v0v1)),
+  fr(_mesh.face_handle(v1v0))
+
+{
+  // get vl
+  if (fl.is_valid())
+  {
+    vlv1 = mesh.next_halfedge_handle(v0v1);
+    v0vl = mesh.next_halfedge_handle(vlv1);
+    vl   = mesh.to_vertex_handle(vlv1);
+    vlv1 = mesh.opposite_halfedge_handle(vlv1);
+    v0vl = mesh.opposite_halfedge_handle(v0vl);
+  }
+
+
+  // get vr
+  if (fr.is_valid())
+  {
+    vrv0 = mesh.next_halfedge_handle(v1v0);
+    v1vr = mesh.next_halfedge_handle(vrv0);
+    vr   = mesh.to_vertex_handle(vrv0);
+    vrv0 = mesh.opposite_halfedge_handle(vrv0);
+    v1vr = mesh.opposite_halfedge_handle(v1vr);
+  }
+}  
+
+
+//-----------------------------------------------------------------------------
+
+
+template <class Mesh, class Heap>
+void
+DecimaterT<Mesh,Heap>::initialize()
+{
+   typename ModuleList::iterator m_it, m_end = bmodules_.end();
+
+   for (m_it=bmodules_.begin(); m_it != m_end; ++m_it)
+      (*m_it)->initialize();
+   cmodule_->initialize();
+}
+
+
+//-----------------------------------------------------------------------------
+
+// Moved to header
+/*
+template <typename Mesh, typename Heap>
+template< typename ModuleType > 
+bool
+DecimaterT<Mesh,Heap>::registrate(const ModuleType& _mod) 
+{
+   if ( _mod.is_binary() )
+   {
+      bmodules_.push_back( new ModuleType(_mod) );
+   }
+   else      
+   {
+      delete cmodule_;
+      cmodule_ = new ModuleType(_mod);
+   }
+   return true;
+}
+*/
+
+//-----------------------------------------------------------------------------
+
+template <class Mesh, class Heap>
+int
+DecimaterT<Mesh,Heap>::one_ring_indices(typename Mesh::VertexHandle _vh,
+                                        int* _stack, int _stack_size,
+                                        std::vector<int>& _heap,
+                                        int*& _result)
+{
+  typename Mesh::VertexVertexIter  vv_it;
+  int                              n(0);
+
+  _result = _stack;
+  for (vv_it = mesh_.vv_iter(_vh); vv_it; ++vv_it)
+  {
+    if (n == _stack_size && _result == _stack)
+    {
+      _heap.assign(_stack, _stack + n);
+      _result = 0;
+    }
+
+    if (_result)  _result[n] = vv_it.handle().idx();
+    else          _heap.push_back(vv_it.handle().idx());
+    ++n;
+  }
+
+  if (!_result)
+    _result = &_heap[0];
+
+  std::sort(_result, _result + n);
+  return n;
+}
+
+
+//-----------------------------------------------------------------------------
+
+template <class Mesh, class Heap>
+bool
+DecimaterT<Mesh,Heap>::is_collapse_legal(const CollapseInfo& _ci)
+{
+
+  // locked ? deleted ?
+  if (mesh_.vertex(_ci.v0).locked() || 
+      mesh_.vertex(_ci.v0).deleted())
+    return false;
+
+
+
+  //--- feature test ---
+
+//   if (mesh_.vertex(_ci.v0).feature() &&
+//       !mesh_.vertex(_ci.v1).feature())
+//     return false;
+
+  if (mesh_.vertex(_ci.v0).feature() &&
+      !mesh_.edge(mesh_.edge_handle(_ci.v0v1)).feature())
+    return false;
+
+
+
+  //--- test one ring intersection ---
+
+  // sorted neighbor indices of v0 and v1; on the stack unless the
+  // valence is very high. No tag bits, the mesh is not written.
+  const int  n_stack = 32;
+  int        stack0[n_stack], stack1[n_stack];
+  std::vector<int>  heap0, heap1;
+
+  int  *n0, *n1;
+  int  c0 = one_ring_indices(_ci.v0, stack0, n_stack, heap0, n0);
+  int  c1 = one_ring_indices(_ci.v1, stack1, n_stack, heap1, n1);
+
+  // only vl and vr may be common neighbors
+  int  vl = _ci.vl.idx(), vr = _ci.vr.idx();
+
+  for (int i = 0, j = 0; i < c0 && j < c1; )
+  {
+    if      (n0[i] < n1[j])  ++i;
+    else if (n1[j] < n0[i])  ++j;
+    else
+    {
+      if (n0[i] != vl && n0[i] != vr)
+        return false;
+      ++i; ++j;
+    }
+  }
+
+  // if both are invalid OR equal -> fail
+  if (_ci.vl == _ci.vr) return false;
+
+
+  //--- test boundary cases ---
+
+  bool b0 = mesh_.is_boundary(_ci.v0),
+       b1 = mesh_.is_boundary(_ci.v1);
+
+  if (b0)
+  {
+    // don't collapse a boundary vertex to an inner one
+    if (!b1)  
+      return false;
+
+    else 
+    {
+      // edge between two boundary vertices has to be a boundary edge
+      if (!(mesh_.is_boundary(_ci.v0v1) || 
+	    mesh_.is_boundary(_ci.v1v0)))
+	return false;
+    }
+
+    // only one one ring intersection
+    if (_ci.vl.is_valid() && 
+	_ci.vr.is_valid())
+      return false;
+  }
+
+  // v0vl and v1vl must not both be boundary edges
+  if (_ci.vl.is_valid() &&
+      mesh_.is_boundary(_ci.vlv1) && 
+      mesh_.is_boundary(_ci.v0v1))
+    return false;
+  
+  // v0vr and v1vr must not be both boundary edges
+  if (_ci.vr.is_valid() &&
+      mesh_.is_boundary(_ci.vrv0) && 
+      mesh_.is_boundary(_ci.v1vr))
+    return false;
+  
+  // there have to be at least 2 incident faces at v0
+  if (mesh_.cw_rotated_halfedge_handle(
+       mesh_.cw_rotated_halfedge_handle(_ci.v0v1)) == _ci.v0v1)
+    return false;
+
+
+  // collapse passed all tests -> ok
+  return true;
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+template <class Mesh, class Heap>
+float
+DecimaterT<Mesh,Heap>::collapse_priority(const CollapseInfo& _ci)
+{
+  typename ModuleList::iterator m_it, m_end = bmodules_.end();
+
+  for (m_it = bmodules_.begin(); m_it != m_end; ++m_it)
+  {                         
+     if ( (*m_it)->collapse_priority(_ci) < 0.0)
+        return -1.0;
+  }     
+  return cmodule_->collapse_priority(_ci);
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+template <class Mesh, class Heap>
+typename Mesh::HalfedgeHandle
+DecimaterT<Mesh,Heap>::find_collapse_target(typename Mesh::VertexHandle _vh,
+                                            float& _best_prio,
+                                            Statistics& _stats)
+{
+  float                           prio;
+  typename Mesh::HalfedgeHandle   heh, collapse_target;
+
+  _best_prio = FLT_MAX;
+
+
+  // find best target in one ring
+  typename Mesh::VertexOHalfedgeIter voh_it(mesh_, _vh);
+  for (; voh_it; ++voh_it)
+  {
+    heh = voh_it.handle();
+
+    if (cache_priorities_)
+    {
+      unsigned char& state = he_state_[heh.idx()];
+
+      if (state & LEGALITY_VALID)
+        ++_stats.n_legality_cached;
+
+      if (state & PRIORITY_VALID)
+        ++_stats.n_priority_cached;
+
+      if ((state & (LEGALITY_VALID | PRIORITY_VALID)) != 
+          (LEGALITY_VALID | PRIORITY_VALID))
+      {
+        CollapseInfo  ci(mesh_, heh);
+
+        if (!(state & LEGALITY_VALID))
+        {
+          ++_stats.n_legality_evals;
+          state |= LEGALITY_VALID;
+          if (is_collapse_legal(ci))  state |= LEGAL;
+          else                      { state &= ~LEGAL; ++_stats.n_legality_rejected; }
+        }
+
+        if ((state & LEGAL) && !(state & PRIORITY_VALID))
+        {
+          ++_stats.n_priority_evals;
+          state |= PRIORITY_VALID;
+          he_priority_[heh.idx()] = collapse_priority(ci);
+        }
+      }
+
+      if (!(state & LEGAL))
+        continue;
+
+      prio = he_priority_[heh.idx()];
+    }
+    else
+    {
+      CollapseInfo  ci(mesh_, heh);
+
+      ++_stats.n_legality_evals;
+      if (!is_collapse_legal(ci))
+      {
+        ++_stats.n_legality_rejected;
+        continue;
+      }
+
+      ++_stats.n_priority_evals;
+      prio = collapse_priority(ci);
+    }
+
+    if (prio >= 0.0 && prio < _best_prio)
+    {
+      _best_prio = prio;
+      collapse_target = heh;
+    }
+  }
+
+  return collapse_target;
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+template <class Mesh, class Heap>
+void
+DecimaterT<Mesh,Heap>::heap_vertex(typename Mesh::VertexHandle _vh)
+{
+  float                           best_prio;
+  typename Mesh::HalfedgeHandle   collapse_target;
+
+  collapse_target = find_collapse_target(_vh, best_prio, stats_);
+  update_heap(_vh, collapse_target, best_prio);
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+template <class Mesh, class Heap>
+void
+DecimaterT<Mesh,Heap>::update_heap(typename Mesh::VertexHandle _vh,
+                                   typename Mesh::HalfedgeHandle _target,
+                                   float _prio)
+{
+  collapse_target_[_vh.idx()] = _target;
+
+
+  // target found -> put vertex on heap
+  if (_target.is_valid())
+  {
+    if (heap_->is_stored(_vh))  heap_->update(_vh, _prio);
+    else                        heap_->insert(_vh, _prio);
+    ++stats_.n_heap_ops;
+  }
+
+  // not valid -> remove from heap
+  else
+  {
+    if (heap_->is_stored(_vh))
+    {
+      heap_->remove(_vh);
+      ++stats_.n_heap_ops;
+    }
+  }
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+template <class Mesh, class Heap>
+void
+DecimaterT<Mesh,Heap>::init_heap( unsigned int _n_collapses )
+{
+   typename Mesh::VertexIter  v_it, v_end(mesh_.vertices_end());
+
+   stats_.reset();
+
+   if (cache_priorities_)
+   {
+      he_state_.assign(mesh_.n_halfedges(), 0);
+      he_priority_.resize(mesh_.n_halfedges());
+   }
+
+   collapse_target_.assign(mesh_.n_vertices(), 
+                           typename Mesh::HalfedgeHandle());
+
+   heap_ = new DeciHeap(mesh_);
+   heap_->reserve(mesh_.n_vertices());
+
+   for (v_it = mesh_.vertices_begin(); v_it != v_end; ++v_it)
+      if (!v_it->deleted())
+         heap_vertex(v_it.handle());         
+
+
+   // reserve mem for prog mesh info
+   if (progmesh_info_)
+      progmesh_info_->reserve(_n_collapses);
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+template <class Mesh, class Heap>
+void
+DecimaterT<Mesh,Heap>::perform_collapse( CollapseInfo& _ci )
+{
+   typename Mesh::VertexFaceIter  vf_it;
+
+   // perform collapse
+   mesh_.collapse(_ci.v0v1);
+
+
+   // update triangle normals
+   vf_it = mesh_.vf_iter(_ci.v1);
+   for (; vf_it; ++vf_it)
+      if (!vf_it->deleted())
+         vf_it->set_normal(mesh_.calc_face_normal(vf_it.handle()));
+
+    
+   // update quality modules
+   update_modules(_ci);
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+template <class Mesh, class Heap>
+void
+DecimaterT<Mesh,Heap>::invalidate_cache( typename Mesh::VertexHandle _v1 )
+{
+   typename Mesh::VertexVertexIter     vv_it;
+   typename Mesh::VertexOHalfedgeIter  voh_it;
+   typename Mesh::HalfedgeHandle       heh;
+
+   if (!cache_priorities_)
+      return;
+
+   // quadric of v1 changed -> priority of its halfedges
+   for (voh_it = mesh_.voh_iter(_v1); voh_it; ++voh_it)
+   {
+      heh = voh_it.handle();
+      he_state_[heh.idx()] &= ~PRIORITY_VALID;
+      he_state_[mesh_.opposite_halfedge_handle(heh).idx()] &= ~PRIORITY_VALID;
+   }
+
+   // one rings (and boundary, lock status) changed within the closed 
+   // one ring of v1 -> legality of every halfedge touching it
+   for (voh_it = mesh_.voh_iter(_v1); voh_it; ++voh_it)
+      he_state_[voh_it.handle().idx()] &= ~LEGALITY_VALID;
+
+   for (vv_it = mesh_.vv_iter(_v1); vv_it; ++vv_it)
+   {
+      for (voh_it = mesh_.voh_iter(vv_it.handle()); voh_it; ++voh_it)
+      {
+         heh = voh_it.handle();
+         he_state_[heh.idx()] &= ~LEGALITY_VALID;
+         he_state_[mesh_.opposite_halfedge_handle(heh).idx()] &= ~LEGALITY_VALID;
+      }
+   }
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+template <class Mesh, class Heap>
+bool
+DecimaterT<Mesh,Heap>::keep_going( unsigned int _n_collapses,
+                                   unsigned int _n_requested )
+{
+   if (cancel_ && *cancel_)
+      interrupted_ = true;
+
+   else if (time_budget_ > 0.0 && 
+            get_wall_time() - start_time_ > time_budget_)
+      interrupted_ = true;
+
+   else if (observer_ && !observer_->notify(_n_collapses, _n_requested))
+      interrupted_ = true;
+
+   return !interrupted_;
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+template <class Mesh, class Heap>
+unsigned int
+DecimaterT<Mesh,Heap>::decimate( unsigned int _n_collapses )
+{
+   interrupted_ = false;
+   start_time_  = get_wall_time();
+
+   if (parallel_)
+      return decimate_parallel(_n_collapses);
+
+   typename Mesh::VertexHandle       vh;
+   typename Mesh::HalfedgeHandle     v0v1;
+   typename Mesh::VertexVertexIter   vv_it;
+   unsigned int                      n_collapses(0);
+   ProgMeshInfo                      pminfo;
+
+   typedef std::vector<typename Mesh::VertexHandle>  Support;
+   typedef typename Support::iterator                SupportIterator;
+   
+   Support            support(15);
+   SupportIterator    s_it, s_end;
+
+
+   // check _n_collapses
+   if (!_n_collapses) _n_collapses = mesh_.n_vertices();
+
+  
+   // initialize heap
+   init_heap(_n_collapses);
+
+
+
+   // process heap
+   while ((!heap_->empty()) && (n_collapses < _n_collapses))
+   {
+      // get 1st heap entry
+      vh   = heap_->front();
+      v0v1 = collapse_target_[vh.idx()];
+      heap_->pop_front();
+      ++stats_.n_heap_ops;
+
+
+      // setup collapse info
+      CollapseInfo ci(mesh_, v0v1);
+
+
+      // check topological correctness AGAIN !
+      if (!is_collapse_legal(ci))
+      {
+         ++stats_.n_legality_rejected;
+         continue;
+      }
+    
+
+      // store support (= one ring of v0)
+      vv_it = mesh_.vv_iter(ci.v0);
+      support.clear();
+      for (; vv_it; ++vv_it)
+         support.push_back(vv_it.handle());
+    
+
+      // store collapse/split information
+      if (progmesh_info_)
+      {
+         pminfo.v0 = ci.v0;
+         pminfo.v1 = ci.v1;
+         pminfo.vl = ci.vl;
+         pminfo.vr = ci.vr;
+         pminfo.v0v1 = typename Mesh::HalfedgeHandle();
+
+         progmesh_info_->push_back(pminfo);
+      }
+
+
+      // perform collapse, update normals and modules
+      perform_collapse(ci);
+      ++n_collapses;
+
+      // independent sets -> lock one ring of target vertex
+      if (independent_sets_)
+      {
+         mesh_.vertex(ci.v1).set_locked(true);
+         vv_it = mesh_.vv_iter(ci.v1);
+         for (; vv_it; ++vv_it)
+            vv_it->set_locked(true);
+      }
+
+
+      // forget cached legality/priority around v1
+      invalidate_cache(ci.v1);
+
+      // update heap (former one ring of decimated vertex)
+      for (s_it = support.begin(), s_end = support.end();
+           s_it != s_end; ++s_it)
+      {
+         assert(!mesh_.vertex(*s_it).deleted());
+         heap_vertex(*s_it);
+      }
+
+
+      // cancelled, out of time or stopped by observer?
+      if (n_collapses % observer_interval_ == 0 &&
+          !keep_going(n_collapses, _n_collapses))
+         break;
+   }
+
+
+   // delete heap and collapse targets
+   delete heap_;
+   heap_ = NULL;
+   std::vector<typename Mesh::HalfedgeHandle>().swap(collapse_target_);
+
+
+   // DON'T do garbage collection here! It's up to the application.
+
+
+   return n_collapses;
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+template <class Mesh, class Heap>
+void
+DecimaterT<Mesh,Heap>::mark_collapse_region( const CollapseInfo& _ci,
+                                        std::vector<unsigned int>& _marks,
+                                        unsigned int _stamp )
+{
+   typename Mesh::VertexHandle       vh[4] = { _ci.v0, _ci.v1, _ci.vl, _ci.vr };
+   typename Mesh::VertexVertexIter   vv_it;
+
+   for (int i = 0; i < 4; ++i)
+   {
+      if (!vh[i].is_valid())
+         continue;
+
+      _marks[vh[i].idx()] = _stamp;
+      for (vv_it = mesh_.vv_iter(vh[i]); vv_it; ++vv_it)
+         _marks[vv_it.handle().idx()] = _stamp;
+   }
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+template <class Mesh, class Heap>
+unsigned int
+DecimaterT<Mesh,Heap>::decimate_parallel( unsigned int _n_collapses )
+{
+   typedef std::vector<typename Mesh::VertexHandle>    Support;
+   typedef std::vector<typename Mesh::HalfedgeHandle>  Round;
+   typedef std::vector< std::pair<typename Mesh::VertexHandle, float> >
+                                                        Deferred;
+
+   typename Mesh::VertexHandle       vh;
+   typename Mesh::VertexVertexIter   vv_it;
+   unsigned int                      n_collapses(0), n_rounds(0);
+   ProgMeshInfo                      pminfo;
+
+   Support                    support, targets;
+   Round                      round;
+   Deferred                   deferred;
+   std::vector<unsigned int>  region(mesh_.n_vertices(), 0);
+   std::vector<unsigned int>  evaluated(mesh_.n_vertices(), 0);
+   Round                      best_target;
+   std::vector<float>         best_prio;
+
+
+   // check _n_collapses
+   if (!_n_collapses) _n_collapses = mesh_.n_vertices();
+
+  
+   // initialize heap
+   init_heap(_n_collapses);
+
+
+   // process heap, one independent set per round
+   while ((!heap_->empty()) && (n_collapses < _n_collapses))
+   {
+      ++n_rounds;
+      support.clear();
+      targets.clear();
+      round.clear();
+      deferred.clear();
+
+      unsigned int n_candidates = 
+         (unsigned int)(round_fraction_ * heap_->size()) + 1;
+
+
+      // 1. pick independent set (serial, cheapest first)
+      while (!heap_->empty() && n_candidates-- &&
+             n_collapses + round.size() < _n_collapses)
+      {
+         vh = heap_->front();
+         float prio = heap_->front_priority();
+         heap_->pop_front();
+         ++stats_.n_heap_ops;
+
+         CollapseInfo ci(mesh_, collapse_target_[vh.idx()]);
+
+         // touches the faces of a collapse of this round? -> next round
+         if (region[ci.v0.idx()] == n_rounds ||
+             region[ci.v1.idx()] == n_rounds ||
+             (ci.vl.is_valid() && region[ci.vl.idx()] == n_rounds) ||
+             (ci.vr.is_valid() && region[ci.vr.idx()] == n_rounds))
+         {
+            deferred.push_back(std::make_pair(vh, prio));
+            continue;
+         }
+
+         // check topological correctness AGAIN !
+         if (!is_collapse_legal(ci))
+         {
+            ++stats_.n_legality_rejected;
+            continue;
+         }
+
+         mark_collapse_region(ci, region, n_rounds);
+
+         // store support (= one ring of v0)
+         for (vv_it = mesh_.vv_iter(ci.v0); vv_it; ++vv_it)
+            support.push_back(vv_it.handle());
+
+         // store collapse/split information
+         if (progmesh_info_)
+         {
+            pminfo.v0 = ci.v0;
+            pminfo.v1 = ci.v1;
+            pminfo.vl = ci.vl;
+            pminfo.vr = ci.vr;
+            pminfo.v0v1 = typename Mesh::HalfedgeHandle();
+
+            progmesh_info_->push_back(pminfo);
+         }
+
+         round.push_back(ci.v0v1);
+         targets.push_back(ci.v1);
+      }
+
+
+      // 2. perform collapses, the regions are disjoint
+      int i, n = int(round.size());
+
+#pragma omp parallel for schedule(dynamic, 16)
+      for (i = 0; i < n; ++i)
+      {
+         CollapseInfo ci(mesh_, round[i]);
+         perform_collapse(ci);
+      }
+
+      n_collapses += n;
+
+
+      // 3. update heap
+      typename Support::iterator t_it, t_end(targets.end());
+      for (t_it = targets.begin(); t_it != t_end; ++t_it)
+         invalidate_cache(*t_it);
+
+      typename Deferred::iterator d_it, d_end(deferred.end());
+      for (d_it = deferred.begin(); d_it != d_end; ++d_it)
+         heap_->insert(d_it->first, d_it->second);
+      stats_.n_heap_ops += deferred.size();
+
+      // re-evaluate every support vertex once, in parallel
+      unsigned int m(0);
+      typename Support::iterator s_it, s_end(support.end());
+      for (s_it = support.begin(); s_it != s_end; ++s_it)
+      {
+         assert(!mesh_.vertex(*s_it).deleted());
+         if (evaluated[s_it->idx()] != n_rounds)
+         {
+            evaluated[s_it->idx()] = n_rounds;
+            support[m++] = *s_it;
+         }
+      }
+      support.resize(m);
+
+      n = int(support.size());
+      best_target.resize(n);
+      best_prio.resize(n);
+
+#pragma omp parallel
+      {
+         Statistics stats;
+
+#pragma omp for schedule(dynamic, 64)
+         for (i = 0; i < n; ++i)
+            best_target[i] = find_collapse_target(support[i], best_prio[i], 
+                                                  stats);
+
+#pragma omp critical
+         stats_ += stats;
+      }
+
+      for (i = 0; i < n; ++i)
+         update_heap(support[i], best_target[i], best_prio[i]);
+
+
+      // cancelled, out of time or stopped by observer?
+      if (!keep_going(n_collapses, _n_collapses))
+         break;
+   }
+
+
+   // delete heap and collapse targets
+   delete heap_;
+   heap_ = NULL;
+   std::vector<typename Mesh::HalfedgeHandle>().swap(collapse_target_);
+
+
+   return n_collapses;
+}
+
+
+//=============================================================================
+} // END_NS_DECIMATER
+} // END_NS_OPENMESH
+//=============================================================================
+
@@ -1,286 +1,426 @@
-//=============================================================================
-//                                                                            
-//                               OpenMesh                                     
-//        Copyright (C) 2002 by Computer Graphics Group, RWTH Aachen          
-//                           www.openmesh.org                                 
-//                                                                            
-//-----------------------------------------------------------------------------
-//                                                                            
-//                                License                                     
-//                                                                            
-//   This library is free software; you can redistribute it and/or modify it 
-//   under the terms of the GNU Library General Public License as published  
-//   by the Free Software Foundation, version 2.                             
-//                                                                             
-//   This library is distributed in the hope that it will be useful, but       
-//   WITHOUT ANY WARRANTY; without even the implied warranty of                
-//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         
-//   Library General Public License for more details.                          
-//                                                                            
-//   You should have received a copy of the GNU Library General Public         
-//   License along with this library; if not, write to the Free Software       
-//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 
-//                                                                            
-//-----------------------------------------------------------------------------
-//                                                                            
-//   $Revision: 1.3 $
-//   $Date: 2002/12/05 06:45:26 $
-//                                                                            
-//=============================================================================
-
-/** \file DecimaterT.hh
-    
- */
-
-//=============================================================================
-//
-//  CLASS DecimaterT
-//
-//=============================================================================
-
-#ifndef OPENMESH_DECIMATER_DECIMATERT_HH
-#define OPENMESH_DECIMATER_DECIMATERT_HH
-
-
-//== INCLUDES =================================================================
-
-#include "Config.hh"
-// --------------------
-#include <string>
-// --------------------
-#include <OpenMesh/Mesh/Traits.hh>
-#include <OpenMesh/Mesh/Types/TriMesh_ArrayKernelT.hh>
-#include <OpenMeshTools/Utils/HeapT.hh>
-// --------------------
-#include "ModBaseT.hh"
-
-
-//== NAMESPACE ================================================================
-
-namespace OpenMesh { // BEGIN_NS_OPENMESH
-namespace Decimater { // BEGIN_NS_DECIMATER
-
-
-//== CLASS DEFINITION =========================================================
-	      
-/** Decimater framework.
-    \see BaseMod
-*/
-
-template < typename Mesh >
-class DecimaterT
-{
-public:
-   
-   // Typedefs
-   typedef DecimaterT< Mesh >     Self;
-   
-   typedef CollapseInfoT<Mesh>    CollapseInfo;
-   typedef ModBaseT<Mesh>         Module;
-   typedef std::vector< Module* > ModuleList;
-
-   /// Constructor
-   DecimaterT(Mesh& _mesh) : 
-         mesh_(_mesh), progmesh_info_(NULL), independent_sets_(false), heap_(NULL),
-         cmodule_(NULL)
-   {}
-
-   
-   /// Destructor
-   ~DecimaterT()
-   {
-      delete_modules();
-      delete heap_;
-   }
-
-  
-   /// Initialize (also calls Mod's initialize)
-   void initialize();
-
-
-   /// Registration of a module
-   template< typename ModuleType > 
-   bool registrate(const ModuleType& _mod) 
-   {
-      if ( _mod.is_binary() )
-      {
-         bmodules_.push_back( new ModuleType(_mod) );
-      }
-      else      
-      {
-         delete cmodule_;
-         cmodule_ = new ModuleType(_mod);
-      }
-      return true;
-   }
-
-   bool registrate( const Module& _mod )
-   {
-	   Module* new_mod = new Module(_mod);
-
-	   if ( new_mod->is_binary() )
-	   {
-		   bmodules_.push_back(new_mod);
-	   }
-	   else      
-	   {
-		   delete cmodule_;
-		   cmodule_ = new_mod;
-	   }
-	   return true;
-   }
-   
-   /** Decimate (perform _n_collapses collapses). Return number of 
-       performed collapses. If _n_collapses is not given reduce as
-       much as possible */
-   unsigned int decimate( unsigned int _n_collapses = 0 );
-  
-
-   /** This piece of information defines a halfedge collapse and the
-       inverse vertex split */
-   struct ProgMeshInfo 
-   { 
-      typename Mesh::VertexHandle v0, v1, vl, vr; 
-   };
-
-   typedef std::vector<ProgMeshInfo> ProgMeshInfoContainer;
-
-
-   /** Turn on/off the generation of collapse/split information. For each
-       collapse an info structure ProgMeshInfo is appended to
-       the provided container. Call w/o argument to turn off generation. */
-   void generate_progmesh_info(ProgMeshInfoContainer* _info_container=0)
-   { progmesh_info_ = _info_container; }
-
-   void generate_progmesh_info(ProgMeshInfoContainer& _info_container)
-   { generate_progmesh_info( &_info_container ); }
-
-  
-   /// Turn on/off whether independent sets should be generated. 
-   void generate_independent_sets(bool _b) 
-   { independent_sets_ = _b; }
-
-private:
-
-   void update_modules(CollapseInfo& _ci)
-   {
-      typename ModuleList::iterator m_it, m_end = bmodules_.end();
-
-      for (m_it = bmodules_.begin(); m_it != m_end; ++m_it)
-         (*m_it)->postprocess_collapse(_ci);
-      cmodule_->postprocess_collapse(_ci);
-   }
-
-   void delete_modules(void)
-   {
-      typename ModuleList::iterator m_it, m_end = bmodules_.end();
-      for(m_it = bmodules_.begin(); m_it != m_end; ++m_it)
-      {
-         Module *mod = *m_it;
-         delete mod;
-      }
-      bmodules_.clear();
-      delete cmodule_;
-      cmodule_ = NULL;
-   }
-   
-private:
-
-   /// Insert vertex in heap
-   void heap_vertex(typename Mesh::VertexHandle _vh);
-
-   /// Is an edge collapse legal?  Performs topological test only
-   bool is_collapse_legal(const CollapseInfo& _ci);
-
-   /// Calculate priority of an halfedge collapse (using the modules)
-   float collapse_priority(const CollapseInfo& _ci);
-
-
-   // heap interface
-   struct HeapInterface
-   {
-      static inline bool
-      less( const typename Mesh::Vertex* _vp0,
-            const typename Mesh::Vertex* _vp1 )
-      { return (_vp0->priority < _vp1->priority); }
-    
-      static inline bool
-      greater( const typename Mesh::Vertex* _vp0,
-               const typename Mesh::Vertex* _vp1 )
-      { return (_vp0->priority > _vp1->priority); }
-    
-      static inline int
-      get_heap_position(const typename Mesh::Vertex* _vp)
-      { return _vp->heap_position; }
-    
-      static inline void
-      set_heap_position(typename Mesh::Vertex* _vp, int _pos)
-      { _vp->heap_position = _pos; }
-   };
-
-   
-   // actual heap type
-   typedef Utils::HeapT<typename Mesh::Vertex*, HeapInterface>  DeciHeap;
-
-   
-   // heap
-   DeciHeap*  heap_;
-
-   
-   // reference to mesh
-   Mesh&  mesh_;
-
-   
-   // list of modules
-   ModuleList bmodules_;
-   Module*    cmodule_;
-   
-   // progressive mesh information
-   std::vector<ProgMeshInfo>*  progmesh_info_;
-
-   
-   // produce independent sets?
-   bool  independent_sets_;
-
-private: // Noncopyable
-   DecimaterT(const Self&);
-   Self& operator = (const Self&);
-};
-
-
-//== CLASS DEFINITION =========================================================
-
-
-struct DefaultTraits : public OpenMesh::DefaultTraits
-{
-   VertexAttributes( OpenMesh::DefaultAttributer::Status );
-   EdgeAttributes( OpenMesh::DefaultAttributer::Status );
-   FaceAttributes( OpenMesh::DefaultAttributer::Status |
-                   OpenMesh::DefaultAttributer::Normal );
-   
-   VertexTraits
-   {      
-   public:
-      typedef typename Base::Refs::HalfedgeHandle HalfedgeHandle;
-      
-      VertexT() : priority(-1.0), heap_position(-1) {}
-      
-      HalfedgeHandle  collapse_target;
-      float           priority;
-      int             heap_position;
-      int             orig_idx;
-   };
-};
-
-//=============================================================================
-} // END_NS_DECIMATER
-} // END_NS_OPENMESH
-//=============================================================================
-#if defined(INCLUDE_TEMPLATES) && !defined(OPENMESH_DECIMATER_DECIMATERT_CC)
-#define OPENMESH_DECIMATER_TEMPLATES
-#include "DecimaterT.cc"
-#endif
-//=============================================================================
-#endif // OPENMESH_DECIMATER_DECIMATERT_HH defined
-//=============================================================================
-
+//=============================================================================
+//                                                                            
+//                               OpenMesh                                     
+//        Copyright (C) 2002 by Computer Graphics Group, RWTH Aachen          
+//                           www.openmesh.org                                 
+//                                                                            
+//-----------------------------------------------------------------------------
+//                                                                            
+//                                License                                     
+//                                                                            
+//   This library is free software; you can redistribute it and/or modify it 
+//   under the terms of the GNU Library General Public License as published  
+//   by the Free Software Foundation, version 2.                             
+//                                                                             
+//   This library is distributed in the hope that it will be useful, but       
+//   WITHOUT ANY WARRANTY; without even the implied warranty of                
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         
+//   Library General Public License for more details.                          
+//                                                                            
+//   You should have received a copy of the GNU Library General Public         
+//   License along with this library; if not, write to the Free Software       
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 
+//                                                                            
+//-----------------------------------------------------------------------------
+//                                                                            
+//   $Revision: 1.3 $
+//   $Date: 2002/12/05 06:45:26 $
+//                                                                            
+//=============================================================================
+
+/** \file DecimaterT.hh
+    
+ */
+
+//=============================================================================
+//
+//  CLASS DecimaterT
+//
+//=============================================================================
+
+#ifndef OPENMESH_DECIMATER_DECIMATERT_HH
+#define OPENMESH_DECIMATER_DECIMATERT_HH
+
+
+//== INCLUDES =================================================================
+
+#include "Config.hh"
+// --------------------
+#include <string>
+// --------------------
+#include <OpenMesh/Mesh/Traits.hh>
+#include <OpenMesh/Mesh/Types/TriMesh_ArrayKernelT.hh>
+#include <OpenMeshTools/Utils/HeapT.hh>
+// --------------------
+#include "ModBaseT.hh"
+#include "DecimaterHeapT.hh"
+
+
+//== NAMESPACE ================================================================
+
+namespace OpenMesh { // BEGIN_NS_OPENMESH
+namespace Decimater { // BEGIN_NS_DECIMATER
+
+
+//== CLASS DEFINITION =========================================================
+	      
+/** Decimater framework.
+    The Heap parameter selects the priority queue, see DecimaterHeapT.hh.
+    \see BaseMod
+*/
+
+template < typename Mesh, typename Heap = VertexHeapT<Mesh> >
+class DecimaterT
+{
+public:
+   
+   // Typedefs
+   typedef DecimaterT< Mesh, Heap >  Self;
+   
+   typedef CollapseInfoT<Mesh>    CollapseInfo;
+   typedef ModBaseT<Mesh>         Module;
+   typedef std::vector< Module* > ModuleList;
+
+   /// Constructor
+   DecimaterT(Mesh& _mesh) : 
+         mesh_(_mesh), progmesh_info_(NULL), independent_sets_(false), 
+         parallel_(false), round_fraction_(0.1f), cache_priorities_(false),
+         observer_(NULL), observer_interval_(1000), time_budget_(0.0),
+         cancel_(NULL), interrupted_(false), heap_(NULL), cmodule_(NULL)
+   {}
+
+   
+   /// Destructor
+   ~DecimaterT()
+   {
+      delete_modules();
+      delete heap_;
+   }
+
+  
+   /// Initialize (also calls Mod's initialize)
+   void initialize();
+
+
+   /// Registration of a module
+   template< typename ModuleType > 
+   bool registrate(const ModuleType& _mod) 
+   {
+      if ( _mod.is_binary() )
+      {
+         bmodules_.push_back( new ModuleType(_mod) );
+      }
+      else      
+      {
+         delete cmodule_;
+         cmodule_ = new ModuleType(_mod);
+      }
+      return true;
+   }
+
+   bool registrate( const Module& _mod )
+   {
+	   Module* new_mod = new Module(_mod);
+
+	   if ( new_mod->is_binary() )
+	   {
+		   bmodules_.push_back(new_mod);
+	   }
+	   else      
+	   {
+		   delete cmodule_;
+		   cmodule_ = new_mod;
+	   }
+	   return true;
+   }
+   
+   /// The registered priority (non-binary) module
+   Module* priority_module() { return cmodule_; }
+
+   /** Decimate (perform _n_collapses collapses). Return number of 
+       performed collapses. If _n_collapses is not given reduce as
+       much as possible */
+   unsigned int decimate( unsigned int _n_collapses = 0 );
+  
+
+   /** This piece of information defines a halfedge collapse and the
+       inverse vertex split. v0v1 is the halfedge to collapse; the
+       collapse deletes it, so it is invalid until a vertex split
+       recreates it and records it here. */
+   struct ProgMeshInfo 
+   { 
+      typename Mesh::VertexHandle   v0, v1, vl, vr; 
+      typename Mesh::HalfedgeHandle v0v1;
+   };
+
+   typedef std::vector<ProgMeshInfo> ProgMeshInfoContainer;
+
+
+   /** Turn on/off the generation of collapse/split information. For each
+       collapse an info structure ProgMeshInfo is appended to
+       the provided container. Call w/o argument to turn off generation. */
+   void generate_progmesh_info(ProgMeshInfoContainer* _info_container=0)
+   { progmesh_info_ = _info_container; }
+
+   void generate_progmesh_info(ProgMeshInfoContainer& _info_container)
+   { generate_progmesh_info( &_info_container ); }
+
+  
+   /// Turn on/off whether independent sets should be generated. 
+   void generate_independent_sets(bool _b) 
+   { independent_sets_ = _b; }
+
+
+   /** Turn on/off parallel decimation. decimate() then works in rounds:
+       each round takes the cheapest _round_fraction of the heap, picks
+       an independent set of legal collapses from it (greedily, in
+       priority order) and performs them concurrently (OpenMP). The
+       collapses of a round are appended to the progmesh info in
+       selection order; since they touch disjoint faces, this order
+       replays correctly. Binary modules must only touch the one-ring
+       of the collapse in postprocess_collapse(), and collapse_priority()
+       of all modules must be reentrant: the support vertices of a round
+       are re-evaluated concurrently. */
+   void parallel_independent_sets(bool _b, float _round_fraction = 0.1f)
+   { parallel_ = _b; round_fraction_ = _round_fraction; }
+
+
+   /** Turn on/off caching of collapse priority and legality per
+       halfedge. After a collapse into v1, legality is re-evaluated only
+       for halfedges touching the closed one-ring of v1, and priority
+       only for halfedges incident to v1. Only valid if every module's
+       priority depends on the endpoints of the halfedge alone (like
+       ModQuadricT). */
+   void cache_priorities(bool _b) 
+   { cache_priorities_ = _b; }
+
+
+   /// Evaluation counters of the last call to decimate()
+   struct Statistics
+   {
+      Statistics() { reset(); }
+
+      void reset()
+      {
+         n_priority_evals = n_priority_cached = 0;
+         n_legality_evals = n_legality_cached = 0;
+         n_legality_rejected = n_heap_ops = 0;
+      }
+
+      Statistics& operator+=(const Statistics& _s)
+      {
+         n_priority_evals    += _s.n_priority_evals;
+         n_priority_cached   += _s.n_priority_cached;
+         n_legality_evals    += _s.n_legality_evals;
+         n_legality_cached   += _s.n_legality_cached;
+         n_legality_rejected += _s.n_legality_rejected;
+         n_heap_ops          += _s.n_heap_ops;
+         return *this;
+      }
+
+      unsigned int  n_priority_evals,  n_priority_cached;
+      unsigned int  n_legality_evals,  n_legality_cached;
+
+      /// Legality tests that failed, including the re-test of popped
+      /// heap entries
+      unsigned int  n_legality_rejected;
+
+      /// Heap inserts, updates, removes and pops
+      unsigned int  n_heap_ops;
+   };
+
+   const Statistics& statistics() const { return stats_; }
+
+
+   /// Progress callback of decimate()
+   class Observer
+   {
+   public:
+      virtual ~Observer() {}
+
+      /** Called every few collapses with the number of collapses done
+          and the number requested. Return false to stop. */
+      virtual bool notify(unsigned int _n_collapses, 
+                          unsigned int _n_requested) = 0;
+   };
+
+   /** Notify _observer every _interval collapses (once per round in
+       parallel mode). Call w/o argument to turn off. */
+   void set_observer(Observer* _observer = 0, unsigned int _interval = 1000)
+   { observer_ = _observer; observer_interval_ = _interval ? _interval : 1; }
+
+   /// Stop decimate() after _seconds of wall clock time, 0 = no limit
+   void set_time_budget(double _seconds) 
+   { time_budget_ = _seconds; }
+
+   /// Stop decimate() as soon as *_flag becomes true, 0 = no flag
+   void set_cancel_flag(volatile bool* _flag = 0) 
+   { cancel_ = _flag; }
+
+   /** Did the last decimate() stop early (observer, budget or cancel
+       flag)? The progmesh info is complete for the collapses done. */
+   bool was_interrupted() const { return interrupted_; }
+
+private:
+
+   void update_modules(CollapseInfo& _ci)
+   {
+      typename ModuleList::iterator m_it, m_end = bmodules_.end();
+
+      for (m_it = bmodules_.begin(); m_it != m_end; ++m_it)
+         (*m_it)->postprocess_collapse(_ci);
+      cmodule_->postprocess_collapse(_ci);
+   }
+
+   void delete_modules(void)
+   {
+      typename ModuleList::iterator m_it, m_end = bmodules_.end();
+      for(m_it = bmodules_.begin(); m_it != m_end; ++m_it)
+      {
+         Module *mod = *m_it;
+         delete mod;
+      }
+      bmodules_.clear();
+      delete cmodule_;
+      cmodule_ = NULL;
+   }
+   
+private:
+
+   /// Create heap, insert all vertices, reserve progmesh info
+   void init_heap(unsigned int _n_collapses);
+
+   /// Insert vertex in heap
+   void heap_vertex(typename Mesh::VertexHandle _vh);
+
+   /** Cheapest legal collapse of _vh and its priority (invalid handle
+       if none). Writes no mesh state, only the cache entries of the
+       outgoing halfedges of _vh, so it may run concurrently for
+       distinct vertices. */
+   typename Mesh::HalfedgeHandle 
+   find_collapse_target(typename Mesh::VertexHandle _vh, 
+                        float& _best_prio, Statistics& _stats);
+
+   /// Store collapse target and insert/update/remove _vh in the heap
+   void update_heap(typename Mesh::VertexHandle _vh,
+                    typename Mesh::HalfedgeHandle _target, float _prio);
+
+   /// Collapse, update normals around v1 and the modules
+   void perform_collapse(CollapseInfo& _ci);
+
+   /// Drop cached legality/priority invalidated by a collapse into _v1
+   void invalidate_cache(typename Mesh::VertexHandle _v1);
+
+   /// Check cancel flag, time budget and observer, see set_observer()
+   bool keep_going(unsigned int _n_collapses, unsigned int _n_requested);
+
+   /// Round based decimation, see parallel_independent_sets()
+   unsigned int decimate_parallel(unsigned int _n_collapses);
+
+   /** Mark the faces touched by collapse _ci (the closed one-rings of
+       v0, v1, vl and vr) with _stamp. */
+   void mark_collapse_region(const CollapseInfo& _ci,
+                             std::vector<unsigned int>& _marks,
+                             unsigned int _stamp);
+
+   /** Is an edge collapse legal?  Performs topological test only.
+       Reentrant: reads the mesh, does not use the tag bits. */
+   bool is_collapse_legal(const CollapseInfo& _ci);
+
+   /** Sorted vertex indices of the one ring of _vh, in _stack if at
+       most _stack_size, otherwise in _heap. _result points to the
+       array used. Returns the valence. */
+   int one_ring_indices(typename Mesh::VertexHandle _vh,
+                        int* _stack, int _stack_size,
+                        std::vector<int>& _heap, int*& _result);
+
+   /// Calculate priority of an halfedge collapse (using the modules)
+   float collapse_priority(const CollapseInfo& _ci);
+
+
+   // actual heap type
+   typedef Heap  DeciHeap;
+
+   
+   // heap
+   DeciHeap*  heap_;
+
+   
+   // reference to mesh
+   Mesh&  mesh_;
+
+   
+   // list of modules
+   ModuleList bmodules_;
+   Module*    cmodule_;
+   
+   // progressive mesh information
+   std::vector<ProgMeshInfo>*  progmesh_info_;
+
+   
+   // produce independent sets?
+   bool  independent_sets_;
+
+   // collapse independent sets concurrently?
+   bool   parallel_;
+   float  round_fraction_;
+
+   // per halfedge priority/legality cache
+   enum { LEGALITY_VALID = 1, LEGAL = 2, PRIORITY_VALID = 4 };
+
+   bool                        cache_priorities_;
+   std::vector<unsigned char>  he_state_;
+   std::vector<float>          he_priority_;
+
+   // per vertex cheapest collapse, only while decimate() runs
+   std::vector<typename Mesh::HalfedgeHandle>  collapse_target_;
+
+   Statistics  stats_;
+
+   // interruption
+   Observer*       observer_;
+   unsigned int    observer_interval_;
+   double          time_budget_, start_time_;
+   volatile bool*  cancel_;
+   bool            interrupted_;
+
+private: // Noncopyable
+   DecimaterT(const Self&);
+   Self& operator = (const Self&);
+};
+
+
+//== CLASS DEFINITION =========================================================
+
+
+struct DefaultTraits : public OpenMesh::DefaultTraits
+{
+   VertexAttributes( OpenMesh::DefaultAttributer::Status );
+   EdgeAttributes( OpenMesh::DefaultAttributer::Status );
+   FaceAttributes( OpenMesh::DefaultAttributer::Status |
+                   OpenMesh::DefaultAttributer::Normal );
+   
+   // only needed by VertexHeapT, DecimaterT keeps the collapse
+   // targets itself
+   VertexTraits
+   {      
+   public:
+      VertexT() : priority(-1.0), heap_position(-1) {}
+      
+      float           priority;
+      int             heap_position;
+   };
+};
+
+//=============================================================================
+} // END_NS_DECIMATER
+} // END_NS_OPENMESH
+//=============================================================================
+#if defined(INCLUDE_TEMPLATES) && !defined(OPENMESH_DECIMATER_DECIMATERT_CC)
+#define OPENMESH_DECIMATER_TEMPLATES
+#include "DecimaterT.cc"
+#endif
+//=============================================================================
+#endif // OPENMESH_DECIMATER_DECIMATERT_HH defined
+//=============================================================================
+
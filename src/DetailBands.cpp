@@ -0,0 +1,102 @@
+#include <cassert>
+#include <algorithm>
+#include "DetailBands.h"
+#include "DetailReplay.h"
+#include "DetailVectorStore.h"
+
+#pragma warning(disable: 4018)  // signed/unsigned mismatch
+
+using namespace std;
+
+void DetailBands::clear()
+{
+	bandCount = vertexCount = 0;
+	vector<float>().swap(base);
+	vector<float>().swap(fields);
+}
+
+void DetailBands::build(DetailReplay& replay, const DetailVectorStore& details, int splitCount, 
+	int count)
+{
+	assert(replay.hasBaseline() && count >= 2);
+	clear();
+
+	const vector<PM::Point>& start = replay.getBaselineStart();
+	int n = start.size();
+
+	vector<PM::Point> frames;
+	replay.freezeFrames(frames);
+
+	// base: no detail vectors, from where the baseline started
+	vector<PM::Point> points(start);
+	vector<float> factors(details.getSplitCount(), 0.0f);
+	if (n > 0) replay.runFrozen(&points[0], details, frames, factors);
+
+	base.resize(3 * n);
+	for (int i = 0; i < n; i++)
+		for (int j = 0; j < 3; j++)
+			base[3*i + j] = points[i][j];
+
+	// band k alone, from nothing; the bands don't depend on each other
+	fields.resize(size_t(count) * 3 * n);
+
+	#pragma omp parallel for
+	for (int k = 0; k < count; k++)
+	{
+		vector<float> nodes(count, 0.0f), hat(details.getSplitCount());
+		nodes[k] = 1.0f;
+		for (int r = 0; r < hat.size(); r++)
+			hat[r] = interpolate(nodes, r, splitCount);
+
+		vector<PM::Point> field(n, PM::Point(0,0,0));
+		if (n > 0) replay.runFrozen(&field[0], details, frames, hat);
+
+		float* out = &fields[0] + size_t(k) * 3 * n;
+		for (int i = 0; i < n; i++)
+			for (int j = 0; j < 3; j++)
+				out[3*i + j] = field[i][j];
+	}
+
+	bandCount = count;
+	vertexCount = n;
+}
+
+float DetailBands::interpolate(const vector<float>& factors, int r, int splitCount)
+{
+	int count = factors.size();
+	float t = float(r) * (count - 1) / max(splitCount, 1);
+	int k = min(int(t), count - 1);
+	if (k + 1 >= count) return factors[k];
+
+	float w = t - k;
+	return factors[k] * (1.0f - w) + factors[k+1] * w;
+}
+
+void DetailBands::evaluate(const vector<float>& factors, PM::Point* points) const
+{
+	assert(factors.size() == bandCount);
+
+	int m = 3 * vertexCount;
+	vector<float> sum(base);
+	if (m == 0) return;
+
+	// a band at a time, so each pass is a straight run over memory
+	float* out = &sum[0];
+	for (int k = 0; k < bandCount; k++)
+	{
+		float c = factors[k];
+		if (c == 0.0f) continue;
+
+		const float* field = &fields[0] + size_t(k) * m;
+		for (int i = 0; i < m; i++)
+			out[i] += c * field[i];
+	}
+
+	for (int i = 0; i < vertexCount; i++)
+		points[i] = PM::Point(sum[3*i], sum[3*i+1], sum[3*i+2]);
+}
+
+size_t DetailBands::getMemoryUsage() const
+{
+	return (base.capacity() + fields.capacity()) * sizeof(float);
+}
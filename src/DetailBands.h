@@ -0,0 +1,86 @@
+/*
+@file DetailBands.h
+
+Precomputed displacement fields for filtering with a transfer function
+over the splits (FXGLPM::applyOperation()), so that a new function
+doesn't need a replay of the detail vectors at all.
+
+The splits are cut into bands by refinement index, with K nodes spread
+evenly from the coarsest split (0) to the finest (1). Band k weighs the
+splits with the hat function that is 1 at node k and 0 at the nodes
+next to it, so the bands add up to 1 for every split. With the frames
+of the splits frozen where a replay put them, a replay is linear in
+the factors the detail vectors are scaled by (see DetailReplay.h), so
+
+  positions = base + sum over k of f(node k) * field k
+
+where base is the replay with no detail vectors at all, and field k
+the replay of band k alone from all zero positions. That is exact for
+a piecewise linear f whose joints are on nodes; otherwise it is f as
+interpolated from the nodes. Either way it is one pass over the fields
+per band, instead of a replay of every split.
+
+Filters compound, as scaling the detail vectors does: the factors of
+each function multiply those of the ones before, node by node. Where
+joints are off nodes, several functions in a row then differ a little
+from the product of their interpolations, which is what the detail
+vectors get (see ProgressiveMesh::applyDetailBands()).
+
+The frames stay frozen at the baseline, though, while a replay (and so
+the sphere filter, or anything else that scales the detail vectors and
+replays them) turns each frame with the positions it finds. For the
+same function, the bands and a replay therefore give different models,
+alike only where the function is close to 1; the bands are what a
+frozen replay gives (DetailReplay::runFrozen()).
+
+The base and the fields take (K + 1) * 3 floats per vertex.
+*/
+#ifndef DETAILBANDS_H
+#define DETAILBANDS_H
+
+#include <vector>
+#include "TriMesh.h"
+
+class DetailReplay;
+class DetailVectorStore;
+
+class DetailBands
+{
+public:
+
+	DetailBands() : bandCount(0), vertexCount(0) {}
+
+	void clear();
+	bool empty() const { return bandCount == 0; }
+
+	int getBandCount() const { return bandCount; }
+
+	/// Where band k of bandCount peaks, from 0 (the coarsest split) to
+	/// 1 (the finest)
+	static float getNode(int k, int bandCount) { return bandCount > 1 ? float(k) / (bandCount - 1) : 0.0f; }
+
+	/// Factor of split r of splitCount, interpolated between the
+	/// factors of the nodes
+	static float interpolate(const std::vector<float>& factors, int r, int splitCount);
+
+	/// Build bandCount >= 2 bands over splitCount splits from the
+	/// baseline of replay, which has to have one
+	void build(DetailReplay& replay, const DetailVectorStore& details, int splitCount, 
+		int bandCount);
+
+	/// Positions of all vertices when band k is scaled by factors[k]
+	void evaluate(const std::vector<float>& factors, PM::Point* points) const;
+
+	/// Memory held, in bytes
+	size_t getMemoryUsage() const;
+
+private:
+
+	int bandCount, vertexCount;
+
+	// 3 floats per vertex; the fields one after the other
+	std::vector<float> base;
+	std::vector<float> fields;
+};
+
+#endif
@@ -0,0 +1,363 @@
+#include <cassert>
+#include <algorithm>
+#include <functional>
+#include <string.h>
+#include "DetailReplay.h"
+#include "DetailVectorStore.h"
+#include "Frame.h"
+
+#pragma warning(disable: 4018)  // signed/unsigned mismatch
+
+using namespace std;
+
+// Positions straight from an array
+struct DetailReplay::PointArray
+{
+	const PM::Point* points;
+	PointArray(const PM::Point* points) : points(points) {}
+	PM::Point operator()(int v) const { return points[v]; }
+};
+
+// Positions right before a split, in the baseline
+struct DetailReplay::BaselinePositions
+{
+	const DetailReplay* replay;
+	int s;
+	BaselinePositions(const DetailReplay* replay, int s) : replay(replay), s(s) {}
+	PM::Point operator()(int v) const { return replay->positionBefore(v, s); }
+};
+
+void DetailReplay::clear()
+{
+	firstLevel = lastLevel = vertexCount = 0;
+	vector<int>().swap(splits);
+	vector<int>().swap(frameCenter);
+	vector<int>().swap(frameTo);
+	vector<int>().swap(frameStart);
+	vector<int>().swap(splitStart);
+	vector<int>().swap(frameCorners);
+	vector<int>().swap(targets);
+	vector<int>().swap(weightStart);
+	vector<int>().swap(neighbors);
+	vector<PM::Scalar>().swap(weights);
+	vector<int>().swap(splitOf);
+	vector<int>().swap(readStart);
+	vector<int>().swap(readers);
+	vector<int>().swap(writeStart);
+	vector<int>().swap(writers);
+	vector<int>().swap(updateSplit);
+	vector<int>().swap(pending);
+	vector<char>().swap(queued);
+	dropBaseline();
+}
+
+void DetailReplay::begin(int first, int last, int count)
+{
+	clear();
+	firstLevel = first;
+	lastLevel = last;
+	vertexCount = count;
+}
+
+void DetailReplay::addSplit(int r, int v1, int to, const vector<int>& corners)
+{
+	splits.push_back(r);
+	frameCenter.push_back(v1);
+	frameTo.push_back(to);
+	frameStart.push_back(frameCorners.size());
+	frameCorners.insert(frameCorners.end(), corners.begin(), corners.end());
+	splitStart.push_back(targets.size());
+}
+
+void DetailReplay::addUpdate(int vertex)
+{
+	targets.push_back(vertex);
+	weightStart.push_back(neighbors.size());
+}
+
+void DetailReplay::addWeight(int neighbor, PM::Scalar weight)
+{
+	neighbors.push_back(neighbor);
+	weights.push_back(weight);
+}
+
+void DetailReplay::end()
+{
+	frameStart.push_back(frameCorners.size());
+	splitStart.push_back(targets.size());
+	weightStart.push_back(neighbors.size());
+
+	int maxSplit = -1;
+	for (int s = 0; s < splits.size(); s++)
+		maxSplit = max(maxSplit, splits[s]);
+
+	splitOf.assign(maxSplit + 1, -1);
+	for (int s = 0; s < splits.size(); s++)
+		splitOf[splits[s]] = s;
+}
+
+template <class Positions>
+void DetailReplay::makeFrame(int s, const Positions& positions, vector<PM::Point>& corners,
+	Frame<PM>& frame) const
+{
+	// local frame without the new vertex
+	int c0 = frameStart[s], c1 = frameStart[s+1];
+	corners.resize(c1 - c0);
+	for (int c = c0; c < c1; c++)
+		corners[c - c0] = positions(frameCorners[c]);
+
+	frame.init(positions(frameCenter[s]), positions(frameTo[s]), 
+		corners.empty() ? NULL : &corners[0], (c1 - c0) / 3);
+}
+
+template <class Positions>
+void DetailReplay::evaluate(int s, const Positions& positions, const DetailVectorStore& details,
+	Frame<PM>& frame, float factor, PM::Point* out) const
+{
+	DetailVectorStore::Span detail = details.get(splits[s]);
+	int u0 = splitStart[s], u1 = splitStart[s+1];
+	assert(u1 - u0 <= detail.size());
+
+	// all new positions before updating any, except the new vertex:
+	// it is relaxed right away, since its 1-ring depends on it
+	int newVertex = targets[u0];
+	PM::Point relaxed(0,0,0);
+
+	for (int u = u0; u < u1; u++)
+	{
+		PM::Point q_n(0,0,0);
+		for (int w = weightStart[u]; w < weightStart[u+1]; w++)
+		{
+			int v = neighbors[w];
+			q_n += weights[w] * ((u > u0 && v == newVertex) ? relaxed : positions(v));
+		}
+
+		if (u == u0) relaxed = q_n;
+
+		if (factor == 0.0f)
+			out[u - u0] = q_n;
+		else if (factor == 1.0f)
+			out[u - u0] = q_n + frame.unproject(detail[u - u0]);
+		else
+			out[u - u0] = q_n + frame.unproject(detail[u - u0] * factor);
+	}
+}
+
+void DetailReplay::run(PM::Point* points, const DetailVectorStore& details)
+{
+	baseline.assign(points, points + vertexCount);
+	written.resize(targets.size());
+
+	vector<PM::Point> corners;
+	Frame<PM> frame;
+
+	for (int s = 0; s < splits.size(); s++)
+	{
+		int u0 = splitStart[s], u1 = splitStart[s+1];
+		if (u0 == u1) continue;
+
+		makeFrame(s, PointArray(points), corners, frame);
+		evaluate(s, PointArray(points), details, frame, 1.0f, &written[u0]);
+
+		for (int u = u0; u < u1; u++)
+			points[targets[u]] = written[u];
+	}
+}
+
+void DetailReplay::freezeFrames(vector<PM::Point>& frames)
+{
+	assert(hasBaseline());
+	if (readStart.empty()) buildIndex();
+
+	frames.resize(3 * splits.size());
+
+	vector<PM::Point> corners;
+	Frame<PM> frame;
+
+	for (int s = 0; s < splits.size(); s++)
+	{
+		makeFrame(s, BaselinePositions(this, s), corners, frame);
+		frames[3*s] = frame.U;
+		frames[3*s+1] = frame.T;
+		frames[3*s+2] = frame.V;
+	}
+}
+
+void DetailReplay::runFrozen(PM::Point* points, const DetailVectorStore& details, 
+	const vector<PM::Point>& frames, const vector<float>& factors) const
+{
+	assert(frames.size() == 3 * splits.size());
+
+	vector<PM::Point> out;
+	Frame<PM> frame;
+
+	for (int s = 0; s < splits.size(); s++)
+	{
+		int u0 = splitStart[s], u1 = splitStart[s+1];
+		if (u0 == u1) continue;
+
+		frame.U = frames[3*s];
+		frame.T = frames[3*s+1];
+		frame.V = frames[3*s+2];
+
+		out.resize(u1 - u0);
+		evaluate(s, PointArray(points), details, frame, factors[splits[s]], &out[0]);
+
+		for (int u = u0; u < u1; u++)
+			points[targets[u]] = out[u - u0];
+	}
+}
+
+PM::Point DetailReplay::positionBefore(int v, int s) const
+{
+	// the last update before s that wrote v
+	for (int i = writeStart[v+1] - 1; i >= writeStart[v]; i--)
+		if (updateSplit[writers[i]] < s) return written[writers[i]];
+
+	return baseline[v];
+}
+
+void DetailReplay::splitReads(int s, vector<int>& reads) const
+{
+	reads.clear();
+	reads.push_back(frameCenter[s]);
+	reads.push_back(frameTo[s]);
+	reads.insert(reads.end(), frameCorners.begin() + frameStart[s], frameCorners.begin() + frameStart[s+1]);
+	for (int w = weightStart[splitStart[s]]; w < weightStart[splitStart[s+1]]; w++)
+		reads.push_back(neighbors[w]);
+
+	sort(reads.begin(), reads.end());
+	reads.erase(unique(reads.begin(), reads.end()), reads.end());
+}
+
+void DetailReplay::buildIndex()
+{
+	vector<int> reads, cursor;
+
+	// readers, counted first; splits come in order, so each list is
+	readStart.assign(vertexCount + 1, 0);
+	for (int s = 0; s < splits.size(); s++)
+	{
+		splitReads(s, reads);
+		for (int i = 0; i < reads.size(); i++)
+			readStart[reads[i] + 1]++;
+	}
+	for (int v = 0; v < vertexCount; v++)
+		readStart[v+1] += readStart[v];
+
+	readers.resize(readStart[vertexCount]);
+	cursor.assign(readStart.begin(), readStart.end() - 1);
+	for (int s = 0; s < splits.size(); s++)
+	{
+		splitReads(s, reads);
+		for (int i = 0; i < reads.size(); i++)
+			readers[cursor[reads[i]]++] = s;
+	}
+
+	// writers, the same way
+	updateSplit.resize(targets.size());
+	for (int s = 0; s < splits.size(); s++)
+		for (int u = splitStart[s]; u < splitStart[s+1]; u++)
+			updateSplit[u] = s;
+
+	writeStart.assign(vertexCount + 1, 0);
+	for (int u = 0; u < targets.size(); u++)
+		writeStart[targets[u] + 1]++;
+	for (int v = 0; v < vertexCount; v++)
+		writeStart[v+1] += writeStart[v];
+
+	writers.resize(targets.size());
+	cursor.assign(writeStart.begin(), writeStart.end() - 1);
+	for (int u = 0; u < targets.size(); u++)
+		writers[cursor[targets[u]]++] = u;
+
+	queued.assign(splits.size(), 0);
+}
+
+int DetailReplay::update(const DetailVectorStore& details, const vector<int>& changedSplits,
+	vector<int>& moved)
+{
+	assert(hasBaseline());
+	if (readStart.empty()) buildIndex();
+
+	// splits wait in a min-heap, so each is evaluated once, in order,
+	// after every earlier one it reads from
+	pending.clear();
+	for (int i = 0; i < changedSplits.size(); i++)
+	{
+		int r = changedSplits[i];
+		if (r < 0 || r >= splitOf.size() || splitOf[r] < 0 || queued[splitOf[r]]) continue;
+
+		queued[splitOf[r]] = 1;
+		pending.push_back(splitOf[r]);
+		push_heap(pending.begin(), pending.end(), greater<int>());
+	}
+
+	int evaluated = 0;
+	vector<PM::Point> corners, out;
+	Frame<PM> frame;
+
+	while (!pending.empty())
+	{
+		pop_heap(pending.begin(), pending.end(), greater<int>());
+		int s = pending.back();
+		pending.pop_back();
+		queued[s] = 0;
+
+		int u0 = splitStart[s], u1 = splitStart[s+1];
+		if (u0 == u1) continue;
+
+		out.resize(u1 - u0);
+		makeFrame(s, BaselinePositions(this, s), corners, frame);
+		evaluate(s, BaselinePositions(this, s), details, frame, 1.0f, &out[0]);
+		evaluated++;
+
+		for (int u = u0; u < u1; u++)
+		{
+			// the same write changes nothing further on
+			if (memcmp(&out[u - u0], &written[u], sizeof(PM::Point)) == 0) continue;
+			written[u] = out[u - u0];
+
+			// this write is what v reads as up to its next write, which
+			// reads it too; the last one is where v ends up
+			int v = targets[u];
+			vector<int>::const_iterator wb = writers.begin() + writeStart[v], we = writers.begin() + writeStart[v+1];
+			vector<int>::const_iterator w = lower_bound(wb, we, u);
+			int until = INT_MAX;
+			if (w + 1 != we)
+				until = updateSplit[*(w + 1)];
+			else
+				moved.push_back(v);
+
+			vector<int>::const_iterator rb = readers.begin() + readStart[v], re = readers.begin() + readStart[v+1];
+			for (vector<int>::const_iterator it = upper_bound(rb, re, s); it != re && *it <= until; ++it)
+			{
+				if (queued[*it]) continue;
+
+				queued[*it] = 1;
+				pending.push_back(*it);
+				push_heap(pending.begin(), pending.end(), greater<int>());
+			}
+		}
+	}
+
+	return evaluated;
+}
+
+void DetailReplay::dropBaseline()
+{
+	vector<PM::Point>().swap(baseline);
+	vector<PM::Point>().swap(written);
+}
+
+size_t DetailReplay::getMemoryUsage() const
+{
+	size_t ints = splits.capacity() + frameCenter.capacity() + frameTo.capacity() 
+		+ frameStart.capacity() + splitStart.capacity() + frameCorners.capacity()
+		+ targets.capacity() + weightStart.capacity() + neighbors.capacity()
+		+ splitOf.capacity() + readStart.capacity() + readers.capacity()
+		+ writeStart.capacity() + writers.capacity() + updateSplit.capacity()
+		+ pending.capacity();
+	return ints * sizeof(int) + weights.capacity() * sizeof(PM::Scalar)
+		+ (baseline.capacity() + written.capacity()) * sizeof(PM::Point) + queued.capacity();
+}
@@ -0,0 +1,170 @@
+/*
+@file DetailReplay.h
+
+ProgressiveMesh::restoreDetailVectors() compiled into a straight-line
+program. Restoring redoes the same topology work every time: for each
+split it refines, looks up the relaxation weights, and coarsens and
+refines again for the local frame. None of that depends on where the
+vertices are, only which vertices are read and with what weights, so
+it is recorded once:
+
+  frame    the vertex the split is from, the end of its halfedge, and
+           the corners of the faces around it before the split
+  updates  per updated vertex, its neighbors and their weights
+
+Running the program replays the arithmetic of restoring over an array
+of positions indexed by vertex; no mesh is touched. The result is the
+same as restoring, down to the last bit, as long as the detail vectors
+of each split keep their count.
+
+A run is kept as the baseline for update(): the positions it started
+from and every position it wrote. When the detail vectors of a few
+splits change, only their cone has to be evaluated again: the splits
+that read a position one of them wrote differently, and so on. Each
+split reads the positions as the last earlier split wrote them, which
+the baseline still has, so update() gives the same as running again
+from the same positions, at a cost that follows the changed region.
+
+With the frames of a run frozen, what a run computes is linear in the
+positions it starts from and the detail vectors: runFrozen() scales
+the detail vectors of each split by a factor of its own, which is what
+DetailBands.h builds on.
+*/
+#ifndef DETAILREPLAY_H
+#define DETAILREPLAY_H
+
+#include <limits.h>
+#include <vector>
+#include "TriMesh.h"
+
+class DetailVectorStore;
+template <class Mesh> class Frame;
+
+class DetailReplay
+{
+public:
+
+	DetailReplay() : firstLevel(0), lastLevel(0), vertexCount(0) {}
+
+	void clear();
+	bool empty() const { return splitStart.empty(); }
+
+	/// Levels the program restores from and to
+	int getFirstLevel() const { return firstLevel; }
+	int getLastLevel() const { return lastLevel; }
+
+	/// Start compiling a restore from level first to level last, of a
+	/// mesh with vertexCount vertices
+	void begin(int first, int last, int vertexCount);
+
+	/// Add the next split r: v1 is the vertex it splits from, to the end
+	/// of its halfedge and corners the faces around it before the split
+	void addSplit(int r, int v1, int to, const std::vector<int>& corners);
+
+	/// Add the next vertex the split updates, then its weights
+	void addUpdate(int vertex);
+	void addWeight(int neighbor, PM::Scalar weight);
+
+	/// Done compiling
+	void end();
+
+	/// Restore points, indexed by vertex, with the detail vectors; this
+	/// becomes the baseline
+	void run(PM::Point* points, const DetailVectorStore& details);
+
+	/// Same as a run from the positions of the baseline, after the
+	/// detail vectors of the splits changedSplits (indices in the detail
+	/// store) changed. The vertices that end up somewhere else are
+	/// appended to moved, see getPosition(). Returns the number of
+	/// splits evaluated.
+	int update(const DetailVectorStore& details, const std::vector<int>& changedSplits,
+		std::vector<int>& moved);
+
+	/// Where the baseline puts vertex v, once update() has run
+	PM::Point getPosition(int v) const { return positionBefore(v, INT_MAX); }
+
+	/// The positions the baseline started from, by vertex
+	const std::vector<PM::Point>& getBaselineStart() const { return baseline; }
+
+	/// The frame of every split in the baseline, U, T and V per split
+	void freezeFrames(std::vector<PM::Point>& frames);
+
+	/// Run with the frames frozen by freezeFrames(), and the detail
+	/// vectors of split r (index in the detail store) multiplied by
+	/// factors[r]. Doesn't touch the baseline.
+	void runFrozen(PM::Point* points, const DetailVectorStore& details, 
+		const std::vector<PM::Point>& frames, const std::vector<float>& factors) const;
+
+	/// The baseline is from the last run, until the positions change
+	/// some other way
+	bool hasBaseline() const { return !baseline.empty(); }
+	void dropBaseline();
+
+	int getSplitCount() const { return splits.size(); }
+
+	/// Memory held, in bytes
+	size_t getMemoryUsage() const;
+
+private:
+
+	/// Frame of split s, from the positions before it as positions(v)
+	/// gives them
+	template <class Positions>
+	void makeFrame(int s, const Positions& positions, std::vector<PM::Point>& corners,
+		Frame<PM>& frame) const;
+
+	/// New positions of the updates of split s in frame, its detail
+	/// vectors multiplied by factor
+	template <class Positions>
+	void evaluate(int s, const Positions& positions, const DetailVectorStore& details,
+		Frame<PM>& frame, float factor, PM::Point* out) const;
+
+	/// Position of vertex v right before split s, in the baseline
+	PM::Point positionBefore(int v, int s) const;
+
+	/// The vertices split s reads, each once
+	void splitReads(int s, std::vector<int>& reads) const;
+
+	/// Reader and writer lists for update()
+	void buildIndex();
+
+	struct PointArray;
+	struct BaselinePositions;
+
+	int firstLevel, lastLevel, vertexCount;
+
+	// per split: index in the detail store, its frame with the faces
+	// frameCorners[frameStart[s]..frameStart[s+1]), and its updates
+	// [splitStart[s], splitStart[s+1])
+	std::vector<int> splits;
+	std::vector<int> frameCenter, frameTo, frameStart;
+	std::vector<int> splitStart;
+
+	// corners of the frame faces, 3 per face
+	std::vector<int> frameCorners;
+
+	// per update: the vertex, and its weights [weightStart[u],
+	// weightStart[u+1])
+	std::vector<int> targets, weightStart;
+	std::vector<int> neighbors;
+	std::vector<PM::Scalar> weights;
+
+	// detail store index -> split, -1 for splits without detail vectors
+	std::vector<int> splitOf;
+
+	// baseline: the positions the last run started from, and what each
+	// update wrote
+	std::vector<PM::Point> baseline, written;
+
+	// per vertex: the splits that read it, and the updates that write
+	// it, both in order [readStart[v], readStart[v+1])
+	std::vector<int> readStart, readers;
+	std::vector<int> writeStart, writers;
+	std::vector<int> updateSplit;
+
+	// splits waiting in update(), as a heap
+	std::vector<int> pending;
+	std::vector<char> queued;
+};
+
+#endif
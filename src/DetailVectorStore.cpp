@@ -0,0 +1,237 @@
+#include <algorithm>
+#include <string.h>
+#include <math.h>
+#include "DetailVectorStore.h"
+
+#pragma warning(disable: 4018)  // signed/unsigned mismatch
+
+using namespace std;
+
+// IEEE half float, rounded to nearest even. Too large values become the
+// largest half instead of infinity.
+static unsigned short floatToHalf(float f)
+{
+	unsigned int x;
+	memcpy(&x, &f, sizeof(x));
+
+	unsigned short sign = (x >> 16) & 0x8000;
+	int e = int((x >> 23) & 0xff) - 127 + 15;
+	unsigned int m = x & 0x7fffff;
+
+	if ((x & 0x7fffffff) > 0x7f800000) return sign | 0x7e00;	// NaN
+	if (e >= 31) return sign | 0x7bff;
+
+	if (e <= 0)
+	{
+		// subnormal, or zero
+		if (e < -10) return sign;
+
+		m |= 0x800000;
+		int shift = 14 - e;
+		unsigned int half = m >> shift, rest = m & ((1 << shift) - 1), halfway = 1 << (shift - 1);
+		if (rest > halfway || (rest == halfway && (half & 1))) half++;
+		return sign | half;
+	}
+
+	unsigned int half = (e << 10) | (m >> 13), rest = m & 0x1fff;
+	if (rest > 0x1000 || (rest == 0x1000 && (half & 1))) half++;
+	if (half >= 0x7c00) half = 0x7bff;
+	return sign | half;
+}
+
+static float halfToFloat(unsigned short h)
+{
+	unsigned int sign = (h & 0x8000) << 16;
+	int e = (h >> 10) & 0x1f;
+	unsigned int m = h & 0x3ff;
+	unsigned int x;
+
+	if (e == 0)
+	{
+		if (m == 0)
+			x = sign;
+		else
+		{
+			// subnormal: normalize
+			e = 1;
+			while (!(m & 0x400))
+			{
+				m <<= 1;
+				e--;
+			}
+			x = sign | ((e + 112) << 23) | ((m & 0x3ff) << 13);
+		}
+	}
+	else if (e == 31)
+		x = sign | 0x7f800000 | (m << 13);
+	else
+		x = sign | ((e + 112) << 23) | (m << 13);
+
+	float f;
+	memcpy(&f, &x, sizeof(f));
+	return f;
+}
+
+void DetailVectorStore::clear()
+{
+	precision = FULL;
+	vector<PM::Point>().swap(vectors);
+	vector<unsigned short>().swap(packed);
+	vector<float>().swap(scales);
+	vector<int>().swap(offsets);
+}
+
+DetailVectorStore::Span DetailVectorStore::get(int r) const
+{
+	if (r < 0 || r >= getSplitCount()) return Span();
+
+	return Span(this, r, offsets[r], offsets[r+1] - offsets[r]);
+}
+
+PM::Point DetailVectorStore::decode(int r, int i) const
+{
+	switch (precision)
+	{
+	case HALF:
+		{
+			const unsigned short* h = &packed[3*i];
+			return PM::Point(halfToFloat(h[0]), halfToFloat(h[1]), halfToFloat(h[2]));
+		}
+	case INT16:
+		{
+			const short* q = reinterpret_cast<const short*>(&packed[3*i]);
+			float s = scales[r];
+			return PM::Point(s * q[0], s * q[1], s * q[2]);
+		}
+	default:
+		return vectors[i];
+	}
+}
+
+int DetailVectorStore::resize(int r, int count)
+{
+	if (offsets.empty()) offsets.push_back(0);
+
+	// splits after the last one so far have none
+	while (getSplitCount() <= r)
+		offsets.push_back(offsets.back());
+	if (precision == INT16)
+		scales.resize(getSplitCount(), 0.0f);
+
+	int first = offsets[r], oldCount = offsets[r+1] - first;
+	if (count != oldCount)
+	{
+		// at the end of the array when filling in order
+		if (precision == FULL)
+		{
+			vectors.erase(vectors.begin() + first, vectors.begin() + first + oldCount);
+			vectors.insert(vectors.begin() + first, count, PM::Point(0, 0, 0));
+		}
+		else
+		{
+			packed.erase(packed.begin() + 3*first, packed.begin() + 3*(first + oldCount));
+			packed.insert(packed.begin() + 3*first, 3*count, 0);
+		}
+
+		for (int s = r + 1; s < offsets.size(); s++)
+			offsets[s] += count - oldCount;
+	}
+
+	return first;
+}
+
+void DetailVectorStore::write(int r, const PM::Point* in, int count)
+{
+	int first = resize(r, count);
+
+	switch (precision)
+	{
+	case HALF:
+		for (int i = 0; i < 3*count; i++)
+			packed[3*first + i] = floatToHalf(in[i/3][i%3]);
+		break;
+
+	case INT16:
+		{
+			// the largest component of the split gets the full range
+			float maxAbs = 0.0f;
+			for (int i = 0; i < 3*count; i++)
+				maxAbs = max(maxAbs, float(fabs(in[i/3][i%3])));
+
+			float s = maxAbs / 32767.0f;
+			scales[r] = s;
+
+			short* q = reinterpret_cast<short*>(count ? &packed[3*first] : NULL);
+			for (int i = 0; i < 3*count; i++)
+			{
+				float v = (s > 0.0f) ? float(floor(in[i/3][i%3] / s + 0.5f)) : 0.0f;
+				q[i] = short(max(-32767.0f, min(32767.0f, v)));
+			}
+		}
+		break;
+
+	default:
+		for (int i = 0; i < count; i++)
+			vectors[first + i] = in[i];
+	}
+}
+
+void DetailVectorStore::scale(int r, float factor)
+{
+	if (r < 0 || r >= getSplitCount()) return;
+
+	switch (precision)
+	{
+	case HALF:
+		for (int i = 3*offsets[r]; i < 3*offsets[r+1]; i++)
+			packed[i] = floatToHalf(factor * halfToFloat(packed[i]));
+		break;
+
+	case INT16:
+		// keep the quantized vectors, sign and all
+		scales[r] *= factor;
+		break;
+
+	default:
+		for (int i = offsets[r]; i < offsets[r+1]; i++)
+			vectors[i] *= factor;
+	}
+}
+
+void DetailVectorStore::setPrecision(Precision p)
+{
+	if (p == precision) return;
+
+	int n = getSplitCount();
+	vector<PM::Point> all(size());
+	for (int r = 0; r < n; r++)
+		for (int i = offsets[r]; i < offsets[r+1]; i++)
+			all[i] = decode(r, i);
+
+	vector<PM::Point>().swap(vectors);
+	vector<unsigned short>().swap(packed);
+	vector<float>().swap(scales);
+
+	precision = p;
+	if (p == FULL)
+	{
+		vectors.swap(all);
+		return;
+	}
+
+	// same layout, written split by split
+	packed.resize(3 * all.size());
+	if (p == INT16) scales.resize(n, 0.0f);
+
+	for (int r = 0; r < n; r++)
+	{
+		int first = offsets[r];
+		write(r, all.empty() ? NULL : &all[0] + first, offsets[r+1] - first);
+	}
+}
+
+size_t DetailVectorStore::getMemoryUsage() const
+{
+	return vectors.capacity() * sizeof(PM::Point) + packed.capacity() * sizeof(unsigned short)
+		+ scales.capacity() * sizeof(float) + offsets.capacity() * sizeof(int);
+}
@@ -0,0 +1,100 @@
+/*
+@file DetailVectorStore.h
+
+The detail vectors of all splits in one array, in refinement order
+(split 0 = the coarsest), with an offsets table: split r has the
+vectors [offsets[r], offsets[r+1]). Splits without detail vectors
+take no space.
+
+Filling splits in order only ever appends, and writing a split with
+the number of vectors it already has overwrites them in place, so
+neither allocates once the array has grown.
+
+The vectors are kept at one of three precisions:
+
+  FULL    three floats, 12 bytes
+  HALF    three IEEE half floats, 6 bytes
+  INT16   three shorts scaled by a float per split, 6 bytes + 4 bytes
+          per split; the scale fits the largest component of the split
+
+Detail vectors are in the local frame of their split and mostly small,
+so the compact ones lose little; ProgressiveMesh::setDetailPrecision()
+measures how much.
+*/
+#ifndef DETAILVECTORSTORE_H
+#define DETAILVECTORSTORE_H
+
+#include <vector>
+#include "TriMesh.h"
+
+class DetailVectorStore
+{
+public:
+
+	enum Precision { FULL, HALF, INT16 };
+
+	/// The detail vectors of one split, read only; valid until the
+	/// store changes
+	class Span
+	{
+	public:
+		Span() : store(NULL), r(0), first(0), count(0) {}
+		Span(const DetailVectorStore* store, int r, int first, int count)
+			: store(store), r(r), first(first), count(count) {}
+
+		int size() const { return count; }
+		bool empty() const { return count == 0; }
+
+		PM::Point operator[](int i) const { return store->decode(r, first + i); }
+
+	private:
+		const DetailVectorStore* store;
+		int r, first, count;
+	};
+
+	DetailVectorStore() : precision(FULL) {}
+
+	/// Drop all detail vectors, back to full precision
+	void clear();
+
+	/// Splits up to the last one that has detail vectors
+	int getSplitCount() const { return offsets.empty() ? 0 : int(offsets.size()) - 1; }
+
+	/// Detail vectors of all splits
+	int size() const { return offsets.empty() ? 0 : offsets.back(); }
+
+	/// Detail vectors of split r, empty if it has none
+	Span get(int r) const;
+
+	/// Make split r have count detail vectors, set to vectors
+	void write(int r, const PM::Point* vectors, int count);
+
+	/// Multiply the detail vectors of split r by factor
+	void scale(int r, float factor);
+
+	Precision getPrecision() const { return precision; }
+
+	/// Convert all detail vectors to precision p
+	void setPrecision(Precision p);
+
+	/// Memory held, in bytes
+	size_t getMemoryUsage() const;
+
+private:
+
+	/// Vector i, which belongs to split r
+	PM::Point decode(int r, int i) const;
+
+	/// Make room for count vectors of split r; returns the first index
+	int resize(int r, int count);
+
+	Precision precision;
+
+	std::vector<PM::Point> vectors;		// FULL
+	std::vector<unsigned short> packed;	// HALF and INT16, 3 per vector
+	std::vector<float> scales;			// INT16, per split
+
+	std::vector<int> offsets;
+};
+
+#endif
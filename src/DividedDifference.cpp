@@ -1,10 +1,8 @@
-#include "DividedDifference.h"
-
-void clear_hashes()
-{
-	g_coeffHash.clear();
-	g_weightHash.clear();
-}
-
-IntHash g_coeffHash;
-IntHash g_weightHash;
\ No newline at end of file
+#include "DividedDifference.h"
+
+void clear_hashes()
+{
+	g_hashes.clear();
+}
+
+DividedDifferenceCache g_hashes;
\ No newline at end of file
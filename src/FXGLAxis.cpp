@@ -1,3 +1,3 @@
-#include "FXGLAxis.h"
-// Object implementation
-FXIMPLEMENT(FXGLAxis,FXGLShape,NULL,0)
+#include "FXGLAxis.h"
+// Object implementation
+FXIMPLEMENT(FXGLAxis,FXGLShape,NULL,0)
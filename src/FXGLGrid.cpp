@@ -1,3 +1,3 @@
-#include "FXGLGrid.h"
-// Object implementation
-FXIMPLEMENT(FXGLGrid,FXGLShape,NULL,0)
+#include "FXGLGrid.h"
+// Object implementation
+FXIMPLEMENT(FXGLGrid,FXGLShape,NULL,0)
@@ -1,80 +1,150 @@
-/*
-Frame defines a local frame, given a mesh and a vertex handle.
-It does this by averaging adjacent face normals. If this is degenerate,
-it uses the first face only.
-*/
-#ifndef FRAME_H
-#define FRAME_H
-
-#include "TriMesh.h"
-
-template <class Mesh>
-class Frame 
-{
-protected:
-public:
-	Mesh::Point U, T, V;	
-
-	void MakeIdentity()
-	{
-		U = Mesh::Point(1,0,0);
-		T = Mesh::Point(0,1,0);
-		V = Mesh::Point(0,0,1);	
-	}
-
-	Frame(Mesh& mesh, Mesh::VertexHandle vh) 
-	{
-		//MakeIdentity();
-		
-		Mesh::Point normal(0,0,0);
-		Mesh::VertexFaceIter vf_it=mesh.vf_iter(vh);
-		assert(vf_it);
-
-		for ( ; vf_it; ++vf_it)
-			normal += mesh.calc_face_normal(mesh.handle(*vf_it));
-
-		Mesh::Scalar epsilon = 0.01;
-
-		Mesh::Scalar n = normal.norm();
-		if (n > epsilon) {
-			U = normal / n;
-		} else {
-			// If norm is small, just use first face normal
-			vf_it=mesh.vf_iter(vh);
-			U = mesh.calc_face_normal(mesh.handle(*vf_it));	
-
-			n = U.norm();
-			if (n < epsilon) {
-				cout << "!" << endl;
-				MakeIdentity();
-			}
-		}
-		Mesh::HalfedgeHandle heh = mesh.halfedge_handle(vh);
-
-		Mesh::Point to = mesh.point(mesh.to_vertex_handle(heh));
-		T = (U % (to - mesh.point(vh)) ).normalize();
-		V = U % T;
-		
-		// cout << "U = " << U << ", T = " << T << ", V = " << V << endl;
-	}
-
-	Mesh::Point project(Mesh::Point point)
-	{
-		return Mesh::Point(U|point, T|point, V|point);                
-	}
-
-	Mesh::Point unproject(Mesh::Point point)
-	{
-		// Since M = [U T V] is orthonormal, inverse(M) == transpose(M)
-		Mesh::Point p;
-
-        for (int i=0; i < 3; i++)
-		{
-            p[i] = U[i]*point[0] + T[i]*point[1] + V[i]*point[2];
-		}
-
-		return p;
-	}
-};
-
-#endif
+/*
+Frame defines a local frame, given a mesh and a vertex handle.
+It does this by averaging adjacent face normals. If this is degenerate,
+it uses the first face only. The tangent points to the lowest ranked
+neighbor, by vertex index unless a rank is given.
+*/
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <vector>
+#include "TriMesh.h"
+
+template <class Mesh>
+class Frame 
+{
+protected:
+public:
+	Mesh::Point U, T, V;	
+
+	void MakeIdentity()
+	{
+		U = Mesh::Point(1,0,0);
+		T = Mesh::Point(0,1,0);
+		V = Mesh::Point(0,0,1);	
+	}
+
+	Frame() { MakeIdentity(); }
+
+	Frame(Mesh& mesh, Mesh::VertexHandle vh, const std::vector<int>* rank = NULL) 
+	{
+		std::vector<Mesh::VertexHandle> corners;
+		Mesh::VertexHandle to;
+		stencil(mesh, vh, corners, to, rank);
+
+		std::vector<Mesh::Point> points(corners.size());
+		for (int i = 0; i < corners.size(); i++)
+			points[i] = mesh.point(corners[i]);
+
+		init(mesh.point(vh), mesh.point(to), points.empty() ? NULL : &points[0], corners.size() / 3);
+	}
+
+	/// Same as Frame(mesh, vh), from the points that one reads: p is the
+	/// vertex, to the end of its halfedge, corners three per face
+	Frame(const Mesh::Point& p, const Mesh::Point& to, const Mesh::Point* corners, int faceCount)
+	{
+		init(p, to, corners, faceCount);
+	}
+
+	/// The vertices Frame(mesh, vh) reads besides vh: the corners of the
+	/// faces around vh, three per face starting with vh, and the lowest
+	/// ranked neighbor (rank[v], or v's index without rank), which the
+	/// tangent points to. Neither depends on how the halfedges around vh
+	/// happen to be ordered, so a level gives the same frames however the
+	/// mesh got there; with a rank that survives renumbering, so does a
+	/// renumbered copy.
+	static void stencil(Mesh& mesh, Mesh::VertexHandle vh, 
+		std::vector<Mesh::VertexHandle>& corners, Mesh::VertexHandle& to,
+		const std::vector<int>* rank = NULL)
+	{
+		corners.clear();
+
+		Mesh::HalfedgeHandle start;
+		int lowest = 0;
+		for (Mesh::VertexOHalfedgeIter voh_it = mesh.voh_iter(vh); voh_it; ++voh_it)
+		{
+			int v = mesh.to_vertex_handle(voh_it.handle()).idx();
+			if (rank) v = (*rank)[v];
+			if (!start.is_valid() || v < lowest)
+			{
+				start = voh_it.handle();
+				lowest = v;
+			}
+		}
+		assert(start.is_valid());
+		to = mesh.to_vertex_handle(start);
+
+		// faces in order around vh, from start on
+		Mesh::HalfedgeHandle heh = start;
+		do
+		{
+			if (!mesh.is_boundary(heh))
+			{
+				corners.push_back(vh);
+				corners.push_back(mesh.to_vertex_handle(heh));
+				corners.push_back(mesh.to_vertex_handle(mesh.next_halfedge_handle(heh)));
+			}
+			heh = mesh.cw_rotated_halfedge_handle(heh);
+		} while (heh != start);
+	}
+
+	/// Unit normal of a triangle, as Mesh::calc_face_normal()
+	static Mesh::Point faceNormal(const Mesh::Point& p0, const Mesh::Point& p1, const Mesh::Point& p2)
+	{
+		Mesh::Point n = (p2 - p1) % (p0 - p1);
+		Mesh::Scalar norm = n.norm();
+		return (norm != Mesh::Scalar(0)) ? n / norm : Mesh::Point(0,0,0);
+	}
+
+	void init(const Mesh::Point& p, const Mesh::Point& to, const Mesh::Point* corners, int faceCount)
+	{
+		//MakeIdentity();
+		
+		Mesh::Point normal(0,0,0);
+		assert(faceCount > 0);
+
+		for (int f = 0; f < faceCount; f++)
+			normal += faceNormal(corners[3*f], corners[3*f+1], corners[3*f+2]);
+
+		Mesh::Scalar epsilon = 0.01;
+
+		Mesh::Scalar n = normal.norm();
+		if (n > epsilon) {
+			U = normal / n;
+		} else {
+			// If norm is small, just use first face normal
+			U = faceNormal(corners[0], corners[1], corners[2]);	
+
+			n = U.norm();
+			if (n < epsilon) {
+				cout << "!" << endl;
+				MakeIdentity();
+			}
+		}
+
+		T = (U % (to - p) ).normalize();
+		V = U % T;
+		
+		// cout << "U = " << U << ", T = " << T << ", V = " << V << endl;
+	}
+
+	Mesh::Point project(Mesh::Point point)
+	{
+		return Mesh::Point(U|point, T|point, V|point);                
+	}
+
+	Mesh::Point unproject(Mesh::Point point)
+	{
+		// Since M = [U T V] is orthonormal, inverse(M) == transpose(M)
+		Mesh::Point p;
+
+        for (int i=0; i < 3; i++)
+		{
+            p[i] = U[i]*point[0] + T[i]*point[1] + V[i]*point[2];
+		}
+
+		return p;
+	}
+};
+
+#endif
@@ -0,0 +1,419 @@
+//=============================================================================
+//
+//                               OpenMesh
+//        Copyright (C) 2002 by Computer Graphics Group, RWTH Aachen
+//                           www.openmesh.org
+//
+//-----------------------------------------------------------------------------
+//
+//                                License
+//
+//   This library is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU Library General Public License as published
+//   by the Free Software Foundation, version 2.
+//
+//   This library is distributed in the hope that it will be useful, but
+//   WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Library General Public License for more details.
+//
+//   You should have received a copy of the GNU Library General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+//=============================================================================
+
+/** \file ModQuadricSoAT.cc
+    Bodies of template member function.
+ */
+
+//=============================================================================
+//
+//  CLASS ModQuadricSoAT - IMPLEMENTATION
+//
+//=============================================================================
+
+#define OPENMESH_DECIMATER_MODQUADRICSOA_CC
+
+//== INCLUDES =================================================================
+
+
+#include <assert.h>
+#include <vector>
+#include "ModQuadricSoAT.hh"
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OPENMESH_DECIMATER_SSE2
+#include <emmintrin.h>
+#endif
+
+
+//== NAMESPACE ===============================================================
+
+namespace OpenMesh { // BEGIN_NS_OPENMESH
+namespace Decimater { // BEGIN_NS_DECIMATER
+
+
+//== KERNELS =================================================================
+
+
+/** Quadric errors of n collapses into the same vertex v0.
+
+    _q0 holds the 10 coefficients (a..j) of v0. _in holds 13 rows of
+    length _stride: the coefficients of the n target vertices, then their
+    x, y and z. The error of target k is (Q0 + Q1)(p1), i.e.
+
+      a x^2 + 2b xy + 2c xz + 2d x + e y^2 + 2f yz + 2g y + h z^2 + 2i z + j
+ */
+template <class Scalar>
+inline void
+quadric_errors(const Scalar* _q0, const Scalar* _in, int _stride,
+               int _begin, int _end, Scalar* _err)
+{
+   const Scalar *in = _in;
+   const int     s  = _stride;
+
+   for (int k = _begin; k < _end; ++k)
+   {
+      Scalar a = _q0[0] + in[0*s+k],  b = _q0[1] + in[1*s+k],
+             c = _q0[2] + in[2*s+k],  d = _q0[3] + in[3*s+k],
+             e = _q0[4] + in[4*s+k],  f = _q0[5] + in[5*s+k],
+             g = _q0[6] + in[6*s+k],  h = _q0[7] + in[7*s+k],
+             i = _q0[8] + in[8*s+k],  j = _q0[9] + in[9*s+k];
+
+      Scalar x = in[10*s+k], y = in[11*s+k], z = in[12*s+k];
+
+      _err[k] = x * (a*x + Scalar(2) * (b*y + c*z + d)) +
+                y * (e*y + Scalar(2) * (f*z + g)) +
+                z * (h*z + Scalar(2) * i) + j;
+   }
+}
+
+
+/// Scalar loop, specialized below for SSE2
+template <class Scalar>
+struct QuadricKernelT
+{
+   static void eval(const Scalar* _q0, const Scalar* _in, int _stride,
+                    int _n, Scalar* _err)
+   {
+      quadric_errors(_q0, _in, _stride, 0, _n, _err);
+   }
+};
+
+
+#if defined(OPENMESH_DECIMATER_SSE2)
+
+/// Four collapses per step
+template <>
+struct QuadricKernelT<float>
+{
+   static void eval(const float* _q0, const float* _in, int _stride,
+                    int _n, float* _err)
+   {
+      const float *in  = _in;
+      const int    s   = _stride;
+      const __m128 two = _mm_set1_ps(2.0f);
+
+      int k, n4 = _n & ~3;
+
+      for (k = 0; k < n4; k += 4)
+      {
+#define COEFF(r) _mm_add_ps(_mm_set1_ps(_q0[r]), _mm_loadu_ps(in + r*s + k))
+         __m128 a = COEFF(0), b = COEFF(1), c = COEFF(2), d = COEFF(3),
+                e = COEFF(4), f = COEFF(5), g = COEFF(6), h = COEFF(7),
+                i = COEFF(8), j = COEFF(9);
+#undef COEFF
+
+         __m128 x = _mm_loadu_ps(in + 10*s + k),
+                y = _mm_loadu_ps(in + 11*s + k),
+                z = _mm_loadu_ps(in + 12*s + k);
+
+         __m128 t0 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(b, y), _mm_mul_ps(c, z)), d);
+         __m128 r0 = _mm_mul_ps(x, _mm_add_ps(_mm_mul_ps(a, x), _mm_mul_ps(two, t0)));
+
+         __m128 t1 = _mm_add_ps(_mm_mul_ps(f, z), g);
+         __m128 r1 = _mm_mul_ps(y, _mm_add_ps(_mm_mul_ps(e, y), _mm_mul_ps(two, t1)));
+
+         __m128 r2 = _mm_mul_ps(z, _mm_add_ps(_mm_mul_ps(h, z), _mm_mul_ps(two, i)));
+
+         _mm_storeu_ps(_err + k, _mm_add_ps(_mm_add_ps(_mm_add_ps(r0, r1), r2), j));
+      }
+
+      quadric_errors(_q0, _in, _stride, n4, _n, _err);
+   }
+};
+
+
+/// Two collapses per step
+template <>
+struct QuadricKernelT<double>
+{
+   static void eval(const double* _q0, const double* _in, int _stride,
+                    int _n, double* _err)
+   {
+      const double *in  = _in;
+      const int     s   = _stride;
+      const __m128d two = _mm_set1_pd(2.0);
+
+      int k, n2 = _n & ~1;
+
+      for (k = 0; k < n2; k += 2)
+      {
+#define COEFF(r) _mm_add_pd(_mm_set1_pd(_q0[r]), _mm_loadu_pd(in + r*s + k))
+         __m128d a = COEFF(0), b = COEFF(1), c = COEFF(2), d = COEFF(3),
+                 e = COEFF(4), f = COEFF(5), g = COEFF(6), h = COEFF(7),
+                 i = COEFF(8), j = COEFF(9);
+#undef COEFF
+
+         __m128d x = _mm_loadu_pd(in + 10*s + k),
+                 y = _mm_loadu_pd(in + 11*s + k),
+                 z = _mm_loadu_pd(in + 12*s + k);
+
+         __m128d t0 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(b, y), _mm_mul_pd(c, z)), d);
+         __m128d r0 = _mm_mul_pd(x, _mm_add_pd(_mm_mul_pd(a, x), _mm_mul_pd(two, t0)));
+
+         __m128d t1 = _mm_add_pd(_mm_mul_pd(f, z), g);
+         __m128d r1 = _mm_mul_pd(y, _mm_add_pd(_mm_mul_pd(e, y), _mm_mul_pd(two, t1)));
+
+         __m128d r2 = _mm_mul_pd(z, _mm_add_pd(_mm_mul_pd(h, z), _mm_mul_pd(two, i)));
+
+         _mm_storeu_pd(_err + k, _mm_add_pd(_mm_add_pd(_mm_add_pd(r0, r1), r2), j));
+      }
+
+      quadric_errors(_q0, _in, _stride, n2, _n, _err);
+   }
+};
+
+
+#endif // OPENMESH_DECIMATER_SSE2
+
+
+//== IMPLEMENTATION ==========================================================
+
+
+template<class Mesh, class Scalar>
+void
+ModQuadricSoAT<Mesh, Scalar>::
+initialize()
+{
+  Base::initialize();
+
+  int i, n_vertices = int(this->mesh_.n_vertices());
+
+  for (i = 0; i < N_COEFFS; ++i)
+    coeffs_[i].resize(n_vertices);
+  version_.assign(n_vertices, 0);
+
+#pragma omp parallel for schedule(static)
+  for (i = 0; i < n_vertices; ++i)
+    pack(typename Mesh::VertexHandle(i));
+
+  // one batch per thread
+#if defined(_OPENMP)
+  batches_.assign(omp_get_max_threads(), Batch());
+#else
+  batches_.assign(1, Batch());
+#endif
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+template<class Mesh, class Scalar>
+float
+ModQuadricSoAT<Mesh, Scalar>::
+collapse_priority(const CollapseInfo& _ci)
+{
+  Batch&  b = thread_batch();
+  int     k = find_in_batch(_ci, b);
+
+  if (k < 0)
+  {
+    evaluate_batch(_ci.v0, b);
+    k = find_in_batch(_ci, b);
+  }
+
+  // not an outgoing halfedge of v0 (?), evaluate the usual way
+  if (k < 0)
+    return Base::collapse_priority(_ci);
+
+  double err = b.err[k];
+  return float( (err < this->max_err_) ? err : -1.0 );
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+template<class Mesh, class Scalar>
+void
+ModQuadricSoAT<Mesh, Scalar>::
+postprocess_collapse(const CollapseInfo& _ci)
+{
+  Base::postprocess_collapse(_ci);
+
+  // v1 is written by this collapse only, also in parallel rounds
+  pack(_ci.v1);
+  ++version_[_ci.v1.idx()];
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+template<class Mesh, class Scalar>
+void
+ModQuadricSoAT<Mesh, Scalar>::
+outgoing_errors(typename Mesh::VertexHandle _v0,
+                std::vector<typename Mesh::HalfedgeHandle>& _heh,
+                std::vector<Scalar>& _err)
+{
+  Batch b;
+  evaluate_batch(_v0, b);
+
+  _heh.clear();
+  for (unsigned int k = 0; k < b.heh.size(); ++k)
+    _heh.push_back(typename Mesh::HalfedgeHandle(b.heh[k]));
+  _err = b.err;
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+template<class Mesh, class Scalar>
+void
+ModQuadricSoAT<Mesh, Scalar>::
+pack(typename Mesh::VertexHandle _vh)
+{
+  const Geometry::Quadricd&  q(this->quadric(_vh));
+  int                        i(_vh.idx());
+
+  coeffs_[0][i] = Scalar(q.a());  coeffs_[1][i] = Scalar(q.b());
+  coeffs_[2][i] = Scalar(q.c());  coeffs_[3][i] = Scalar(q.d());
+  coeffs_[4][i] = Scalar(q.e());  coeffs_[5][i] = Scalar(q.f());
+  coeffs_[6][i] = Scalar(q.g());  coeffs_[7][i] = Scalar(q.h());
+  coeffs_[8][i] = Scalar(q.i());  coeffs_[9][i] = Scalar(q.j());
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+template<class Mesh, class Scalar>
+void
+ModQuadricSoAT<Mesh, Scalar>::
+evaluate_batch(typename Mesh::VertexHandle _v0, Batch& _b)
+{
+  typename Mesh::VertexOHalfedgeIter  voh_it;
+  typename Mesh::VertexHandle         v1;
+  int                                 k, r, n;
+
+  _b.heh.clear();
+  _b.v1.clear();
+  _b.v1_version.clear();
+
+  for (voh_it = this->mesh_.voh_iter(_v0); voh_it; ++voh_it)
+  {
+    v1 = this->mesh_.to_vertex_handle(voh_it.handle());
+
+    _b.heh.push_back(voh_it.handle().idx());
+    _b.v1.push_back(v1.idx());
+    _b.v1_version.push_back(version_[v1.idx()]);
+  }
+
+  _b.v0         = _v0.idx();
+  _b.v0_version = version_[_v0.idx()];
+  _b.next       = 0;
+
+
+  // gather targets into rows: 10 coefficients, x, y, z
+  n = int(_b.v1.size());
+  _b.scratch.resize(13 * n + 1);
+  _b.err.resize(n + 1);
+
+  Scalar* in = &_b.scratch[0];
+
+  for (k = 0; k < n; ++k)
+  {
+    int i = _b.v1[k];
+    const typename Mesh::Point& p = this->mesh_.point(typename Mesh::VertexHandle(i));
+
+    for (r = 0; r < N_COEFFS; ++r)
+      in[r*n + k] = coeffs_[r][i];
+
+    in[10*n + k] = Scalar(p[0]);
+    in[11*n + k] = Scalar(p[1]);
+    in[12*n + k] = Scalar(p[2]);
+  }
+
+  Scalar q0[N_COEFFS];
+  for (r = 0; r < N_COEFFS; ++r)
+    q0[r] = coeffs_[r][_v0.idx()];
+
+  QuadricKernelT<Scalar>::eval(q0, in, n, n, &_b.err[0]);
+  _b.err.resize(n);
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+template<class Mesh, class Scalar>
+int
+ModQuadricSoAT<Mesh, Scalar>::
+find_in_batch(const CollapseInfo& _ci, Batch& _b)
+{
+  if (_b.v0 != _ci.v0.idx() || _b.v0_version != version_[_ci.v0.idx()])
+    return -1;
+
+  // queries usually come in iterator order, start at the expected one
+  int n = int(_b.heh.size());
+
+  for (int j = 0; j < n; ++j)
+  {
+    int k = (_b.next + j) % n;
+
+    if (_b.heh[k] == _ci.v0v1.idx())
+    {
+      if (_b.v1[k] != _ci.v1.idx() ||
+          _b.v1_version[k] != version_[_ci.v1.idx()])
+        return -1;
+
+      _b.next = k + 1;
+      return k;
+    }
+  }
+
+  return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+template<class Mesh, class Scalar>
+typename ModQuadricSoAT<Mesh, Scalar>::Batch&
+ModQuadricSoAT<Mesh, Scalar>::
+thread_batch()
+{
+#if defined(_OPENMP)
+  assert(omp_get_thread_num() < int(batches_.size()));
+  return batches_[omp_get_thread_num()];
+#else
+  return batches_[0];
+#endif
+}
+
+
+//=============================================================================
+} // END_NS_DECIMATER
+} // END_NS_OPENMESH
+//=============================================================================
@@ -0,0 +1,154 @@
+//=============================================================================
+//
+//                               OpenMesh
+//        Copyright (C) 2002 by Computer Graphics Group, RWTH Aachen
+//                           www.openmesh.org
+//
+//-----------------------------------------------------------------------------
+//
+//                                License
+//
+//   This library is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU Library General Public License as published
+//   by the Free Software Foundation, version 2.
+//
+//   This library is distributed in the hope that it will be useful, but
+//   WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Library General Public License for more details.
+//
+//   You should have received a copy of the GNU Library General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+//=============================================================================
+
+/** \file ModQuadricSoAT.hh
+
+ */
+
+//=============================================================================
+//
+//  CLASS ModQuadricSoAT
+//
+//=============================================================================
+
+#ifndef OPENMESH_DECIMATER_MODQUADRICSOA_HH
+#define OPENMESH_DECIMATER_MODQUADRICSOA_HH
+
+
+//== INCLUDES =================================================================
+
+#include <vector>
+#include "ModQuadricT.hh"
+
+
+//== NAMESPACE ================================================================
+
+namespace OpenMesh { // BEGIN_NS_OPENMESH
+namespace Decimater { // BEGIN_NS_DECIMATER
+
+
+//== CLASS DEFINITION =========================================================
+
+
+/** Quadric module evaluating all outgoing collapses of a vertex at once.
+
+    The vertex quadrics are mirrored into ten coefficient arrays of type
+    Scalar (float or double). When the decimater asks for the priority
+    of a halfedge v0->v1, the errors of all outgoing halfedges of v0 are
+    computed with one SIMD kernel (SSE2 if available, scalar loop
+    otherwise) and kept in a per-thread batch, which answers the
+    following queries for v0. Per-vertex version counters detect batches
+    made stale by a collapse.
+
+    Same priorities as ModQuadricT up to rounding (exactly the same
+    rounding for Scalar = double would require the operation order of
+    QuadricT::operator()).
+ */
+template <class Mesh, class Scalar = double>
+class ModQuadricSoAT : public ModQuadricT<Mesh>
+{
+public:
+
+   typedef ModQuadricT<Mesh>     Base;
+   typedef CollapseInfoT<Mesh>   CollapseInfo;
+
+   /// Constructor
+   ModQuadricSoAT( Mesh& _mesh, double _max_err = DBL_MAX ) :
+         Base(_mesh, _max_err)
+   {}
+
+   /// Destructor
+   virtual ~ModQuadricSoAT() {}
+
+
+   /// Compute the vertex quadrics and pack them
+   virtual void initialize(void);
+
+
+   /// Quadric error of the collapsed vertex, -1 if it exceeds max_err
+   virtual float collapse_priority(const CollapseInfo& _ci);
+
+
+   /// v1 inherits the quadric of v0, repack v1
+   virtual void postprocess_collapse(const CollapseInfo& _ci);
+
+
+   /** Quadric errors of all outgoing halfedges of _v0, in the order of
+       the VertexOHalfedgeIter. No max_err test. */
+   void outgoing_errors(typename Mesh::VertexHandle _v0,
+                        std::vector<typename Mesh::HalfedgeHandle>& _heh,
+                        std::vector<Scalar>& _err);
+
+
+private:
+
+   enum { N_COEFFS = 10 };
+
+   /// Errors of the outgoing halfedges of a vertex, see collapse_priority()
+   struct Batch
+   {
+      Batch() : v0(-1), v0_version(0), next(0) {}
+
+      int                        v0;
+      unsigned int               v0_version;
+      unsigned int               next;        // expected next query
+      std::vector<int>           heh, v1;
+      std::vector<unsigned int>  v1_version;
+      std::vector<Scalar>        err;
+      std::vector<Scalar>        scratch;     // gathered kernel input
+   };
+
+   /// Copy the quadric of _vh into the coefficient arrays
+   void pack(typename Mesh::VertexHandle _vh);
+
+   /// Recompute _b for the outgoing halfedges of _v0
+   void evaluate_batch(typename Mesh::VertexHandle _v0, Batch& _b);
+
+   /// Position of _ci in _b, -1 if _b does not hold a current value
+   int find_in_batch(const CollapseInfo& _ci, Batch& _b);
+
+   /// Batch of the calling thread
+   Batch& thread_batch();
+
+private:
+
+   std::vector<Scalar>        coeffs_[N_COEFFS];
+   std::vector<unsigned int>  version_;
+   std::vector<Batch>         batches_;
+};
+
+
+//=============================================================================
+} // END_NS_DECIMATER
+} // END_NS_OPENMESH
+//=============================================================================
+#if defined(INCLUDE_TEMPLATES) && !defined(OPENMESH_DECIMATER_MODQUADRICSOA_CC)
+#define OPENMESH_DECIMATER_TEMPLATES
+#include "ModQuadricSoAT.cc"
+#endif
+//=============================================================================
+#endif // OPENMESH_DECIMATER_MODQUADRICSOA_HH defined
+//=============================================================================
+
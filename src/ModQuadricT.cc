@@ -1,141 +1,266 @@
-//=============================================================================
-//                                                                            
-//                               OpenMesh                                     
-//        Copyright (C) 2002 by Computer Graphics Group, RWTH Aachen          
-//                           www.openmesh.org                                 
-//                                                                            
-//-----------------------------------------------------------------------------
-//                                                                            
-//                                License                                     
-//                                                                            
-//   This library is free software; you can redistribute it and/or modify it 
-//   under the terms of the GNU Library General Public License as published  
-//   by the Free Software Foundation, version 2.                             
-//                                                                             
-//   This library is distributed in the hope that it will be useful, but       
-//   WITHOUT ANY WARRANTY; without even the implied warranty of                
-//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         
-//   Library General Public License for more details.                          
-//                                                                            
-//   You should have received a copy of the GNU Library General Public         
-//   License along with this library; if not, write to the Free Software       
-//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 
-//                                                                            
-//-----------------------------------------------------------------------------
-//                                                                            
-//   $Revision: 1.1 $
-//   $Date: 2002/12/14 15:28:10 $
-//                                                                            
-//=============================================================================
-
-/** \file ModQuadricT.c
-    Bodies of template member function.
- */
-
-//=============================================================================
-//
-//  CLASS ModQuadric - IMPLEMENTATION
-//
-//=============================================================================
-
-#define OPENMESH_DECIMATER_MODQUADRIC_CC
-
-//== INCLUDES =================================================================
-
-
-#include "ModQuadricT.hh"
-
-
-//the weight to combine the quadric error and the edge length
-
-#define WEIGHT 1
-
-//== NAMESPACE =============================================================== 
-
-namespace OpenMesh { // BEGIN_NS_OPENMESH
-namespace Decimater { // BEGIN_NS_DECIMATER
-
-
-//== IMPLEMENTATION ========================================================== 
-
-
-template<class Mesh>
-void
-ModQuadricT<Mesh>::
-initialize()
-{
-   using Geometry::Quadricd;
-   
-  // clear quadrics
-  typename Mesh::VertexIter  v_it  = mesh_.vertices_begin(), 
-                             v_end = mesh_.vertices_end();
-
-  for (; v_it != v_end; ++v_it)
-  {
-    v_it->quadric.clear();
-
-	//add by zheng, to combine the edge length
-	Quadricd::Vec3    v;
-
-	v = mesh_.point(*v_it);
-
-	Quadricd q (1.0,0.0,0.0,-v[0],
-		            1.0,0.0,-v[1],
-					    1.0,-v[2],
-						     v.sqrnorm());
-	q *= WEIGHT;
-	v_it->quadric = q;
-
-  }
-  
-  
-  // calc (normal weighted) quadric
-  typename Mesh::FaceIter          f_it  = mesh_.faces_begin(),
-                                   f_end = mesh_.faces_end();
-
-  typename Mesh::FaceVertexIter    fv_it;
-  typename Mesh::Vertex            *vp0, *vp1, *vp2;
-
-  Quadricd                         q;
-  Quadricd::Vec3                   v0,v1,v2,n;
-  double                           a,b,c,d, area;
-
-
-  for (; f_it != f_end; ++f_it)
-  {
-    fv_it = mesh_.fv_iter(f_it.handle());
-    vp0 = &(*fv_it);  ++fv_it;
-    vp1 = &(*fv_it);  ++fv_it;
-    vp2 = &(*fv_it);
-
-    v0 = mesh_.point(*vp0);
-    v1 = mesh_.point(*vp1);
-    v2 = mesh_.point(*vp2);
-
-    n    =  (v1-v0) % (v2-v0);
-    area = n.norm();
-    if (area > FLT_MIN) 
-    {
-      n /= area;
-      area *= 0.5;
-    }
-
-    a = n[0];
-    b = n[1];
-    c = n[2];
-    d = -(v0|n);
-
-    q = QuadricT<double>(a, b, c, d);
-    q *= area;
-    
-    vp0->quadric += q;
-    vp1->quadric += q;
-    vp2->quadric += q;
-  }
-}
-
-
-//=============================================================================
-} // END_NS_DECIMATER
-} // END_NS_OPENMESH
-//=============================================================================
+//=============================================================================
+//                                                                            
+//                               OpenMesh                                     
+//        Copyright (C) 2002 by Computer Graphics Group, RWTH Aachen          
+//                           www.openmesh.org                                 
+//                                                                            
+//-----------------------------------------------------------------------------
+//                                                                            
+//                                License                                     
+//                                                                            
+//   This library is free software; you can redistribute it and/or modify it 
+//   under the terms of the GNU Library General Public License as published  
+//   by the Free Software Foundation, version 2.                             
+//                                                                             
+//   This library is distributed in the hope that it will be useful, but       
+//   WITHOUT ANY WARRANTY; without even the implied warranty of                
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         
+//   Library General Public License for more details.                          
+//                                                                            
+//   You should have received a copy of the GNU Library General Public         
+//   License along with this library; if not, write to the Free Software       
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 
+//                                                                            
+//-----------------------------------------------------------------------------
+//                                                                            
+//   $Revision: 1.1 $
+//   $Date: 2002/12/14 15:28:10 $
+//                                                                            
+//=============================================================================
+
+/** \file ModQuadricT.cc
+    Bodies of template member function.
+ */
+
+//=============================================================================
+//
+//  CLASS ModQuadric - IMPLEMENTATION
+//
+//=============================================================================
+
+#define OPENMESH_DECIMATER_MODQUADRIC_CC
+
+//== INCLUDES =================================================================
+
+
+#include <vector>
+#include "ModQuadricT.hh"
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+extern double get_wall_time();
+
+
+//the weight to combine the quadric error and the edge length
+
+#define WEIGHT 1
+
+//== NAMESPACE =============================================================== 
+
+namespace OpenMesh { // BEGIN_NS_OPENMESH
+namespace Decimater { // BEGIN_NS_DECIMATER
+
+
+//== IMPLEMENTATION ========================================================== 
+
+
+template<class Mesh>
+void
+ModQuadricT<Mesh>::
+initialize()
+{
+  double t0 = get_wall_time();
+
+  quadrics_.resize(mesh_.n_vertices());
+
+  bool parallel = parallel_initialize_;
+#if !defined(_OPENMP)
+  parallel = false; // no threads to spread the faces over
+#endif
+
+  if (parallel)
+    initialize_parallel();
+  else
+    initialize_serial();
+
+  initialize_time_ = get_wall_time() - t0;
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+template<class Mesh>
+void
+ModQuadricT<Mesh>::
+init_vertex_quadric(typename Mesh::VertexHandle _vh)
+{
+  using Geometry::Quadricd;
+
+  //add by zheng, to combine the edge length
+  Quadricd::Vec3    v;
+
+  v = mesh_.point(_vh);
+
+  Quadricd q (1.0,0.0,0.0,-v[0],
+                  1.0,0.0,-v[1],
+                      1.0,-v[2],
+                           v.sqrnorm());
+  q *= WEIGHT;
+  quadrics_[_vh.idx()] = q;
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+template<class Mesh>
+void
+ModQuadricT<Mesh>::
+face_plane(typename Mesh::FaceHandle _fh, double _plane[5],
+           typename Mesh::VertexHandle _v[3])
+{
+  using Geometry::Quadricd;
+
+  typename Mesh::FaceVertexIter    fv_it = mesh_.fv_iter(_fh);
+  Quadricd::Vec3                   v0,v1,v2,n;
+  double                           area;
+
+  _v[0] = fv_it.handle();  ++fv_it;
+  _v[1] = fv_it.handle();  ++fv_it;
+  _v[2] = fv_it.handle();
+
+  v0 = mesh_.point(_v[0]);
+  v1 = mesh_.point(_v[1]);
+  v2 = mesh_.point(_v[2]);
+
+  n    =  (v1-v0) % (v2-v0);
+  area = n.norm();
+  if (area > FLT_MIN) 
+  {
+    n /= area;
+    area *= 0.5;
+  }
+
+  _plane[0] = n[0];
+  _plane[1] = n[1];
+  _plane[2] = n[2];
+  _plane[3] = -(v0|n);
+  _plane[4] = area;
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+template<class Mesh>
+void
+ModQuadricT<Mesh>::
+initialize_serial()
+{
+  using Geometry::Quadricd;
+   
+  // clear quadrics
+  typename Mesh::VertexIter  v_it  = mesh_.vertices_begin(), 
+                             v_end = mesh_.vertices_end();
+
+  for (; v_it != v_end; ++v_it)
+    init_vertex_quadric(v_it.handle());
+  
+  
+  // calc (normal weighted) quadric
+  typename Mesh::FaceIter          f_it  = mesh_.faces_begin(),
+                                   f_end = mesh_.faces_end();
+
+  typename Mesh::VertexHandle      vh[3];
+  Quadricd                         q;
+  double                           plane[5];
+
+
+  for (; f_it != f_end; ++f_it)
+  {
+    face_plane(f_it.handle(), plane, vh);
+
+    q = QuadricT<double>(plane[0], plane[1], plane[2], plane[3]);
+    q *= plane[4];
+    
+    quadrics_[vh[0].idx()] += q;
+    quadrics_[vh[1].idx()] += q;
+    quadrics_[vh[2].idx()] += q;
+  }
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+template<class Mesh>
+void
+ModQuadricT<Mesh>::
+initialize_parallel()
+{
+  using Geometry::Quadricd;
+
+  const int  n_vertices = int(mesh_.n_vertices());
+  const int  n_faces    = int(mesh_.n_faces());
+  int        i;
+
+
+  // 1. face planes, independent per face
+  std::vector<double>  planes(5*n_faces);
+  std::vector<int>     corners(3*n_faces);
+
+#pragma omp parallel for schedule(static)
+  for (i = 0; i < n_faces; ++i)
+  {
+    typename Mesh::VertexHandle vh[3];
+    face_plane(typename Mesh::FaceHandle(i), &planes[5*i], vh);
+
+    corners[3*i  ] = vh[0].idx();
+    corners[3*i+1] = vh[1].idx();
+    corners[3*i+2] = vh[2].idx();
+  }
+
+
+  // 2. vertex -> face table. Filled in face order, so every vertex
+  //    lists its faces in the order the serial loop adds them.
+  std::vector<int>  first(n_vertices+1, 0), incident(3*n_faces);
+
+  for (i = 0; i < 3*n_faces; ++i)
+    ++first[corners[i]+1];
+  for (i = 0; i < n_vertices; ++i)
+    first[i+1] += first[i];
+
+  std::vector<int>  fill(first.begin(), first.end()-1);
+  for (i = 0; i < 3*n_faces; ++i)
+    incident[fill[corners[i]]++] = i/3;
+
+
+  // 3. gather, independent per vertex. Same terms in the same order as
+  //    initialize_serial(), hence the same bits.
+#pragma omp parallel for schedule(dynamic, 1024)
+  for (i = 0; i < n_vertices; ++i)
+  {
+    Quadricd  q;
+
+    init_vertex_quadric(typename Mesh::VertexHandle(i));
+
+    for (int k = first[i]; k != first[i+1]; ++k)
+    {
+      const double* plane = &planes[5*incident[k]];
+
+      q = QuadricT<double>(plane[0], plane[1], plane[2], plane[3]);
+      q *= plane[4];
+
+      quadrics_[i] += q;
+    }
+  }
+}
+
+
+//=============================================================================
+} // END_NS_DECIMATER
+} // END_NS_OPENMESH
+//=============================================================================
@@ -0,0 +1,165 @@
+//=============================================================================
+//
+//                               OpenMesh
+//        Copyright (C) 2002 by Computer Graphics Group, RWTH Aachen
+//                           www.openmesh.org
+//
+//-----------------------------------------------------------------------------
+//
+//                                License
+//
+//   This library is free software; you can redistribute it and/or modify it
+//   under the terms of the GNU Library General Public License as published
+//   by the Free Software Foundation, version 2.
+//
+//   This library is distributed in the hope that it will be useful, but
+//   WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//   Library General Public License for more details.
+//
+//   You should have received a copy of the GNU Library General Public
+//   License along with this library; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+//-----------------------------------------------------------------------------
+//
+//   $Revision: 1.1 $
+//   $Date: 2002/12/14 15:28:10 $
+//
+//=============================================================================
+
+/** \file ModQuadricT.hh
+
+ */
+
+//=============================================================================
+//
+//  CLASS ModQuadricT
+//
+//=============================================================================
+
+#ifndef OPENMESH_DECIMATER_MODQUADRIC_HH
+#define OPENMESH_DECIMATER_MODQUADRIC_HH
+
+
+//== INCLUDES =================================================================
+
+#include <float.h>
+#include <vector>
+#include <OpenMeshTools/Geometry/QuadricT.hh>
+#include "ModBaseT.hh"
+
+
+//== NAMESPACE ================================================================
+
+namespace OpenMesh { // BEGIN_NS_OPENMESH
+namespace Decimater { // BEGIN_NS_DECIMATER
+
+
+//== CLASS DEFINITION =========================================================
+
+
+/** Mesh decimation module computing collapse priority based on error quadrics.
+    The vertex quadrics live in an array owned by the module (indexed by
+    vertex index), so the mesh needs no vertex traits and they are freed
+    with the module.
+ */
+template <class Mesh>
+class ModQuadricT : public ModBaseT<Mesh>
+{
+public:
+
+   typedef ModBaseT<Mesh>        Base;
+   typedef CollapseInfoT<Mesh>   CollapseInfo;
+
+   /// Constructor
+   ModQuadricT( Mesh& _mesh, double _max_err = DBL_MAX ) :
+         Base(_mesh, false), mesh_(_mesh), max_err_(_max_err),
+         parallel_initialize_(false), initialize_time_(0.0)
+   {}
+
+   /// Destructor
+   virtual ~ModQuadricT() {}
+
+
+   /// Compute the vertex quadrics (vertex term plus area weighted face planes)
+   virtual void initialize(void);
+
+
+   /// Quadric error of the collapsed vertex, -1 if it exceeds max_err
+   virtual float collapse_priority(const CollapseInfo& _ci)
+   {
+      Geometry::Quadricd q = quadrics_[_ci.v0.idx()];
+      q += quadrics_[_ci.v1.idx()];
+
+      double err = q(_ci.p1);
+      return float( (err < max_err_) ? err : -1.0 );
+   }
+
+
+   /// v1 inherits the quadric of v0
+   virtual void postprocess_collapse(const CollapseInfo& _ci)
+   {
+      quadrics_[_ci.v1.idx()] += quadrics_[_ci.v0.idx()];
+   }
+
+
+   /// Set maximal error a collapse may introduce
+   void set_max_err(double _err) { max_err_ = _err; }
+
+
+   /** Accumulate the face quadrics on several threads. The result is
+       bit-identical to the serial loop. Needs OpenMP, otherwise the
+       serial loop is used. */
+   void set_parallel_initialize(bool _b) { parallel_initialize_ = _b; }
+
+   /// Wall clock seconds spent in the last call to initialize()
+   double initialize_time() const { return initialize_time_; }
+
+   /// Quadric of _vh, valid after initialize()
+   const Geometry::Quadricd& quadric(typename Mesh::VertexHandle _vh) const
+   { return quadrics_[_vh.idx()]; }
+
+
+private:
+
+   /// One face loop, scattering into the three corner quadrics
+   void initialize_serial();
+
+   /// Per-face planes in parallel, then per-vertex gather in face order
+   void initialize_parallel();
+
+   /// Reset a vertex quadric to the (weighted) distance to its own point
+   void init_vertex_quadric(typename Mesh::VertexHandle _vh);
+
+   /** Plane (a, b, c, d) and area of face _fh. The corners are returned
+       in _v, in face vertex iterator order. */
+   void face_plane(typename Mesh::FaceHandle _fh, double _plane[5],
+                   typename Mesh::VertexHandle _v[3]);
+
+protected:
+
+   Mesh&   mesh_;
+   double  max_err_;
+
+private:
+
+   bool    parallel_initialize_;
+   double  initialize_time_;
+
+   std::vector<Geometry::Quadricd>  quadrics_;
+};
+
+
+//=============================================================================
+} // END_NS_DECIMATER
+} // END_NS_OPENMESH
+//=============================================================================
+#if defined(INCLUDE_TEMPLATES) && !defined(OPENMESH_DECIMATER_MODQUADRIC_CC)
+#define OPENMESH_DECIMATER_TEMPLATES
+#include "ModQuadricT.cc"
+#endif
+//=============================================================================
+#endif // OPENMESH_DECIMATER_MODQUADRIC_HH defined
+//=============================================================================
+
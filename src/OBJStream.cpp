@@ -0,0 +1,73 @@
+#include <stdlib.h>
+#include <string.h>
+#include "OBJStream.h"
+
+#pragma warning(disable: 4018)  // signed/unsigned mismatch
+
+// Parse one OBJ face index ("7", "7/1", "7/1/3", "7//3", negative = relative)
+static int parseIndex(const char* token, int vertexCount)
+{
+	int i = atoi(token);
+	return (i < 0) ? vertexCount + i : i - 1;
+}
+
+bool OBJStream::open(const char* filename)
+{
+	close();
+	file = fopen(filename, "r");
+	return file != NULL;
+}
+
+void OBJStream::close()
+{
+	if (file) fclose(file);
+	file = NULL;
+	vertexCount = 0;
+	polygon.clear();
+	fanIndex = 0;
+}
+
+void OBJStream::rewind()
+{
+	if (file) fseek(file, 0, SEEK_SET);
+	vertexCount = 0;
+	polygon.clear();
+	fanIndex = 0;
+}
+
+OBJStream::Record OBJStream::next(PM::Point& p, int tri[3])
+{
+	while (true)
+	{
+		// rest of the current polygon
+		if (fanIndex + 1 < polygon.size())
+		{
+			tri[0] = polygon[0];
+			tri[1] = polygon[fanIndex];
+			tri[2] = polygon[fanIndex+1];
+			fanIndex++;
+			return TRIANGLE;
+		}
+
+		if (!file || !fgets(line, sizeof(line), file))
+			return END;
+
+		if (line[0] == 'v' && line[1] == ' ')
+		{
+			float x, y, z;
+			if (sscanf(line + 2, "%f %f %f", &x, &y, &z) == 3)
+			{
+				p = PM::Point(x, y, z);
+				vertexCount++;
+				return VERTEX;
+			}
+		}
+		else if (line[0] == 'f' && line[1] == ' ')
+		{
+			polygon.clear();
+			for (char* token = strtok(line + 2, " \t\r\n"); token; token = strtok(NULL, " \t\r\n"))
+				polygon.push_back(parseIndex(token, vertexCount));
+			fanIndex = 1;
+		}
+	}
+}
@@ -0,0 +1,44 @@
+// Sequential OBJ reader for files too large to load at once. Only
+// vertex positions and faces are read; polygons come out as fans of
+// triangles. Face indices are returned 0-based, relative indices are
+// resolved against the vertices read so far.
+
+#ifndef OBJ_STREAM_H
+#define OBJ_STREAM_H
+
+#include <stdio.h>
+#include <vector>
+#include "TriMesh.h"
+
+class OBJStream
+{
+public:
+	OBJStream() : file(NULL), vertexCount(0), fanIndex(0) {}
+	~OBJStream() { close(); }
+
+	bool open(const char* filename);
+	void close();
+
+	/// Start over at the beginning of the file
+	void rewind();
+
+	enum Record { END, VERTEX, TRIANGLE };
+
+	/// Read the next vertex (into p) or triangle (into tri)
+	Record next(PM::Point& p, int tri[3]);
+
+	/// Vertices read so far
+	int getVertexCount() const { return vertexCount; }
+
+private:
+	FILE* file;
+	int vertexCount;
+
+	// face being fanned out
+	std::vector<int> polygon;
+	int fanIndex;
+
+	char line[1024];
+};
+
+#endif
@@ -0,0 +1,169 @@
+#include "PMCodec.h"
+
+// Carry-less range coder: bytes go out as soon as the top byte of the
+// interval is settled; when the interval gets too small around a byte
+// boundary, it is cut down to one side of it.
+static const unsigned int TOP = 1 << 24;
+static const unsigned int BOT = 1 << 16;
+
+void RangeEncoder::normalize()
+{
+	while ((low ^ (low + range)) < TOP ||
+		(range < BOT && ((range = (0 - low) & (BOT - 1)), true)))
+	{
+		out.push_back((unsigned char)(low >> 24));
+		low <<= 8;
+		range <<= 8;
+	}
+}
+
+void RangeEncoder::encode(BitModel& m, int bit)
+{
+	unsigned int bound = (range >> BitModel::BITS) * m.p;
+
+	if (!bit)
+		range = bound;
+	else
+	{
+		low += bound;
+		range -= bound;
+	}
+
+	m.update(bit);
+	normalize();
+}
+
+void RangeEncoder::encodeDirect(unsigned int v, int count)
+{
+	while (count-- > 0)
+	{
+		range >>= 1;
+		if ((v >> count) & 1) low += range;
+		normalize();
+	}
+}
+
+void RangeEncoder::flush()
+{
+	for (int i = 0; i < 4; i++)
+	{
+		out.push_back((unsigned char)(low >> 24));
+		low <<= 8;
+	}
+}
+
+RangeDecoder::RangeDecoder(const unsigned char* data, size_t size)
+	: data(data), size(size), pos(0), low(0), range(0xFFFFFFFF), code(0)
+{
+	for (int i = 0; i < 4; i++)
+		code = (code << 8) | next();
+}
+
+void RangeDecoder::normalize()
+{
+	while ((low ^ (low + range)) < TOP ||
+		(range < BOT && ((range = (0 - low) & (BOT - 1)), true)))
+	{
+		code = (code << 8) | next();
+		low <<= 8;
+		range <<= 8;
+	}
+}
+
+int RangeDecoder::decode(BitModel& m)
+{
+	unsigned int bound = (range >> BitModel::BITS) * m.p;
+	int bit;
+
+	if (code - low < bound)
+	{
+		range = bound;
+		bit = 0;
+	}
+	else
+	{
+		low += bound;
+		range -= bound;
+		bit = 1;
+	}
+
+	m.update(bit);
+	normalize();
+	return bit;
+}
+
+unsigned int RangeDecoder::decodeDirect(int count)
+{
+	unsigned int v = 0;
+
+	while (count-- > 0)
+	{
+		range >>= 1;
+		int bit = (code - low >= range);
+		if (bit) low += range;
+		v = (v << 1) | bit;
+		normalize();
+	}
+
+	return v;
+}
+
+void IntModel::encode(RangeEncoder& rc, unsigned int v)
+{
+	// v+1 = 2^bucket + mantissa
+	unsigned int w = v + 1;
+	int bucket = 0;
+	while (bucket < 31 && (w >> (bucket + 1))) bucket++;
+	if (w == 0) bucket = 32;		// v = 2^32-1
+
+	// bucket, 6 bit tree
+	int node = 1;
+	for (int i = 5; i >= 0; i--)
+	{
+		int bit = (bucket >> i) & 1;
+		rc.encode(bucketTree[node], bit);
+		node = (node << 1) | bit;
+	}
+
+	// mantissa, the top bits adaptive
+	int adaptive = (bucket < ADAPTIVE_BITS) ? bucket : ADAPTIVE_BITS;
+	int rest = bucket - adaptive;
+	unsigned int mantissa = (bucket == 32) ? 0 : w - (1u << bucket);
+
+	node = 1;
+	for (int i = bucket - 1; i >= rest; i--)
+	{
+		int bit = (mantissa >> i) & 1;
+		rc.encode(this->mantissa[bucket][node], bit);
+		node = (node << 1) | bit;
+	}
+
+	rc.encodeDirect(mantissa, rest);
+}
+
+unsigned int IntModel::decode(RangeDecoder& rc)
+{
+	int node = 1;
+	for (int i = 0; i < 6; i++)
+		node = (node << 1) | rc.decode(bucketTree[node]);
+
+	int bucket = node - 64;
+	if (bucket > 32) bucket = 32;		// corrupt data
+
+	int adaptive = (bucket < ADAPTIVE_BITS) ? bucket : ADAPTIVE_BITS;
+	int rest = bucket - adaptive;
+
+	unsigned int high = 0;
+	node = 1;
+	for (int i = 0; i < adaptive; i++)
+	{
+		int bit = rc.decode(mantissa[bucket][node]);
+		node = (node << 1) | bit;
+		high = (high << 1) | bit;
+	}
+
+	unsigned int m = (high << rest) | rc.decodeDirect(rest);
+
+	if (bucket == 32) return 0xFFFFFFFF;
+	return (1u << bucket) + m - 1;
+}
@@ -0,0 +1,132 @@
+// Entropy coding for compressed progressive meshes (.pmz).
+//
+// An adaptive binary range coder (carry-less, 32 bit, after Subbotin)
+// with two kinds of models on top:
+//
+//   BitModel  one adaptive probability
+//   IntModel  unsigned integers as Elias-gamma style bucket (the bit
+//             length, coded with an adaptive bit tree) plus the bits
+//             below the leading one (the top ones adaptive per bucket,
+//             the rest flat)
+//
+// Signed values are zigzag mapped first. Models adapt as they code, so
+// encoder and decoder must use the same models in the same order.
+
+#ifndef PM_CODEC_H
+#define PM_CODEC_H
+
+#include <stddef.h>
+#include <vector>
+#include "PMFile.h"
+
+// Compressed progressive mesh file: a PMZHeader, then the range coded
+// payload. In the payload, vertices are renumbered: the base mesh
+// vertices come first, then split k adds vertex baseVertexCount + k, so
+// v0 of a split is never stored. Per split, v1 is coded as a delta to
+// the previous v1, vl and vr as positions in the one-ring of v1 (which
+// the decoder knows, it refines as it decodes), the position of v0 as a
+// delta to v1 on the quantization grid, and the detail vectors of v0
+// quantized with detailStep. Version 3 has detail vectors in the same
+// frames as version 3 .pm files, which point their tangent by this
+// numbering and so survive it.
+#define PMZ_FILE_MAGIC   "MPZ"
+#define PMZ_FILE_VERSION 3
+
+struct PMZHeader
+{
+	char magic[4];
+	PMFileUInt version;
+
+	PMFileUInt baseVertexCount;
+	PMFileUInt baseFaceCount;
+	PMFileUInt splitCount;
+	PMFileUInt payloadSize;
+
+	/// Quantization grid: point = bboxMin + step * q
+	float bboxMin[3];
+	float step;
+
+	/// Step of the detail vectors
+	float detailStep;
+};
+
+/// Signed <-> unsigned, small magnitudes to small numbers
+inline unsigned int zigzag(int v) { return (unsigned int)((v << 1) ^ (v >> 31)); }
+inline int unzigzag(unsigned int u) { return (int)(u >> 1) ^ -(int)(u & 1); }
+
+class BitModel
+{
+public:
+	enum { BITS = 12, ONE = 1 << BITS, SHIFT = 5 };
+
+	BitModel() : p(ONE / 2) {}
+
+	// probability of a 0, in 1/ONE
+	unsigned int p;
+
+	void update(int bit)
+	{
+		if (bit) p -= p >> SHIFT;
+		else     p += (ONE - p) >> SHIFT;
+	}
+};
+
+class RangeEncoder
+{
+public:
+	RangeEncoder(std::vector<unsigned char>& out) : out(out), low(0), range(0xFFFFFFFF) {}
+
+	void encode(BitModel& m, int bit);
+
+	/// count bits of v with probability 1/2, high bit first
+	void encodeDirect(unsigned int v, int count);
+
+	/// Write out the rest, call once at the end
+	void flush();
+
+private:
+	void normalize();
+
+	std::vector<unsigned char>& out;
+	unsigned int low, range;
+};
+
+class RangeDecoder
+{
+public:
+	RangeDecoder(const unsigned char* data, size_t size);
+
+	int decode(BitModel& m);
+	unsigned int decodeDirect(int count);
+
+	/// True if the decoder read past the end of the data
+	bool overrun() const { return pos > size + 4; }
+
+private:
+	void normalize();
+	unsigned char next() { return (pos < size) ? data[pos++] : (pos++, 0); }
+
+	const unsigned char* data;
+	size_t size, pos;
+	unsigned int low, range, code;
+};
+
+class IntModel
+{
+public:
+	/// Unsigned integers below 2^32; the adaptive mantissa bits
+	enum { BUCKETS = 33, ADAPTIVE_BITS = 2 };
+
+	void encode(RangeEncoder& rc, unsigned int v);
+	unsigned int decode(RangeDecoder& rc);
+
+	void encodeSigned(RangeEncoder& rc, int v) { encode(rc, zigzag(v)); }
+	int decodeSigned(RangeDecoder& rc) { return unzigzag(decode(rc)); }
+
+private:
+	// bucket b holds v with v+1 in [2^b, 2^(b+1))
+	BitModel bucketTree[64];
+	BitModel mantissa[BUCKETS][1 << ADAPTIVE_BITS];
+};
+
+#endif
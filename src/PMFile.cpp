@@ -0,0 +1,144 @@
+#include <string.h>
+#include "PMFile.h"
+
+#if defined(WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+void layoutPMFile(PMFileHeader& header)
+{
+	memcpy(header.magic, PM_FILE_MAGIC, 4);
+	header.version = PM_FILE_VERSION;
+	header.headerSize = sizeof(PMFileHeader);
+
+	// every array is a multiple of 4 bytes long, so all stay aligned
+	PMFileUInt offset = sizeof(PMFileHeader);
+
+	header.pointsOffset = offset;
+	offset += header.vertexCount * 3 * sizeof(float);
+
+	header.origPointsOffset = offset;
+	offset += header.vertexCount * 3 * sizeof(float);
+
+	header.baseFacesOffset = offset;
+	offset += header.baseFaceCount * 3 * sizeof(int);
+
+	header.splitsOffset = offset;
+	offset += header.splitCount * 4 * sizeof(int);
+
+	header.orderingOffset = offset;
+	offset += header.orderingCount * sizeof(int);
+
+	header.detailOffsetsOffset = offset;
+	offset += (header.vertexCount + 1) * sizeof(PMFileUInt);
+
+	header.detailVectorsOffset = offset;
+	offset += header.detailVectorCount * 3 * sizeof(float);
+
+	header.fileSize = offset;
+}
+
+bool validatePMFile(const PMFileHeader& header, size_t size)
+{
+	if (size < sizeof(PMFileHeader)) return false;
+	if (memcmp(header.magic, PM_FILE_MAGIC, 4) != 0) return false;
+	if (header.version != PM_FILE_VERSION) return false;
+	if (header.headerSize != sizeof(PMFileHeader)) return false;
+	if (header.baseVertexCount > header.vertexCount) return false;
+
+	// no count larger than the file, so the layout can't overflow
+	if (header.vertexCount > size / 12 || header.baseFaceCount > size / 12 ||
+		header.splitCount > size / 16 || header.orderingCount > size / 4 ||
+		header.detailVectorCount > size / 12)
+		return false;
+
+	// recompute the layout from the counts, it must match
+	PMFileHeader layout = header;
+	layoutPMFile(layout);
+
+	return memcmp(&layout, &header, sizeof(PMFileHeader)) == 0
+		&& header.fileSize <= size;
+}
+
+bool isLittleEndianHost()
+{
+	PMFileUInt one = 1;
+	return *(const unsigned char*)&one == 1;
+}
+
+#if defined(WIN32)
+
+bool MappedFile::open(const char* filename)
+{
+	close();
+
+	HANDLE file = CreateFile(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (file == INVALID_HANDLE_VALUE) return false;
+	handle = file;
+
+	size = GetFileSize(file, NULL);
+	if (size == 0) { close(); return false; }
+
+	mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!mapping) { close(); return false; }
+
+	data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!data) { close(); return false; }
+
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (data) UnmapViewOfFile(data);
+	if (mapping) CloseHandle(mapping);
+	if (handle) CloseHandle(handle);
+
+	data = NULL;
+	size = 0;
+	handle = mapping = NULL;
+}
+
+#else
+
+bool MappedFile::open(const char* filename)
+{
+	close();
+
+	int fd = ::open(filename, O_RDONLY);
+	if (fd < 0) return false;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0)
+	{
+		::close(fd);
+		return false;
+	}
+
+	void* p = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);		// the mapping keeps the file open
+
+	if (p == MAP_FAILED) return false;
+
+	data = (const char*)p;
+	size = st.st_size;
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (data) munmap((void*)data, size);
+
+	data = NULL;
+	size = 0;
+}
+
+#endif
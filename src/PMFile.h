@@ -0,0 +1,99 @@
+// Binary progressive mesh (.pm) file layout.
+//
+// A .pm file is a header followed by flat little-endian arrays, every
+// one 4-byte aligned and found through an offset in the header, so a
+// viewer can map the file and use the arrays in place:
+//
+//   points        float[vertexCount][3]       positions at full detail
+//   origPoints    float[vertexCount][3]       orig_point of every vertex
+//   baseFaces     int[baseFaceCount][3]       faces of the base mesh
+//   splits        int[splitCount][4]          v0, v1, vl, vr (-1 = none),
+//                                             in collapse order
+//   ordering      int[orderingCount]          vertexOrdering
+//   detailOffsets unsigned[vertexCount+1]     first detail vector of each
+//                                             vertex in detailVectors
+//   detailVectors float[detailVectorCount][3]
+//
+// Vertex indices are those of the full mesh. The base mesh is the mesh
+// at the coarsest level; its vertices are the ones no split introduces.
+//
+// Readers must reject files whose version they don't know; a new field
+// means a new version. So does a new meaning of an old one: version 2
+// has the detail vectors in the frames Frame.h gives at the level of
+// their split, version 3 in those frames with the tangent towards the
+// neighbor first in the numbering of .pmz files (PMCodec.h).
+
+#ifndef PM_FILE_H
+#define PM_FILE_H
+
+#include <stddef.h>
+
+// "MPM" + format version
+#define PM_FILE_MAGIC   "MPM"
+#define PM_FILE_VERSION 3
+
+// 32 bit integers on every platform we build for
+typedef unsigned int PMFileUInt;
+
+struct PMFileHeader
+{
+	char magic[4];
+	PMFileUInt version;
+	PMFileUInt headerSize;		// sizeof(PMFileHeader)
+	PMFileUInt fileSize;
+
+	PMFileUInt vertexCount;
+	PMFileUInt baseVertexCount;
+	PMFileUInt baseFaceCount;
+	PMFileUInt splitCount;
+	PMFileUInt orderingCount;
+	PMFileUInt detailVectorCount;
+
+	float bboxMin[3], bboxMax[3];
+
+	// byte offsets from the start of the file
+	PMFileUInt pointsOffset;
+	PMFileUInt origPointsOffset;
+	PMFileUInt baseFacesOffset;
+	PMFileUInt splitsOffset;
+	PMFileUInt orderingOffset;
+	PMFileUInt detailOffsetsOffset;
+	PMFileUInt detailVectorsOffset;
+};
+
+/// Fill in the offsets and fileSize from the counts
+void layoutPMFile(PMFileHeader& header);
+
+/// Check magic, version and that all arrays lie within size bytes
+bool validatePMFile(const PMFileHeader& header, size_t size);
+
+/// True on little-endian hosts, the only ones that can use .pm files
+/// without byte swapping
+bool isLittleEndianHost();
+
+/// Read-only mapping of a whole file
+class MappedFile
+{
+public:
+	MappedFile() : data(NULL), size(0), handle(NULL), mapping(NULL) {}
+	~MappedFile() { close(); }
+
+	bool open(const char* filename);
+	void close();
+
+	const char* getData() const { return data; }
+	size_t getSize() const { return size; }
+
+	template <class T>
+	const T* at(PMFileUInt offset) const { return (const T*)(data + offset); }
+
+private:
+	const char* data;
+	size_t size;
+
+	// platform handles
+	void* handle;
+	void* mapping;
+};
+
+#endif
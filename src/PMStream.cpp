@@ -0,0 +1,62 @@
+#include <string.h>
+#include "PMStream.h"
+
+#if !defined(WIN32)
+#include <fcntl.h>
+#endif
+
+bool validatePMStream(const PMStreamHeader& header)
+{
+	return memcmp(header.magic, PM_STREAM_MAGIC, 4) == 0
+		&& header.version == PM_STREAM_VERSION
+		&& header.vertexCount <= PM_STREAM_MAX_VERTICES
+		&& header.baseFaceCount <= PM_STREAM_MAX_FACES
+		&& header.baseVertexCount <= header.vertexCount
+		&& header.splitCount <= header.vertexCount - header.baseVertexCount;
+}
+
+bool PMStreamReader::open(const char* filename)
+{
+	close();
+
+	file = fopen(filename, "rb");
+	if (!file) return false;
+
+#if !defined(WIN32)
+	// pipes must not block when the writer is behind
+	int fd = fileno(file);
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+#endif
+
+	return true;
+}
+
+void PMStreamReader::close()
+{
+	if (file) fclose(file);
+	file = NULL;
+	pending.clear();
+}
+
+bool PMStreamReader::read(void* data, size_t size)
+{
+	if (!file) return false;
+
+	// never read past the requested bytes, the rest stays in the file
+	size_t have = pending.size();
+	if (have < size)
+	{
+		pending.resize(size);
+		have += fread(&pending[have], 1, size - have, file);
+		pending.resize(have);
+
+		// at the end of what has been written so far; try again later
+		clearerr(file);
+	}
+
+	if (have < size) return false;
+
+	memcpy(data, &pending[0], size);
+	pending.clear();
+	return true;
+}
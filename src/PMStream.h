@@ -0,0 +1,82 @@
+// Append-only progressive mesh stream (.pms).
+//
+// Unlike a .pm file, a stream is written front to back and can be read
+// while it is still being written (to a file or a pipe): first the base
+// mesh, then one record per vertex split, coarsest split first. A reader
+// can show the base mesh as soon as it has arrived and refine as far as
+// the splits read so far go.
+//
+//   PMStreamHeader
+//   PMStreamVertex[baseVertexCount]    base mesh vertices
+//   int[baseFaceCount][3]              base mesh faces
+//   PMStreamSplit[splitCount]          in refinement order
+//
+// All values are 32 bit little-endian. Vertex indices are those of the
+// full mesh (0..vertexCount-1).
+
+#ifndef PM_STREAM_H
+#define PM_STREAM_H
+
+#include <stdio.h>
+#include <vector>
+#include "PMFile.h"
+
+#define PM_STREAM_MAGIC   "MPS"
+#define PM_STREAM_VERSION 1
+
+// Largest counts a stream header may give. A stream may still be
+// arriving, so its counts can't be checked against its size; these keep
+// a corrupt header from sizing huge allocations.
+#define PM_STREAM_MAX_VERTICES (1 << 26)
+#define PM_STREAM_MAX_FACES    (1 << 27)
+
+struct PMStreamHeader
+{
+	char magic[4];
+	PMFileUInt version;
+
+	PMFileUInt vertexCount;
+	PMFileUInt baseVertexCount;
+	PMFileUInt baseFaceCount;
+	PMFileUInt splitCount;
+};
+
+struct PMStreamVertex
+{
+	int index;
+	float point[3];
+};
+
+/// Split of v1 into v0 and v1 (the inverse of the collapse v0 -> v1);
+/// point is the position of v0
+struct PMStreamSplit
+{
+	int v0, v1, vl, vr;
+	float point[3];
+};
+
+/// Check magic, version and counts of a stream header, and that the
+/// counts are within the maxima above
+bool validatePMStream(const PMStreamHeader& header);
+
+/// Reads a stream without blocking on data that hasn't arrived yet
+class PMStreamReader
+{
+public:
+	PMStreamReader() : file(NULL) {}
+	~PMStreamReader() { close(); }
+
+	bool open(const char* filename);
+	void close();
+	bool isOpen() const { return file != NULL; }
+
+	/// Copy the next size bytes to data if they have all arrived. If
+	/// not, keep the bytes there are for the next call and return false.
+	bool read(void* data, size_t size);
+
+private:
+	FILE* file;
+	std::vector<char> pending;
+};
+
+#endif
@@ -1,541 +1,2258 @@
-/*
-@file ProgressiveMesh.cpp
-*/
-
-#include <cassert>
-#include <algorithm>
-#include <vector>
-#include <iostream>
-#include <fstream>
-#include "ProgressiveMesh.h"
-#include "MeshOp.h"
-#include "DividedDifference.h"
-#include "Frame.h"
-
-// #pragma warning(disable: 4018)  // signed/unsigned mismatch
-
-using namespace std;
-
-// Debugging output
-void print_mesh(PM& mesh)
-{
-	for (PM::FaceIter f_it=mesh.faces_begin(); f_it!=mesh.faces_end(); ++f_it)
-	{
-		if (mesh.face(f_it.handle()).deleted())
-			continue;		
-		cout << "Face: ";
-		for (PM::FaceVertexIter fv_it=mesh.fv_iter(f_it.handle());fv_it;++fv_it)
-		{
-			cout << mesh.point(*fv_it) << ", ";			
-		}
-		cout << endl;
-	}
-}
-
-void print_vertexhandle(PM& mesh, PM::VertexHandle vh)
-{
-	if (vh.is_valid())
-	{
-		cout << mesh.point(vh);
-	}
-	else
-	{
-		cout << "(null)";
-	}
-}
-
-void print_pminfo(PM& mesh, Decimater::ProgMeshInfo pminfo)
-{
-	cout << "v0 = ";
-	print_vertexhandle(mesh, pminfo.v0);	
-
-	cout << "\nv1 = ";
-	print_vertexhandle(mesh, pminfo.v1);
-
-	cout << "\nvl = ";
-	print_vertexhandle(mesh, pminfo.vl);
-
-	cout << "\nvr = ";
-	print_vertexhandle(mesh, pminfo.vr);
-	cout << endl;
-}
-
-void print_frame(Frame<PM>& frame)
-{
-	cout << " [" << frame.T << ", " << frame.U << ", " << frame.V << "] ";
-}
-
-void ProgressiveMesh::computeBoundingBox()
-{
-	PM::VertexIter vit = mesh.vertices_begin(), vend = mesh.vertices_end();
-
-	if (vit == vend)
-	{
-		return;
-	}
-
-	PM::Point firstPoint = mesh.point(*vit);
-	bbox_min = bbox_max = firstPoint;
-
-	for ( ; vit != vend; ++vit)
-	{		
-		PM::Point p = mesh.point(*vit);
-		for (int i=0; i < 3; i++)
-		{
-			bbox_min[i] = min(bbox_min[i], p[i]);
-			bbox_max[i] = max(bbox_max[i], p[i]);
-		}
-	}
-}
-
-bool ProgressiveMesh::readFile(const char* filename)
-{
-	if (filename)
-	{
-		mesh.clear();
-		OpenMesh::MeshIO::read_mesh(mesh, filename);
-		minVCount=maxVCount=currentVCount=mesh.n_vertices();
-
-		PM::VertexIter v_it = mesh.vertices_begin(), v_end = mesh.vertices_end();
-		
-		/*int boundaryCount = 0;
-		for ( ; v_it != v_end; ++v_it)
-		{
-			if (mesh.is_boundary(mesh.handle(*v_it))) boundaryCount++;
-		}
-
-		cout << boundaryCount << " vertices on the boundary." << endl;*/
-
-		int v = mesh.n_vertices();
-		int e = mesh.n_edges();
-		int f = mesh.n_faces();
-
-		int x = v - e + f;
-
-		cout << v << " vertices, " 
-			<< e << " edges, and " 
-			<< f << " faces loaded." <<endl;
-		cout << "X(G) = " << x << "\n" << endl;
-
-		computeBoundingBox();
-
-		// Compute face normals
-		mesh.update_face_normals();
-
-		// Clear weight cache, reserve enough empty entries
-		vertexWeightCache.clear();
-		vertexWeightCache = VertexUpdateListCache(v);
-
-		return true;
-	}
-	return false;
-}
-
-bool ProgressiveMesh::writeFile(const char* filename)
-{
-	if (filename)
-	{
-		OpenMesh::MeshIO::write_mesh(mesh, filename);
-		return true;
-	}
-	return false;
-}
-
-// Return true iff PM is refinable
-bool ProgressiveMesh::is_refinable()
-{
-	return (pmIter != pmInfos.begin());
-}
-
-void ProgressiveMesh::refineToLevelN(int n)
-{
-	while (currentVCount < n && is_refinable())
-	{		
-		refine();
-	}
-}
-
-PMInfoContainer::iterator ProgressiveMesh::refine()
-{
-	assert(is_refinable());	
-	--pmIter;
-	
-	mesh.vertex_split(pmIter->v0, pmIter->v1, pmIter->vl, pmIter->vr);	
-	mesh.vertex(pmIter->v0).set_deleted(false);
-	++currentVCount;
-	return pmIter;
-}
-
-// Return true iff PM is coarsenable
-bool ProgressiveMesh::is_coarsenable()
-{
-	return (pmIter != pmInfos.end());
-}
-
-PMInfoContainer::iterator ProgressiveMesh::coarsen()
-{
-	assert(is_coarsenable());
-
-	PMInfoContainer::iterator iter = pmIter;
-
-	PM::HalfedgeHandle hh = mesh.find_halfedge(pmIter->v0, pmIter->v1);
-	mesh.collapse(hh);
-	--currentVCount;
-	++pmIter;
-
-	return iter;
-}
-
-void ProgressiveMesh::coarsenToLevelN(int n)
-{	
-	while (currentVCount > n && is_coarsenable())
-	{		
-		coarsen();
-	}
-}
-
-bool ProgressiveMesh::readPMFile(const char* filename)
-{
-	return false;
-}
-
-void ProgressiveMesh::buildPM()
-{
-	if (mesh.n_vertices() == 0) return;
-
-	Timer t;
-	cout << "Decimating... ";
-
-	// garbage collect
-	mesh.garbage_collection();
-
-	// copy points to orig_point
-	store_original_mesh(mesh);
-
-	// 1. create decimating instance
-	Decimater decimater(mesh);
-	
-	// 2. register modules
-	OpenMesh::Decimater::ModQuadricT<PM> modQuadric(mesh);
-	// clear up of these modules are in decimater
-	decimater.registrate(modQuadric);
-
-	// 3. initialize setup
-	decimater.initialize();
-	decimater.generate_progmesh_info(&pmInfos);	
-
-	// 4. simplify as much as possible
-	int numVertexDecimated = decimater.decimate();
-
-	// update information
-	currentVCount = minVCount = maxVCount - numVertexDecimated;
-
-	pmIter = pmInfos.end();
-	
-	cout << "(" << t.get_elapsed() << "s)" << endl;
-
-	// TODO how to we choose this?
-	int minDetailLevel = maxVCount / 100;
-	refineToLevelN(minDetailLevel);
-
-	// compute
-	t.reset();
-	cout << "Computing detail vectors... ";
-	computeDetailVectors(maxVCount);	
-	cout << "(" << t.get_elapsed() << "s)\n" << endl;
-
-	// store ordering of vertices
-	vertexOrdering.clear();
-	PMInfoContainer::reverse_iterator pit = pmInfos.rbegin(), pend = pmInfos.rend();
-	for ( ; pit != pend; ++pit)
-	{
-		vertexOrdering.push_back(pit->v0);
-	}
-}
-
-void ProgressiveMesh::computeVertexWeights(
-	PM::VertexHandle vh_n, VertexUpdateList& vertexUpdates)
-{
-	// mannequin.obj:    Filtering w/o cache = 1.7s, w/cache = 0.04s
-	// manifold-cow.obj: Filtering w/o cache = 7.2s, w/cache = 0.2s
-
-	bool cacheWeights = true;
-
-	if (cacheWeights) {
-		// Make sure cache is large enough to hold vh_n data
-		int index = vh_n.idx();
-		assert(index >= 0);
-		VertexUpdateList empty;
-		while (vertexWeightCache.size() < index+1) {
-			vertexWeightCache.push_back(empty);
-		}
-
-		// In cache?
-		vertexUpdates = vertexWeightCache[index];
-		
-		// If not, compute
-		if (vertexUpdates.size() == 0) {			
-			computeVertexWeights_calc(vh_n, vertexUpdates);
-
-			// Cache
-			vertexWeightCache[index] = vertexUpdates;
-		}		
-	} else {
-		return computeVertexWeights_calc(vh_n, vertexUpdates);
-	}
-}
-
-// Compute relaxation weights for a vertex vh_n and its 1-ring neighbors
-void ProgressiveMesh::computeVertexWeights_calc(
-	PM::VertexHandle vh_n, VertexUpdateList& vertexUpdates)
-{
-	typedef std::vector<PM::VertexHandle> VertexHandles;
-	VertexHandles vertices = findTwoRingNeighborhood(mesh, vh_n);
-
-	VertexWeights weights_vh_n;
-	
-	for (int i=0; i<vertices.size(); i++) 
-	{
-		// Relax new mesh, using weights from original mesh		
-		PM::Scalar weight = weight_ij(mesh, vh_n, vertices[i]);		
-		weights_vh_n.push_back(make_pair(vertices[i], weight));
-	}	
-
-	// Store weights that we will use to update vh_n
-	vertexUpdates.push_back(make_pair(vh_n,weights_vh_n));
-
-	// Now relax one-ring neighborhood 
-	PM::VertexVertexIter vv_it= mesh.vv_iter(vh_n);
-	for ( ; vv_it; ++vv_it)
-	{
-		VertexWeights weights_vh_outer;
-
-		// Get vertex handle of vertex on 1-ring neighborhood
-		PM::VertexHandle vh_outer = vv_it.handle();
-
-		// Get the V2 neighbors and compute the updated position
-		VertexHandles v2_vertices = findTwoRingNeighborhood(mesh, vh_outer);
-		
-		// Loop over the V2 neighborhood of vh_outer
-		VertexHandles::iterator hand_it, hand_end = v2_vertices.end();
-		for (hand_it = v2_vertices.begin(); hand_it != hand_end; ++hand_it) 
-		{
-			PM::VertexHandle v2_neighbor = *hand_it;
-			if (v2_neighbor == vh_n) continue;
-
-			PM::Scalar weight = weight_ij(mesh, vh_outer, v2_neighbor);			
-			weights_vh_outer.push_back(make_pair(v2_neighbor, weight));			
-		}
-
-		// Sum up the last term (w_j_n * q_n)
-		PM::Scalar w_j_n = weight_ij(mesh, vh_outer, vh_n);		
-		weights_vh_outer.push_back(make_pair(vh_n, w_j_n));
-
-		// Store weights that we will use to update vh_outer		
-		vertexUpdates.push_back(make_pair(vh_outer, weights_vh_outer));
-	}
-}
-
-void ProgressiveMesh::computeDetailVectors(int desiredDetailLevel)
-{
-	// TODO remove duplication with restoreDetailVectors
-
-	while ( is_refinable() && currentVCount < desiredDetailLevel )	
-	{
-		// Clear coefficient and weight hash
-		clear_hashes();
-
-		// Add new vertex
-		PMInfoContainer::iterator iter = refine();
-
-		// Get the iterator of the new vertex		
-		PM::VertexHandle vh_new = iter->v0;
-		PM::VertexHandle vh_old = iter->v1;
-		PM::Vertex& vertex_new = mesh.vertex(vh_new);
-
-		// Compute vertex weights
-		VertexUpdateList vertexUpdates;
-		computeVertexWeights(vh_new, vertexUpdates);
-
-		// Compute local frame without using new vertex
-		coarsen();
-		Frame<PM> frame(mesh, vh_old);
-		refine();
-		
-		if (true) {
-			vertex_new.detailVectors.clear(); // Reset detail vectors
-		}
-
-		// Make sure to compute all new positions, before updating any of them
-		//typedef pair<PM::VertexHandle, PM::Point> PointUpdate;
-		//vector<PointUpdate> pointUpdates;
-
-		bool first = true;
-
-		// Save orig pos of vertex 0
-		PM::Point vertex_new_orig_pos = mesh.point(vertex_new);
-
-		vector<VertexUpdate>::iterator vit, vend = vertexUpdates.end();
-		for (vit = vertexUpdates.begin(); vit != vend; ++vit)
-		{
-			PM::VertexHandle vh = vit->first;
-			VertexWeights& weights = vit->second;
-
-			// Sum weights * neighbors
-			PM::Point q_n(0,0,0);
-			vector<VertexWeight>::iterator wit, wend = weights.end();
-			for (wit = weights.begin(); wit != wend; ++wit)
-			{
-				PM::VertexHandle q_k = wit->first;
-				PM::Scalar w = wit->second;
-				
-				q_n += w * mesh.point(q_k);
-				//cout << "w * q_k = " << w << " * " << mesh.point(q_k) << " = "
-				//	<< (w * mesh.point(q_k)) << ", " << endl;
-			}
-
-			// store detail vector
-			PM::Point new_dv = mesh.point(vh) - q_n;
-			PM::Point local_dv = frame.project(new_dv);
-			vertex_new.detailVectors.push_back(local_dv);
-
-			//cout << vh.idx() << ": q_n = " << q_n << ", local_dv = " << local_dv << endl;
-
-			if (first) {
-				// new vertex gets updated immediately,
-				// since 1-ring depends on its new position
-				mesh.set_point(vh, q_n);				
-				first = false;
-			}
-			
-			//pointUpdates.push_back(make_pair(vh, q_n));
-		}
-
-		// Restore orig pos
-		mesh.set_point(vh_new, vertex_new_orig_pos);		
-		
-		// Now, perform deferred updates
-		//vector<PointUpdate>::iterator pu_it, pu_end(pointUpdates.end());
-		//for (pu_it = pointUpdates.begin(); pu_it != pu_end; ++pu_it)
-		//{
-		//	mesh.set_point(pu_it->first, pu_it->second);
-		//}
-	}
-}
-
-void ProgressiveMesh::restoreDetailVectors(int desiredDetailLevel)
-{
-	Timer t;
-	cout << "Restoring detail vectors... ";	
-
-	while ( is_refinable() && currentVCount < desiredDetailLevel )	
-	{
-		// Clear coefficient and weight hash
-		clear_hashes();
-
-		// Add new vertex
-		PMInfoContainer::iterator iter = refine();
-
-		// Get the iterator of the new vertex		
-		PM::VertexHandle vh_new = iter->v0;
-		PM::VertexHandle vh_old = iter->v1;
-		PM::Vertex& vertex_new = mesh.vertex(vh_new);
-
-		if (vertex_new.detailVectors.empty()) {
-			// This level has no detail vectors -- we probably did not want to compute them
-			continue;
-		}
-
-		// Compute vertex weights, using original mesh points
-		vector<VertexUpdate> vertexUpdates;
-		computeVertexWeights(vh_new, vertexUpdates);
-
-		// Compute local frame without using new vertex
-		coarsen();
-		Frame<PM> frame(mesh, vh_old);
-		refine();
-
-		// Make sure to compute all new positions, before updating any of them
-		typedef pair<PM::VertexHandle, PM::Point> PointUpdate;
-		vector<PointUpdate> pointUpdates;
-		
-		bool first = true;
-
-		// Detail vectors are all stored on new vertex
-		vector<PM::Point>::iterator detailIter = vertex_new.detailVectors.begin();
-
-		// Relax vertices
-		vector<VertexUpdate>::iterator vit, vend = vertexUpdates.end();
-		for (vit = vertexUpdates.begin(); vit != vend; ++vit)
-		{
-			PM::VertexHandle vh = vit->first;
-			VertexWeights& weights = vit->second;
-			
-			// Sum weights * neighbors
-			PM::Point q_n(0,0,0);
-			vector<VertexWeight>::iterator wit, wend = weights.end();
-			for (wit = weights.begin(); wit != wend; ++wit)
-			{
-				PM::VertexHandle q_k = wit->first;
-				PM::Scalar w = wit->second;
-				
-				q_n += w * mesh.point(q_k);
-				//cout << "w * q_k = " << w << " * " << mesh.point(q_k) << " = "
-				//	<< (w * mesh.point(q_k)) << ", " << endl;
-			}
-
-			//cout << vh.idx() << ": q_n = " << q_n << ", local_dv = " << local_dv << endl;
-
-			assert(detailIter != vertex_new.detailVectors.end());
-			PM::Point dv = *(detailIter++);
-			PM::Point local_dv = frame.unproject(dv);
-			PM::Point relaxed_point = q_n;
-			PM::Point updated_point = relaxed_point + local_dv;
-
-			if (first) {
-				// New vertex gets updated immediately to relaxed position,
-				// since 1-ring depends on that new position
-				mesh.set_point(vh, relaxed_point);
-				first = false;
-			} 
-
-			// All vertices need to be updated to relaxed + detail
-			pointUpdates.push_back(make_pair(vh, updated_point));
-
-		}
-
-		// Now, perform deferred updates
-		vector<PointUpdate>::iterator pu_it, pu_end(pointUpdates.end());
-		for (pu_it = pointUpdates.begin(); pu_it != pu_end; ++pu_it)
-		{
-			mesh.set_point(pu_it->first, pu_it->second);
-		}	       
-	}
-
-	cout << "(" << t.get_elapsed() << "s)" << endl;
-}
-
-void ProgressiveMesh::stepComputeDetailVectors()
-{
-	computeDetailVectors(currentVCount-1);
-}
-
-void ProgressiveMesh::smooth()
-{
-	// Deprecated
-	coarsenToLevelN(0);
-
-	for (int i=vertexOrdering.size()/2; i < vertexOrdering.size(); i++)	
-	{
-		PM::VertexHandle vh = vertexOrdering[i];
-
-		PM::Vertex& vertex = mesh.vertex(vh);
-
-		for (int j=0; j < vertex.detailVectors.size(); j++)
-		{
-			vertex.detailVectors[j] *= 0.9f;
-		}
-	}
-
-	restoreDetailVectors(getMaxLevel());
+/*
+@file ProgressiveMesh.cpp
+*/
+
+#include <cassert>
+#include <algorithm>
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <map>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ProgressiveMesh.h"
+#include "MeshOp.h"
+#include "DividedDifference.h"
+#include "Frame.h"
+#include "VertexClustering.h"
+#include "StreamingDecimater.h"
+#include "PMFile.h"
+#include "PMStream.h"
+#include "PMCodec.h"
+
+// #pragma warning(disable: 4018)  // signed/unsigned mismatch
+
+using namespace std;
+
+// Debugging output
+void print_mesh(PM& mesh)
+{
+	for (PM::FaceIter f_it=mesh.faces_begin(); f_it!=mesh.faces_end(); ++f_it)
+	{
+		if (mesh.face(f_it.handle()).deleted())
+			continue;		
+		cout << "Face: ";
+		for (PM::FaceVertexIter fv_it=mesh.fv_iter(f_it.handle());fv_it;++fv_it)
+		{
+			cout << mesh.point(*fv_it) << ", ";			
+		}
+		cout << endl;
+	}
+}
+
+void print_vertexhandle(PM& mesh, PM::VertexHandle vh)
+{
+	if (vh.is_valid())
+	{
+		cout << mesh.point(vh);
+	}
+	else
+	{
+		cout << "(null)";
+	}
+}
+
+void print_pminfo(PM& mesh, Decimater::ProgMeshInfo pminfo)
+{
+	cout << "v0 = ";
+	print_vertexhandle(mesh, pminfo.v0);	
+
+	cout << "\nv1 = ";
+	print_vertexhandle(mesh, pminfo.v1);
+
+	cout << "\nvl = ";
+	print_vertexhandle(mesh, pminfo.vl);
+
+	cout << "\nvr = ";
+	print_vertexhandle(mesh, pminfo.vr);
+	cout << endl;
+}
+
+void print_frame(Frame<PM>& frame)
+{
+	cout << " [" << frame.T << ", " << frame.U << ", " << frame.V << "] ";
+}
+
+void ProgressiveMesh::computeBoundingBox()
+{
+	PM::VertexIter vit = mesh.vertices_begin(), vend = mesh.vertices_end();
+
+	if (vit == vend)
+	{
+		return;
+	}
+
+	PM::Point firstPoint = mesh.point(*vit);
+	bbox_min = bbox_max = firstPoint;
+
+	for ( ; vit != vend; ++vit)
+	{		
+		PM::Point p = mesh.point(*vit);
+		for (int i=0; i < 3; i++)
+		{
+			bbox_min[i] = min(bbox_min[i], p[i]);
+			bbox_max[i] = max(bbox_max[i], p[i]);
+		}
+	}
+}
+
+bool ProgressiveMesh::readFile(const char* filename)
+{
+	if (filename)
+	{
+		closeStream();
+		streamSplitsPending = 0;
+		endGeomorph();
+		mesh.clear();
+		details.clear();
+		replay.clear();
+		bands.clear();
+		clusterMap.clear();
+		clearCheckpoints();
+		hierarchy.clear();
+		splitActive.clear();
+
+		if (streamingBudget > 0 && strstr(filename, ".obj"))
+		{
+			// Simplify chunk by chunk within the budget; buildPM()
+			// finishes the coarse mesh
+			StreamingDecimater streaming(streamingBudget);
+			if (!streaming.simplify(filename, mesh)) return false;
+			streamingPeakRSS = streaming.getPeakRSS();
+		}
+		else if (clusteringTarget > 0 && strstr(filename, ".obj"))
+		{
+			// Read into flat arrays and cluster; the full PM is only
+			// built for the reduced mesh
+			VertexClustering clustering;
+			if (!clustering.readOBJ(filename)) return false;
+			clustering.cluster(clusteringTarget);
+			clustering.buildMesh(mesh);
+			clusterMap.swap(clustering.clusterMap);
+		}
+		else
+		{
+			OpenMesh::MeshIO::read_mesh(mesh, filename);
+		}
+
+		minVCount=maxVCount=currentVCount=mesh.n_vertices();
+
+		PM::VertexIter v_it = mesh.vertices_begin(), v_end = mesh.vertices_end();
+		
+		/*int boundaryCount = 0;
+		for ( ; v_it != v_end; ++v_it)
+		{
+			if (mesh.is_boundary(mesh.handle(*v_it))) boundaryCount++;
+		}
+
+		cout << boundaryCount << " vertices on the boundary." << endl;*/
+
+		int v = mesh.n_vertices();
+		int e = mesh.n_edges();
+		int f = mesh.n_faces();
+
+		int x = v - e + f;
+
+		cout << v << " vertices, " 
+			<< e << " edges, and " 
+			<< f << " faces loaded." <<endl;
+		cout << "X(G) = " << x << "\n" << endl;
+
+		computeBoundingBox();
+
+		// Compute face normals
+		mesh.update_face_normals();
+
+		// Clear weight cache, reserve enough empty entries
+		vertexWeightCache.clear();
+		vertexWeightCache = VertexUpdateListCache(v);
+
+		return true;
+	}
+	return false;
+}
+
+bool ProgressiveMesh::writeFile(const char* filename)
+{
+	endGeomorph();
+	endSelectiveRefinement();
+
+	if (filename)
+	{
+		if (strstr(filename, ".pmz"))
+			return writeCompressedPM(filename);
+		if (strstr(filename, ".pms"))
+			return writePMStream(filename);
+		if (strstr(filename, ".pm"))
+			return writePMFile(filename);
+
+		OpenMesh::MeshIO::write_mesh(mesh, filename);
+		return true;
+	}
+	return false;
+}
+
+// Return true iff PM is refinable
+bool ProgressiveMesh::is_refinable()
+{
+	// splits of a stream that have not arrived are at the front
+	return (pmIter - pmInfos.begin() > streamSplitsPending);
+}
+
+void ProgressiveMesh::refineToLevelN(int n)
+{
+	endGeomorph();
+	endSelectiveRefinement();
+
+	while (currentVCount < n && is_refinable())
+	{		
+		refine();
+	}
+}
+
+PMInfoContainer::iterator ProgressiveMesh::refine()
+{
+	assert(is_refinable());	
+	--pmIter;
+	
+	splitVertex(*pmIter);
+	++currentVCount;
+	return pmIter;
+}
+
+void ProgressiveMesh::splitVertex(Decimater::ProgMeshInfo& info)
+{
+	// keep the new halfedge v0 -> v1 for collapseVertex()
+	info.v0v1 = mesh.vertex_split(info.v0, info.v1, info.vl, info.vr);
+	mesh.vertex(info.v0).set_deleted(false);
+}
+
+// Return true iff PM is coarsenable
+bool ProgressiveMesh::is_coarsenable()
+{
+	return (pmIter != pmInfos.end());
+}
+
+PMInfoContainer::iterator ProgressiveMesh::coarsen()
+{
+	assert(is_coarsenable());
+
+	PMInfoContainer::iterator iter = pmIter;
+
+	collapseVertex(*pmIter);
+	--currentVCount;
+	++pmIter;
+
+	return iter;
+}
+
+void ProgressiveMesh::collapseVertex(Decimater::ProgMeshInfo& info)
+{
+	// the halfedge of the last split, unless a checkpoint restore or
+	// a reload has left it stale
+	PM::HalfedgeHandle hh = info.v0v1;
+	if (!hh.is_valid() || hh.idx() >= mesh.n_halfedges() ||
+		mesh.edge(mesh.edge_handle(hh)).deleted() ||
+		mesh.from_vertex_handle(hh) != info.v0 || mesh.to_vertex_handle(hh) != info.v1)
+	{
+		hh = mesh.find_halfedge(info.v0, info.v1);
+	}
+	mesh.collapse(hh);
+}
+
+void ProgressiveMesh::coarsenToLevelN(int n)
+{	
+	endGeomorph();
+	endSelectiveRefinement();
+
+	while (currentVCount > n && is_coarsenable())
+	{		
+		coarsen();
+	}
+}
+
+void ProgressiveMesh::jumpToLevelN(int n)
+{
+	endGeomorph();
+	endSelectiveRefinement();
+	n = max(minVCount, min(n, getAvailableLevel()));
+
+	if (checkpoints.empty() && checkpointInterval == 0 && 
+		(checkpointBudget > 0 || checkpointBytesPerVertex > 0))
+		buildCheckpoints();
+
+	if (!checkpoints.empty())
+	{
+		int i = min((n - minVCount) / checkpointInterval, int(checkpoints.size()) - 1);
+		const Checkpoint& checkpoint = checkpoints[i];
+
+		// a restore touches the whole mesh, worth it only for long jumps
+		if (abs(n - currentVCount) > n - checkpoint.level + checkpointInterval)
+			restoreCheckpoint(checkpoint);
+	}
+
+	if (n > currentVCount)
+		refineToLevelN(n);
+	else
+		coarsenToLevelN(n);
+}
+
+void ProgressiveMesh::buildCheckpoints()
+{
+	clearCheckpoints();
+
+	// not while splits are missing
+	if (streamSplitsPending > 0 || maxVCount <= minVCount) return;
+
+	// a triangle mesh has about 3 edges and 2 faces per vertex
+	size_t bytesPerVertex = sizeof(int) * (1 + 3*2*3 + 2) + 1 + 3 + 2;
+	size_t bytes = bytesPerVertex * mesh.n_vertices();
+	size_t budget = checkpointBudget + checkpointBytesPerVertex * mesh.n_vertices();
+	int count = budget / bytes;
+	if (count < 1)
+	{
+		cout << "No checkpoints: one takes " << bytes << " bytes, the budget is " 
+			<< budget << " bytes." << endl;
+		checkpointInterval = -1;
+		return;
+	}
+
+	Timer t;
+
+	int levels = maxVCount - minVCount;
+	checkpointInterval = max(1, (levels + count - 1) / count);
+
+	int level = currentVCount;
+	coarsenToLevelN(minVCount);
+
+	checkpoints.reserve(levels / checkpointInterval + 1);
+	for (int n = minVCount; n <= maxVCount; n += checkpointInterval)
+	{
+		refineToLevelN(n);
+		checkpoints.push_back(Checkpoint());
+		saveCheckpoint(checkpoints.back());
+	}
+
+	restoreCheckpoint(checkpoints[(level - minVCount) / checkpointInterval]);
+	refineToLevelN(level);
+
+	cout << checkpoints.size() << " checkpoints, every " << checkpointInterval 
+		<< " levels (" << t.get_elapsed() << "s)." << endl;
+}
+
+void ProgressiveMesh::saveCheckpoint(Checkpoint& checkpoint)
+{
+	int nv = mesh.n_vertices(), ne = mesh.n_edges(), nf = mesh.n_faces();
+
+	checkpoint.level = currentVCount;
+	checkpoint.pmIndex = pmIter - pmInfos.begin();
+	checkpoint.vertexHalfedges.resize(nv);
+	checkpoint.halfedges.resize(3 * 2*ne);
+	checkpoint.faceHalfedges.resize(nf);
+	checkpoint.deleted.resize(nv + ne + nf);
+
+	for (int i = 0; i < nv; i++)
+	{
+		PM::VertexHandle vh(i);
+		checkpoint.vertexHalfedges[i] = mesh.halfedge_handle(vh).idx();
+		checkpoint.deleted[i] = mesh.vertex(vh).deleted();
+	}
+
+	for (int i = 0; i < 2*ne; i++)
+	{
+		PM::HalfedgeHandle hh(i);
+		checkpoint.halfedges[3*i]   = mesh.next_halfedge_handle(hh).idx();
+		checkpoint.halfedges[3*i+1] = mesh.to_vertex_handle(hh).idx();
+		checkpoint.halfedges[3*i+2] = mesh.face_handle(hh).idx();
+	}
+
+	for (int i = 0; i < ne; i++)
+		checkpoint.deleted[nv + i] = mesh.edge(PM::EdgeHandle(i)).deleted();
+
+	for (int i = 0; i < nf; i++)
+	{
+		PM::FaceHandle fh(i);
+		checkpoint.faceHalfedges[i] = mesh.halfedge_handle(fh).idx();
+		checkpoint.deleted[nv + ne + i] = mesh.face(fh).deleted();
+	}
+}
+
+void ProgressiveMesh::restoreCheckpoint(const Checkpoint& checkpoint)
+{
+	int nv = checkpoint.vertexHalfedges.size();
+	int ne = checkpoint.halfedges.size() / (3*2);
+	int nf = checkpoint.faceHalfedges.size();
+
+	// drops the edges and faces splits have added since
+	mesh.resize(nv, ne, nf);
+
+	for (int i = 0; i < nv; i++)
+	{
+		PM::VertexHandle vh(i);
+		mesh.set_halfedge_handle(vh, PM::HalfedgeHandle(checkpoint.vertexHalfedges[i]));
+		mesh.vertex(vh).set_deleted(checkpoint.deleted[i] != 0);
+	}
+
+	for (int i = 0; i < 2*ne; i++)
+	{
+		PM::HalfedgeHandle hh(i);
+		mesh.set_next_halfedge_handle(hh, PM::HalfedgeHandle(checkpoint.halfedges[3*i]));
+		mesh.set_vertex_handle(hh, PM::VertexHandle(checkpoint.halfedges[3*i+1]));
+		mesh.set_face_handle(hh, PM::FaceHandle(checkpoint.halfedges[3*i+2]));
+	}
+
+	for (int i = 0; i < ne; i++)
+		mesh.edge(PM::EdgeHandle(i)).set_deleted(checkpoint.deleted[nv + i] != 0);
+
+	for (int i = 0; i < nf; i++)
+	{
+		PM::FaceHandle fh(i);
+		mesh.set_halfedge_handle(fh, PM::HalfedgeHandle(checkpoint.faceHalfedges[i]));
+		mesh.face(fh).set_deleted(checkpoint.deleted[nv + ne + i] != 0);
+	}
+
+	pmIter = pmInfos.begin() + checkpoint.pmIndex;
+	currentVCount = checkpoint.level;
+}
+
+// Split r of the hierarchy, in refinement order
+Decimater::ProgMeshInfo& ProgressiveMesh::splitInfo(int r)
+{
+	return pmInfos[pmInfos.size() - 1 - r];
+}
+
+void ProgressiveMesh::rankVertices()
+{
+	int n = mesh.n_vertices(), splits = pmInfos.size(), r;
+
+	vector<char> added(n, 0);
+	for (r = 0; r < splits; r++)
+		if (splitInfo(r).v0.is_valid()) added[splitInfo(r).v0.idx()] = 1;
+
+	vertexRank.assign(n, 0);
+	int next = 0;
+	for (int v = 0; v < n; v++)
+		if (!added[v]) vertexRank[v] = next++;
+
+	for (r = 0; r < splits; r++)
+		if (splitInfo(r).v0.is_valid()) vertexRank[splitInfo(r).v0.idx()] = next + r;
+}
+
+void ProgressiveMesh::buildVertexHierarchy()
+{
+	endSelectiveRefinement();
+	hierarchy.clear();
+
+	// not while splits are missing
+	if (streamSplitsPending > 0) return;
+
+	Timer t;
+
+	// replay all splits, recording the one-ring of every new vertex
+	int level = currentVCount;
+	coarsenToLevelN(minVCount);
+
+	hierarchy.begin(mesh.n_vertices());
+	vector<int> ring;
+
+	while (is_refinable())
+	{
+		PMInfoContainer::iterator info = refine();
+
+		ring.clear();
+		for (PM::VertexVertexIter vv_it = mesh.vv_iter(info->v0); vv_it; ++vv_it)
+			ring.push_back(vv_it.handle().idx());
+
+		hierarchy.addSplit(info->v0.idx(), info->v1.idx(), ring);
+	}
+
+	hierarchy.end();
+	jumpToLevelN(level);
+
+	cout << "Vertex hierarchy of " << hierarchy.getSplitCount() << " splits (" 
+		<< t.get_elapsed() << "s)." << endl;
+}
+
+int ProgressiveMesh::refineRegion(const Region& region, int maxVertices)
+{
+	if (!beginSelectiveRefinement()) return currentVCount;
+
+	// add the splits of vertices in the region, coarsest first, with what
+	// they depend on, as long as the budget lasts
+	int splitCount = hierarchy.getSplitCount();
+	int budget = (maxVertices > 0) ? maxVertices - currentVCount : splitCount;
+	if (budget <= 0) return currentVCount;
+
+	vector<char> target(splitActive);
+	vector<int> added;
+
+	for (int r = 0; r < splitCount; r++)
+	{
+		if (target[r] || !region.contains(mesh, splitInfo(r).v0)) continue;
+
+		int first = added.size();
+		hierarchy.markWithDependencies(r, target, added);
+
+		if (int(added.size()) > budget)
+		{
+			for (int i = first; i < added.size(); i++)
+				target[added[i]] = 0;
+			added.resize(first);
+		}
+	}
+
+	applySplits(target);
+	return currentVCount;
+}
+
+int ProgressiveMesh::coarsenRegion(const Region& region)
+{
+	if (!beginSelectiveRefinement()) return currentVCount;
+
+	// keep every split outside the region that keeps what it depends on
+	int splitCount = hierarchy.getSplitCount();
+	vector<char> target(splitCount, 0);
+
+	for (int r = 0; r < splitCount; r++)
+	{
+		if (!splitActive[r] || region.contains(mesh, splitInfo(r).v0)) continue;
+
+		bool keep = true;
+		for (const int* d = hierarchy.dependenciesBegin(r); d != hierarchy.dependenciesEnd(r); ++d)
+			if (!target[*d]) keep = false;
+
+		target[r] = keep;
+	}
+
+	applySplits(target);
+	return currentVCount;
+}
+
+bool ProgressiveMesh::beginSelectiveRefinement()
+{
+	if (streamSplitsPending > 0) return false;
+
+	endGeomorph();
+
+	if (hierarchy.empty())
+		buildVertexHierarchy();
+
+	if (splitActive.empty())
+	{
+		// the splits of the current level
+		splitActive.assign(hierarchy.getSplitCount(), 0);
+		for (int r = 0; r < currentVCount - minVCount; r++)
+			splitActive[r] = 1;
+	}
+
+	return true;
+}
+
+// Go from the active splits to those in target, which has to contain the
+// dependencies of its members
+void ProgressiveMesh::applySplits(const vector<char>& target)
+{
+	// finest first, so nothing active depends on a collapsed split
+	for (int r = splitActive.size() - 1; r >= 0; r--)
+	{
+		if (splitActive[r] && !target[r])
+		{
+			collapseVertex(splitInfo(r));
+			splitActive[r] = 0;
+			--currentVCount;
+		}
+	}
+
+	// coarsest first, so dependencies come before their splits
+	for (int r = 0; r < splitActive.size(); r++)
+	{
+		if (!splitActive[r] && target[r])
+		{
+			splitVertex(splitInfo(r));
+			splitActive[r] = 1;
+			++currentVCount;
+		}
+	}
+}
+
+void ProgressiveMesh::endSelectiveRefinement()
+{
+	if (splitActive.empty()) return;
+
+	// keep the splits up to the first inactive one, a level
+	int level = 0;
+	while (level < splitActive.size() && splitActive[level]) level++;
+
+	vector<char> target(splitActive.size(), 0);
+	for (int r = 0; r < level; r++)
+		target[r] = 1;
+	applySplits(target);
+
+	pmIter = pmInfos.end() - level;
+	splitActive.clear();
+}
+
+void ProgressiveMesh::buildGeomorph(int coarse, int fine)
+{
+	jumpToLevelN(fine);
+	coarse = max(minVCount, min(coarse, currentVCount));
+
+	// splits from the coarse level up, coarsest first: every vertex
+	// starts where its ancestor at the coarse level is
+	PMInfoContainer::iterator first = pmIter, it = pmIter + (currentVCount - coarse);
+	map<int, PM::VertexHandle> ancestors;
+
+	while (it != first)
+	{
+		--it;
+
+		map<int, PM::VertexHandle>::iterator a = ancestors.find(it->v1.idx());
+		PM::VertexHandle ancestor = (a != ancestors.end()) ? a->second : it->v1;
+		ancestors[it->v0.idx()] = ancestor;
+
+		geomorphVertices.push_back(it->v0);
+		geomorphStart.push_back(mesh.point(ancestor));
+		geomorphEnd.push_back(mesh.point(it->v0));
+	}
+}
+
+void ProgressiveMesh::setGeomorph(float t)
+{
+	t = max(0.0f, min(t, 1.0f));
+
+	int n = geomorphVertices.size();
+	for (int i = 0; i < n; i++)
+	{
+		const PM::Point& start = geomorphStart[i];
+		mesh.set_point(geomorphVertices[i], start + (geomorphEnd[i] - start) * t);
+	}
+}
+
+void ProgressiveMesh::endGeomorph()
+{
+	if (geomorphVertices.empty()) return;
+
+	int n = geomorphVertices.size();
+	for (int i = 0; i < n; i++)
+		mesh.set_point(geomorphVertices[i], geomorphEnd[i]);
+
+	geomorphVertices.clear();
+	geomorphStart.clear();
+	geomorphEnd.clear();
+}
+
+bool ProgressiveMesh::readPMFile(const char* filename)
+{
+	if (!filename) return false;
+
+	Timer t;
+
+	// the arrays are used straight from the mapped file
+	MappedFile file;
+	if (!file.open(filename)) return false;
+
+	const PMFileHeader& header = *file.at<PMFileHeader>(0);
+	if (!isLittleEndianHost() || !validatePMFile(header, file.getSize()))
+	{
+		cout << filename << " is not a version " << PM_FILE_VERSION << " .pm file." << endl;
+		return false;
+	}
+
+	int n = header.vertexCount;
+	const float* points = file.at<float>(header.pointsOffset);
+	const float* origPoints = file.at<float>(header.origPointsOffset);
+	const int* baseFaces = file.at<int>(header.baseFacesOffset);
+	const int* splits = file.at<int>(header.splitsOffset);
+	const int* ordering = file.at<int>(header.orderingOffset);
+	const PMFileUInt* detailOffsets = file.at<PMFileUInt>(header.detailOffsetsOffset);
+	const float* detailVectors = file.at<float>(header.detailVectorsOffset);
+
+	// indices must be in range before anything is built from them
+	for (int i = 0; i < header.baseFaceCount * 3; i++)
+		if (baseFaces[i] < 0 || baseFaces[i] >= n) return false;
+	for (int i = 0; i < header.splitCount * 4; i++)
+		if (splits[i] < -1 || splits[i] >= n || (i % 4 < 2 && splits[i] < 0)) return false;
+	for (int i = 0; i < header.orderingCount; i++)
+		if (ordering[i] < 0 || ordering[i] >= n) return false;
+	for (int i = 0; i < n; i++)
+		if (detailOffsets[i] > detailOffsets[i+1]) return false;
+	if (detailOffsets[n] != header.detailVectorCount) return false;
+
+	closeStream();
+	streamSplitsPending = 0;
+	endGeomorph();
+	mesh.clear();
+	pmInfos.clear();
+	details.clear();
+	replay.clear();
+	bands.clear();
+	clearCheckpoints();
+	hierarchy.clear();
+	splitActive.clear();
+	vertexOrdering.clear();
+	vertexRank.clear();
+	clusterMap.clear();
+
+	// all vertices, at full detail
+	for (int i = 0; i < n; i++)
+	{
+		PM::VertexHandle vh = mesh.add_vertex(PM::Point(points + 3*i));
+		mesh.vertex(vh).orig_point = PM::Point(origPoints + 3*i);
+	}
+
+	// base mesh
+	for (int f = 0; f < header.baseFaceCount; f++)
+	{
+		const int* v = baseFaces + 3*f;
+		mesh.add_face(PM::VertexHandle(v[0]), PM::VertexHandle(v[1]), PM::VertexHandle(v[2]));
+	}
+
+	// split records; their v0 are not in the base mesh yet
+	pmInfos.resize(header.splitCount);
+	for (int i = 0; i < header.splitCount; i++)
+	{
+		const int* split = splits + 4*i;
+		pmInfos[i].v0 = PM::VertexHandle(split[0]);
+		pmInfos[i].v1 = PM::VertexHandle(split[1]);
+		pmInfos[i].vl = PM::VertexHandle(split[2]);
+		pmInfos[i].vr = PM::VertexHandle(split[3]);
+
+		mesh.vertex(pmInfos[i].v0).set_deleted(true);
+	}
+
+	// the file has them by vertex, the store by split
+	vector<PM::Point> detail;
+	for (int r = 0; r < header.splitCount; r++)
+	{
+		int v0 = pmInfos[header.splitCount - 1 - r].v0.idx();
+		int first = detailOffsets[v0], count = detailOffsets[v0+1] - first;
+
+		detail.resize(count);
+		for (int d = 0; d < count; d++)
+			detail[d] = PM::Point(detailVectors + 3*(first + d));
+		details.write(r, count ? &detail[0] : NULL, count);
+	}
+
+	vertexOrdering.resize(header.orderingCount);
+	for (int i = 0; i < header.orderingCount; i++)
+		vertexOrdering[i] = PM::VertexHandle(ordering[i]);
+
+	pmIter = pmInfos.end();
+	maxVCount = n;
+	minVCount = currentVCount = header.baseVertexCount;
+
+	bbox_min = PM::Point(header.bboxMin);
+	bbox_max = PM::Point(header.bboxMax);
+
+	mesh.update_face_normals();
+
+	vertexWeightCache.clear();
+	vertexWeightCache = VertexUpdateListCache(n);
+
+	cout << n << " vertices (" << minVCount << " in the base mesh), "
+		<< header.splitCount << " splits loaded (" << t.get_elapsed() << "s)." << endl;
+
+	setDetailPrecision(detailPrecision);
+
+	return true;
+}
+
+// Write the hierarchy in the format of PMFile.h
+bool ProgressiveMesh::writePMFile(const char* filename)
+{
+	if (!filename || !isLittleEndianHost()) return false;
+
+	// no gaps: a stream being read has to arrive first
+	if (streamSplitsPending > 0) return false;
+
+	int n = mesh.n_vertices();
+
+	PMFileHeader header;
+	memset(&header, 0, sizeof(header));
+	header.vertexCount = n;
+	header.splitCount = pmInfos.size();
+	header.orderingCount = vertexOrdering.size();
+
+	// the file has the detail vectors by vertex
+	vector<int> vertexSplit(n, -1);
+	for (PMInfoContainer::iterator it = pmInfos.begin(); it != pmInfos.end(); ++it)
+		vertexSplit[it->v0.idx()] = splitIndex(it);
+
+	vector<float> points, origPoints, detailVectors;
+	vector<PMFileUInt> detailOffsets;
+	for (int i = 0; i < n; i++)
+	{
+		PM::VertexHandle vh(i);
+		PM::Vertex& vertex = mesh.vertex(vh);
+
+		points.insert(points.end(), &mesh.point(vh)[0], &mesh.point(vh)[0] + 3);
+		origPoints.insert(origPoints.end(), &vertex.orig_point[0], &vertex.orig_point[0] + 3);
+
+		detailOffsets.push_back(detailVectors.size() / 3);
+		DetailVectorStore::Span detail = details.get(vertexSplit[i]);
+		for (int d = 0; d < detail.size(); d++)
+		{
+			PM::Point dv = detail[d];
+			detailVectors.insert(detailVectors.end(), &dv[0], &dv[0] + 3);
+		}
+	}
+	detailOffsets.push_back(detailVectors.size() / 3);
+	header.detailVectorCount = detailVectors.size() / 3;
+
+	// base mesh: the faces at the coarsest level
+	int level = currentVCount;
+	coarsenToLevelN(minVCount);
+
+	vector<int> baseFaces;
+	for (PM::FaceIter f_it = mesh.faces_begin(); f_it != mesh.faces_end(); ++f_it)
+	{
+		if (mesh.face(f_it.handle()).deleted()) continue;
+
+		for (PM::FaceVertexIter fv_it = mesh.fv_iter(f_it.handle()); fv_it; ++fv_it)
+			baseFaces.push_back(fv_it.handle().idx());
+	}
+	header.baseVertexCount = currentVCount;
+	header.baseFaceCount = baseFaces.size() / 3;
+
+	refineToLevelN(level);
+
+	vector<int> splits;
+	for (PMInfoContainer::iterator it = pmInfos.begin(); it != pmInfos.end(); ++it)
+	{
+		splits.push_back(it->v0.idx());
+		splits.push_back(it->v1.idx());
+		splits.push_back(it->vl.idx());
+		splits.push_back(it->vr.idx());
+	}
+
+	vector<int> ordering;
+	for (int i = 0; i < vertexOrdering.size(); i++)
+		ordering.push_back(vertexOrdering[i].idx());
+
+	for (int k = 0; k < 3; k++)
+	{
+		header.bboxMin[k] = bbox_min[k];
+		header.bboxMax[k] = bbox_max[k];
+	}
+
+	layoutPMFile(header);
+
+	// sections in the order of the layout
+	FILE* file = fopen(filename, "wb");
+	if (!file) return false;
+
+	fwrite(&header, sizeof(header), 1, file);
+	if (!points.empty()) fwrite(&points[0], sizeof(float), points.size(), file);
+	if (!origPoints.empty()) fwrite(&origPoints[0], sizeof(float), origPoints.size(), file);
+	if (!baseFaces.empty()) fwrite(&baseFaces[0], sizeof(int), baseFaces.size(), file);
+	if (!splits.empty()) fwrite(&splits[0], sizeof(int), splits.size(), file);
+	if (!ordering.empty()) fwrite(&ordering[0], sizeof(int), ordering.size(), file);
+	fwrite(&detailOffsets[0], sizeof(PMFileUInt), detailOffsets.size(), file);
+	if (!detailVectors.empty()) fwrite(&detailVectors[0], sizeof(float), detailVectors.size(), file);
+
+	bool ok = (ftell(file) == long(header.fileSize));
+	fclose(file);
+
+	return ok;
+}
+
+// Write the hierarchy in the format of PMStream.h
+bool ProgressiveMesh::writePMStream(const char* filename)
+{
+	if (!filename || !isLittleEndianHost()) return false;
+
+	// no gaps: a stream being read has to arrive first
+	if (streamSplitsPending > 0) return false;
+
+	FILE* file = fopen(filename, "wb");
+	if (!file) return false;
+
+	// base mesh at the coarsest level
+	int level = currentVCount;
+	coarsenToLevelN(minVCount);
+
+	vector<PMStreamVertex> baseVertices;
+	for (PM::VertexIter v_it = mesh.vertices_begin(); v_it != mesh.vertices_end(); ++v_it)
+	{
+		if (mesh.vertex(v_it.handle()).deleted()) continue;
+
+		PMStreamVertex v;
+		v.index = v_it.handle().idx();
+		for (int k = 0; k < 3; k++) v.point[k] = mesh.point(v_it.handle())[k];
+		baseVertices.push_back(v);
+	}
+
+	vector<int> baseFaces;
+	for (PM::FaceIter f_it = mesh.faces_begin(); f_it != mesh.faces_end(); ++f_it)
+	{
+		if (mesh.face(f_it.handle()).deleted()) continue;
+
+		for (PM::FaceVertexIter fv_it = mesh.fv_iter(f_it.handle()); fv_it; ++fv_it)
+			baseFaces.push_back(fv_it.handle().idx());
+	}
+
+	refineToLevelN(level);
+
+	PMStreamHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, PM_STREAM_MAGIC, 4);
+	header.version = PM_STREAM_VERSION;
+	header.vertexCount = mesh.n_vertices();
+	header.baseVertexCount = baseVertices.size();
+	header.baseFaceCount = baseFaces.size() / 3;
+	header.splitCount = pmInfos.size();
+
+	fwrite(&header, sizeof(header), 1, file);
+	if (!baseVertices.empty()) fwrite(&baseVertices[0], sizeof(PMStreamVertex), baseVertices.size(), file);
+	if (!baseFaces.empty()) fwrite(&baseFaces[0], sizeof(int), baseFaces.size(), file);
+
+	// splits in refinement order, the reverse of the collapses
+	PMInfoContainer::reverse_iterator it, end = pmInfos.rend();
+	for (it = pmInfos.rbegin(); it != end; ++it)
+	{
+		PMStreamSplit split;
+		split.v0 = it->v0.idx();
+		split.v1 = it->v1.idx();
+		split.vl = it->vl.idx();
+		split.vr = it->vr.idx();
+		for (int k = 0; k < 3; k++) split.point[k] = mesh.point(it->v0)[k];
+
+		fwrite(&split, sizeof(split), 1, file);
+	}
+
+	bool ok = !ferror(file);
+	fclose(file);
+
+	return ok;
+}
+
+bool ProgressiveMesh::openStream(const char* filename)
+{
+	closeStream();
+
+	stream = new PMStreamReader;
+	if (!stream->open(filename))
+	{
+		closeStream();
+		return false;
+	}
+
+	endGeomorph();
+	mesh.clear();
+	pmInfos.clear();
+	details.clear();
+	replay.clear();
+	bands.clear();
+	clearCheckpoints();
+	hierarchy.clear();
+	splitActive.clear();
+	pmIter = pmInfos.end();
+	vertexOrdering.clear();
+	vertexRank.clear();
+	clusterMap.clear();
+	minVCount = maxVCount = currentVCount = 0;
+	streamSplitsPending = 0;
+	streamBaseDone = false;
+	streamState = STREAM_HEADER;
+	streamRead = 0;
+
+	pollStream();
+	return true;
+}
+
+void ProgressiveMesh::closeStream()
+{
+	delete stream;
+	stream = NULL;
+}
+
+bool ProgressiveMesh::pollStream(int maxSplits)
+{
+	if (!stream) return false;
+
+	bool progress = false;
+
+	if (streamState == STREAM_HEADER)
+	{
+		if (!readStreamHeader()) return false;
+		progress = true;
+	}
+
+	if (streamState == STREAM_BASE_VERTICES || streamState == STREAM_BASE_FACES)
+	{
+		if (!readStreamBase()) return progress;
+		progress = true;
+	}
+
+	if (readStreamSplits(maxSplits))
+		progress = true;
+
+	// all there
+	if (streamSplitsPending == 0)
+		closeStream();
+
+	return progress;
+}
+
+bool ProgressiveMesh::readStreamHeader()
+{
+	PMStreamHeader header;
+	if (!stream->read(&header, sizeof(header))) return false;
+
+	if (!isLittleEndianHost() || !validatePMStream(header))
+	{
+		cout << "Not a version " << PM_STREAM_VERSION << " .pms stream, or corrupt." << endl;
+		closeStream();
+		return false;
+	}
+
+	// every vertex exists from the start; those of pending splits are
+	// isolated and deleted, as after buildPM()
+	for (int i = 0; i < header.vertexCount; i++)
+		mesh.vertex(mesh.add_vertex(PM::Point(0, 0, 0))).set_deleted(true);
+
+	pmInfos.resize(header.splitCount);
+	pmIter = pmInfos.end();
+	streamSplitsPending = header.splitCount;
+
+	maxVCount = header.baseVertexCount + header.splitCount;
+	minVCount = currentVCount = header.baseVertexCount;
+
+	vertexWeightCache.clear();
+	vertexWeightCache = VertexUpdateListCache(header.vertexCount);
+
+	streamBaseVertexCount = header.baseVertexCount;
+	streamBaseFaceCount = header.baseFaceCount;
+	streamState = STREAM_BASE_VERTICES;
+	streamRead = 0;
+	return true;
+}
+
+// Returns true once the whole base mesh is there
+bool ProgressiveMesh::readStreamBase()
+{
+	int n = mesh.n_vertices();
+
+	while (streamState == STREAM_BASE_VERTICES && streamRead < streamBaseVertexCount)
+	{
+		PMStreamVertex v;
+		if (!stream->read(&v, sizeof(v))) return false;
+
+		if (v.index < 0 || v.index >= n)
+		{
+			closeStream();
+			return false;
+		}
+
+		PM::VertexHandle vh(v.index);
+		mesh.set_point(vh, PM::Point(v.point));
+		mesh.vertex(vh).orig_point = mesh.point(vh);
+		mesh.vertex(vh).set_deleted(false);
+
+		// bounding box of the base mesh; splits only add detail
+		if (streamRead == 0) bbox_min = bbox_max = mesh.point(vh);
+		for (int k = 0; k < 3; k++)
+		{
+			bbox_min[k] = min(bbox_min[k], v.point[k]);
+			bbox_max[k] = max(bbox_max[k], v.point[k]);
+		}
+
+		streamRead++;
+	}
+
+	if (streamState == STREAM_BASE_VERTICES)
+	{
+		streamState = STREAM_BASE_FACES;
+		streamRead = 0;
+	}
+
+	while (streamRead < streamBaseFaceCount)
+	{
+		int f[3];
+		if (!stream->read(f, sizeof(f))) return false;
+
+		for (int k = 0; k < 3; k++)
+		{
+			if (f[k] < 0 || f[k] >= n)
+			{
+				closeStream();
+				return false;
+			}
+		}
+
+		mesh.add_face(PM::VertexHandle(f[0]), PM::VertexHandle(f[1]), PM::VertexHandle(f[2]));
+		streamRead++;
+	}
+
+	mesh.update_face_normals();
+
+	cout << mesh.n_faces() << " faces of the base mesh streamed." << endl;
+
+	streamBaseDone = true;
+	streamState = STREAM_SPLITS;
+	streamRead = 0;
+	return true;
+}
+
+// Splits arrive coarsest first, so they fill pmInfos from the back
+bool ProgressiveMesh::readStreamSplits(int maxSplits)
+{
+	int n = mesh.n_vertices();
+	int count = 0;
+
+	while (streamSplitsPending > 0 && count < maxSplits)
+	{
+		PMStreamSplit split;
+		if (!stream->read(&split, sizeof(split))) break;
+
+		if (split.v0 < 0 || split.v0 >= n || split.v1 < 0 || split.v1 >= n ||
+			split.vl < -1 || split.vl >= n || split.vr < -1 || split.vr >= n)
+		{
+			closeStream();
+			break;
+		}
+
+		Decimater::ProgMeshInfo& info = pmInfos[--streamSplitsPending];
+		info.v0 = PM::VertexHandle(split.v0);
+		info.v1 = PM::VertexHandle(split.v1);
+		info.vl = PM::VertexHandle(split.vl);
+		info.vr = PM::VertexHandle(split.vr);
+
+		mesh.set_point(info.v0, PM::Point(split.point));
+		mesh.vertex(info.v0).orig_point = mesh.point(info.v0);
+
+		count++;
+	}
+
+	return count > 0;
+}
+
+// Models of the .pmz payload, used in the same order for writing and
+// reading
+struct PMZModels
+{
+	IntModel point[3];
+	IntModel faceFirst, faceOther;
+	IntModel v1;
+	BitModel vlValid, vrValid;
+	IntModel vl, vr;
+	IntModel split[3];
+	IntModel detailCount;
+	IntModel detail[3];
+};
+
+// Bits per coordinate of the .pmz quantization grid
+static const int PMZ_QUANT_BITS = 16;
+
+// One-ring of v, starting at the neighbor with the smallest index (new
+// index through index, or the handle index if NULL), so the order does
+// not depend on the halfedge the iterator starts at
+static void canonical_ring(PM& mesh, PM::VertexHandle v, const vector<int>* index,
+						   vector<PM::VertexHandle>& ring)
+{
+	ring.clear();
+	int first = 0, smallest = INT_MAX;
+
+	for (PM::VertexVertexIter vv_it = mesh.vv_iter(v); vv_it; ++vv_it)
+	{
+		int i = index ? (*index)[vv_it.handle().idx()] : vv_it.handle().idx();
+		if (i < smallest)
+		{
+			smallest = i;
+			first = ring.size();
+		}
+		ring.push_back(vv_it.handle());
+	}
+
+	rotate(ring.begin(), ring.begin() + first, ring.end());
+}
+
+static int quantize(float x, float origin, float step)
+{
+	return int(floor((x - origin) / step + 0.5f));
+}
+
+// Position of vh in ring, ring.size() if it is not there
+static int ring_position(const vector<PM::VertexHandle>& ring, PM::VertexHandle vh)
+{
+	return find(ring.begin(), ring.end(), vh) - ring.begin();
+}
+
+// Write the hierarchy in the format of PMCodec.h
+bool ProgressiveMesh::writeCompressedPM(const char* filename)
+{
+	if (!filename || !isLittleEndianHost()) return false;
+
+	// no gaps: a stream being read has to arrive first
+	if (streamSplitsPending > 0) return false;
+
+	Timer t;
+
+	int level = currentVCount;
+	coarsenToLevelN(minVCount);
+
+	// renumber: base vertices, then v0 of every split in refinement order,
+	// the order of rankVertices()
+	vector<int> newIndex(mesh.n_vertices(), -1);
+	vector<PM::VertexHandle> vertices;
+
+	for (PM::VertexIter v_it = mesh.vertices_begin(); v_it != mesh.vertices_end(); ++v_it)
+	{
+		if (mesh.vertex(v_it.handle()).deleted()) continue;
+		newIndex[v_it.handle().idx()] = vertices.size();
+		vertices.push_back(v_it.handle());
+	}
+	int baseCount = vertices.size();
+
+	PMInfoContainer::reverse_iterator it, end = pmInfos.rend();
+	for (it = pmInfos.rbegin(); it != end; ++it)
+	{
+		newIndex[it->v0.idx()] = vertices.size();
+		vertices.push_back(it->v0);
+	}
+
+	if (vertices.empty())
+	{
+		refineToLevelN(level);
+		return false;
+	}
+
+	// quantization grid over all points
+	PM::Point pmin = mesh.point(vertices[0]), pmax = pmin;
+	for (int i = 0; i < vertices.size(); i++)
+	{
+		for (int k = 0; k < 3; k++)
+		{
+			pmin[k] = min(pmin[k], mesh.point(vertices[i])[k]);
+			pmax[k] = max(pmax[k], mesh.point(vertices[i])[k]);
+		}
+	}
+	float longest = max(pmax[0] - pmin[0], max(pmax[1] - pmin[1], pmax[2] - pmin[2]));
+	if (longest <= 0.0f) longest = 1.0f;
+
+	PMZHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, PMZ_FILE_MAGIC, 4);
+	header.version = PMZ_FILE_VERSION;
+	header.baseVertexCount = baseCount;
+	header.splitCount = pmInfos.size();
+	for (int k = 0; k < 3; k++) header.bboxMin[k] = pmin[k];
+	header.step = longest / float((1 << PMZ_QUANT_BITS) - 1);
+	header.detailStep = header.step;
+
+	vector<int> q(3 * vertices.size());
+	for (int i = 0; i < vertices.size(); i++)
+		for (int k = 0; k < 3; k++)
+			q[3*i+k] = quantize(mesh.point(vertices[i])[k], header.bboxMin[k], header.step);
+
+	vector<unsigned char> payload;
+	RangeEncoder rc(payload);
+	PMZModels models;
+
+	// base mesh: points as deltas to the previous one
+	for (int i = 0; i < baseCount; i++)
+		for (int k = 0; k < 3; k++)
+			models.point[k].encodeSigned(rc, q[3*i+k] - (i ? q[3*(i-1)+k] : 0));
+
+	vector<int> faces;
+	for (PM::FaceIter f_it = mesh.faces_begin(); f_it != mesh.faces_end(); ++f_it)
+	{
+		if (mesh.face(f_it.handle()).deleted()) continue;
+
+		for (PM::FaceVertexIter fv_it = mesh.fv_iter(f_it.handle()); fv_it; ++fv_it)
+			faces.push_back(newIndex[fv_it.handle().idx()]);
+	}
+	header.baseFaceCount = faces.size() / 3;
+
+	// faces: first vertex as delta to the last face's, the others to it
+	for (int f = 0; f < faces.size(); f += 3)
+	{
+		models.faceFirst.encodeSigned(rc, faces[f] - (f ? faces[f-3] : 0));
+		models.faceOther.encodeSigned(rc, faces[f+1] - faces[f]);
+		models.faceOther.encodeSigned(rc, faces[f+2] - faces[f]);
+	}
+
+	// splits, refining as the decoder will
+	vector<PM::VertexHandle> ring;
+	int lastV1 = 0;
+	bool ok = true;
+
+	while (is_refinable())
+	{
+		PMInfoContainer::iterator info = pmIter - 1;
+		int v0 = newIndex[info->v0.idx()], v1 = newIndex[info->v1.idx()];
+
+		models.v1.encodeSigned(rc, v1 - lastV1);
+		lastV1 = v1;
+
+		canonical_ring(mesh, info->v1, &newIndex, ring);
+		int l = ring_position(ring, info->vl), r = ring_position(ring, info->vr);
+		if ((info->vl.is_valid() && l == ring.size()) || (info->vr.is_valid() && r == ring.size()))
+		{
+			// finest level, as after the last split
+			ok = false;
+			refineToLevelN(maxVCount);
+			break;
+		}
+
+		rc.encode(models.vlValid, info->vl.is_valid());
+		if (info->vl.is_valid())
+			models.vl.encode(rc, l);
+
+		// vr usually follows vl closely
+		rc.encode(models.vrValid, info->vr.is_valid());
+		if (info->vr.is_valid())
+			models.vr.encode(rc, info->vl.is_valid() ? (r - l + ring.size()) % ring.size() : r);
+
+		for (int k = 0; k < 3; k++)
+			models.split[k].encodeSigned(rc, q[3*v0+k] - q[3*v1+k]);
+
+		DetailVectorStore::Span detail = details.get(splitIndex(info));
+		models.detailCount.encode(rc, detail.size());
+		for (int d = 0; d < detail.size(); d++)
+			for (int k = 0; k < 3; k++)
+				models.detail[k].encodeSigned(rc, quantize(detail[d][k], 0.0f, header.detailStep));
+
+		refine();
+	}
+
+	rc.flush();
+	header.payloadSize = payload.size();
+
+	coarsenToLevelN(level);
+
+	if (!ok) return false;
+
+	FILE* file = fopen(filename, "wb");
+	if (!file) return false;
+
+	fwrite(&header, sizeof(header), 1, file);
+	if (!payload.empty()) fwrite(&payload[0], 1, payload.size(), file);
+
+	ok = !ferror(file);
+	fclose(file);
+
+	cout << header.splitCount << " splits compressed to " << payload.size() << " bytes ("
+		<< (header.splitCount ? float(payload.size()) / header.splitCount : 0.0f)
+		<< " bytes per split, " << t.get_elapsed() << "s)." << endl;
+
+	return ok;
+}
+
+// Read a file written by writeCompressedPM(). The mesh is refined while
+// decoding and ends up at full detail.
+bool ProgressiveMesh::readCompressedPM(const char* filename)
+{
+	if (!filename || !isLittleEndianHost()) return false;
+
+	Timer t;
+
+	MappedFile file;
+	if (!file.open(filename)) return false;
+
+	if (file.getSize() < sizeof(PMZHeader)) return false;
+	const PMZHeader& header = *file.at<PMZHeader>(0);
+
+	if (memcmp(header.magic, PMZ_FILE_MAGIC, 4) != 0 || header.version != PMZ_FILE_VERSION ||
+		header.payloadSize > file.getSize() - sizeof(PMZHeader) || !(header.step > 0.0f) ||
+		header.baseVertexCount > (1 << 28) || header.splitCount > (1 << 28) - header.baseVertexCount ||
+		header.baseFaceCount > (1 << 28))
+	{
+		cout << filename << " is not a version " << PMZ_FILE_VERSION << " .pmz file." << endl;
+		return false;
+	}
+
+	closeStream();
+	streamSplitsPending = 0;
+	endGeomorph();
+	mesh.clear();
+	pmInfos.clear();
+	details.clear();
+	replay.clear();
+	bands.clear();
+	clearCheckpoints();
+	hierarchy.clear();
+	splitActive.clear();
+	vertexOrdering.clear();
+	vertexRank.clear();
+	clusterMap.clear();
+
+	RangeDecoder rc(file.at<unsigned char>(sizeof(PMZHeader)), header.payloadSize);
+	PMZModels models;
+
+	int baseCount = header.baseVertexCount;
+	int splitCount = header.splitCount;
+	int n = baseCount + splitCount;
+
+	// all vertices; those of the splits wait, deleted, until their split
+	for (int i = 0; i < n; i++)
+	{
+		PM::VertexHandle vh = mesh.add_vertex(PM::Point(0, 0, 0));
+		if (i >= baseCount) mesh.vertex(vh).set_deleted(true);
+	}
+
+	vector<int> q(3 * n);
+	for (int i = 0; i < baseCount; i++)
+	{
+		for (int k = 0; k < 3; k++)
+			q[3*i+k] = (i ? q[3*(i-1)+k] : 0) + models.point[k].decodeSigned(rc);
+
+		mesh.set_point(PM::VertexHandle(i), PM::Point(
+			header.bboxMin[0] + header.step * q[3*i],
+			header.bboxMin[1] + header.step * q[3*i+1],
+			header.bboxMin[2] + header.step * q[3*i+2]));
+	}
+
+	bool ok = true;
+
+	int last = 0;
+	for (int f = 0; f < header.baseFaceCount && ok; f++)
+	{
+		int v[3];
+		v[0] = last + models.faceFirst.decodeSigned(rc);
+		v[1] = v[0] + models.faceOther.decodeSigned(rc);
+		v[2] = v[0] + models.faceOther.decodeSigned(rc);
+		last = v[0];
+
+		for (int k = 0; k < 3; k++)
+			if (v[k] < 0 || v[k] >= baseCount) ok = false;
+
+		if (ok)
+			mesh.add_face(PM::VertexHandle(v[0]), PM::VertexHandle(v[1]), PM::VertexHandle(v[2]));
+	}
+
+	// splits: decode and refine
+	pmInfos.resize(splitCount);
+	vector<PM::VertexHandle> ring;
+	vector<PM::Point> detail;
+	int lastV1 = 0;
+
+	for (int s = 0; s < splitCount && ok; s++)
+	{
+		int v0 = baseCount + s;
+		int v1 = lastV1 + models.v1.decodeSigned(rc);
+		lastV1 = v1;
+
+		if (v1 < 0 || v1 >= v0)
+		{
+			ok = false;
+			break;
+		}
+
+		canonical_ring(mesh, PM::VertexHandle(v1), NULL, ring);
+		int size = ring.size();
+
+		Decimater::ProgMeshInfo& info = pmInfos[splitCount - 1 - s];
+		info.v0 = PM::VertexHandle(v0);
+		info.v1 = PM::VertexHandle(v1);
+		info.vl = info.vr = PM::VertexHandle();
+
+		int l = -1;
+		if (rc.decode(models.vlValid))
+		{
+			l = models.vl.decode(rc);
+			if (l >= size) { ok = false; break; }
+			info.vl = ring[l];
+		}
+
+		if (rc.decode(models.vrValid))
+		{
+			int r = models.vr.decode(rc);
+			if (r >= size) { ok = false; break; }
+			info.vr = ring[(l >= 0) ? (l + r) % size : r];
+		}
+
+		for (int k = 0; k < 3; k++)
+			q[3*v0+k] = q[3*v1+k] + models.split[k].decodeSigned(rc);
+
+		mesh.set_point(info.v0, PM::Point(
+			header.bboxMin[0] + header.step * q[3*v0],
+			header.bboxMin[1] + header.step * q[3*v0+1],
+			header.bboxMin[2] + header.step * q[3*v0+2]));
+
+		unsigned int count = models.detailCount.decode(rc);
+		if (count > (1 << 16) || rc.overrun())
+		{
+			ok = false;
+			break;
+		}
+
+		detail.resize(count);
+		for (int d = 0; d < count; d++)
+			for (int k = 0; k < 3; k++)
+				detail[d][k] = header.detailStep * models.detail[k].decodeSigned(rc);
+		details.write(s, count ? &detail[0] : NULL, count);
+
+		info.v0v1 = mesh.vertex_split(info.v0, info.v1, info.vl, info.vr);
+		mesh.vertex(info.v0).set_deleted(false);
+	}
+
+	if (!ok || rc.overrun())
+	{
+		cout << filename << " is corrupt." << endl;
+		mesh.clear();
+		pmInfos.clear();
+		details.clear();
+		replay.clear();
+		bands.clear();
+		pmIter = pmInfos.end();
+		minVCount = maxVCount = currentVCount = 0;
+		return false;
+	}
+
+	for (int i = 0; i < n; i++)
+	{
+		PM::VertexHandle vh(i);
+		mesh.vertex(vh).orig_point = mesh.point(vh);
+	}
+
+	// refinement order
+	for (int i = baseCount; i < n; i++)
+		vertexOrdering.push_back(PM::VertexHandle(i));
+
+	pmIter = pmInfos.begin();
+	minVCount = baseCount;
+	maxVCount = currentVCount = n;
+
+	computeBoundingBox();
+	mesh.update_face_normals();
+
+	vertexWeightCache.clear();
+	vertexWeightCache = VertexUpdateListCache(n);
+
+	cout << n << " vertices (" << baseCount << " in the base mesh), " << splitCount
+		<< " splits decoded (" << t.get_elapsed() << "s)." << endl;
+
+	setDetailPrecision(detailPrecision);
+
+	return true;
+}
+
+void ProgressiveMesh::buildPM()
+{
+	if (mesh.n_vertices() == 0) return;
+
+	Timer t;
+	cout << "Decimating... ";
+
+	endGeomorph();
+	endSelectiveRefinement();
+
+	// garbage collect
+	mesh.garbage_collection();
+
+	// copy points to orig_point
+	store_original_mesh(mesh);
+	details.clear();
+	replay.clear();
+	bands.clear();
+	clearCheckpoints();
+	hierarchy.clear();
+
+	// 1. create decimating instance
+	Decimater decimater(mesh);
+	
+	// 2. register modules
+	Quadrics modQuadric(mesh);
+	// face quadrics are summed on all cores, same result as serial
+	modQuadric.set_parallel_initialize(true);
+	// clear up of these modules are in decimater
+	decimater.registrate(modQuadric);
+
+	// 3. initialize setup
+	decimater.initialize();
+	decimater.generate_progmesh_info(&pmInfos);	
+#if defined(_OPENMP)
+	// collapse independent sets on all cores
+	decimater.parallel_independent_sets(true);
+#endif
+	// quadric priorities only depend on the edge endpoints
+	decimater.cache_priorities(true);
+	// the caller may stop us early
+	decimater.set_observer(decimationObserver);
+	decimater.set_time_budget(decimationBudget);
+	decimater.set_cancel_flag(decimationCancel);
+
+	Quadrics* quadrics = static_cast<Quadrics*>(decimater.priority_module());
+	cout << "(quadrics " << quadrics->initialize_time() << "s) ";
+
+	// 4. simplify as much as possible
+	int numVertexDecimated = decimater.decimate();
+	decimationInterrupted = decimater.was_interrupted();
+	if (decimationInterrupted)
+		cout << "(stopped early after " << numVertexDecimated << " collapses) ";
+
+	const Decimater::Statistics& stats = decimater.statistics();
+	cout << "(priorities " << stats.n_priority_evals << " evaluated, " 
+		<< stats.n_priority_cached << " cached; legality " 
+		<< stats.n_legality_evals << " evaluated, " 
+		<< stats.n_legality_cached << " cached) ";
+
+	// update information
+	currentVCount = minVCount = maxVCount - numVertexDecimated;
+
+	pmIter = pmInfos.end();
+	
+	cout << "(" << t.get_elapsed() << "s)" << endl;
+
+	// TODO how to we choose this?
+	int minDetailLevel = maxVCount / 100;
+	refineToLevelN(minDetailLevel);
+
+	// compute
+	t.reset();
+	cout << "Computing detail vectors... ";
+	computeDetailVectors(maxVCount);	
+	cout << "(" << t.get_elapsed() << "s)\n" << endl;
+
+	// store ordering of vertices
+	vertexOrdering.clear();
+	PMInfoContainer::reverse_iterator pit = pmInfos.rbegin(), pend = pmInfos.rend();
+	for ( ; pit != pend; ++pit)
+	{
+		vertexOrdering.push_back(pit->v0);
+	}
+
+	// computed at full precision, compacted now if asked for
+	setDetailPrecision(detailPrecision);
+}
+
+void ProgressiveMesh::computeVertexWeights(
+	PM::VertexHandle vh_n, VertexUpdateList& vertexUpdates)
+{
+	computeVertexWeights(vh_n, vertexUpdates, g_hashes);
+}
+
+void ProgressiveMesh::computeVertexWeights(
+	PM::VertexHandle vh_n, VertexUpdateList& vertexUpdates, DividedDifferenceCache& cache)
+{
+	// mannequin.obj:    Filtering w/o cache = 1.7s, w/cache = 0.04s
+	// manifold-cow.obj: Filtering w/o cache = 7.2s, w/cache = 0.2s
+
+	bool cacheWeights = true;
+
+	if (cacheWeights) {
+		// Make sure cache is large enough to hold vh_n data
+		int index = vh_n.idx();
+		assert(index >= 0);
+		VertexUpdateList empty;
+		while (vertexWeightCache.size() < index+1) {
+			vertexWeightCache.push_back(empty);
+		}
+
+		// In cache?
+		vertexUpdates = vertexWeightCache[index];
+		
+		// If not, compute
+		if (vertexUpdates.size() == 0) {			
+			computeVertexWeights_calc(vh_n, vertexUpdates, cache);
+
+			// Cache
+			vertexWeightCache[index] = vertexUpdates;
+		}		
+	} else {
+		return computeVertexWeights_calc(vh_n, vertexUpdates, cache);
+	}
+}
+
+// Compute relaxation weights for a vertex vh_n and its 1-ring neighbors
+void ProgressiveMesh::computeVertexWeights_calc(
+	PM::VertexHandle vh_n, VertexUpdateList& vertexUpdates, DividedDifferenceCache& cache)
+{
+	typedef std::vector<PM::VertexHandle> VertexHandles;
+	VertexHandles vertices = findTwoRingNeighborhood(mesh, vh_n);
+
+	VertexWeights weights_vh_n;
+	
+	for (int i=0; i<vertices.size(); i++) 
+	{
+		// Relax new mesh, using weights from original mesh		
+		PM::Scalar weight = weight_ij(mesh, vh_n, vertices[i], cache);		
+		weights_vh_n.push_back(make_pair(vertices[i], weight));
+	}	
+
+	// Store weights that we will use to update vh_n
+	vertexUpdates.push_back(make_pair(vh_n,weights_vh_n));
+
+	// Now relax one-ring neighborhood 
+	PM::VertexVertexIter vv_it= mesh.vv_iter(vh_n);
+	for ( ; vv_it; ++vv_it)
+	{
+		VertexWeights weights_vh_outer;
+
+		// Get vertex handle of vertex on 1-ring neighborhood
+		PM::VertexHandle vh_outer = vv_it.handle();
+
+		// Get the V2 neighbors and compute the updated position
+		VertexHandles v2_vertices = findTwoRingNeighborhood(mesh, vh_outer);
+		
+		// Loop over the V2 neighborhood of vh_outer
+		VertexHandles::iterator hand_it, hand_end = v2_vertices.end();
+		for (hand_it = v2_vertices.begin(); hand_it != hand_end; ++hand_it) 
+		{
+			PM::VertexHandle v2_neighbor = *hand_it;
+			if (v2_neighbor == vh_n) continue;
+
+			PM::Scalar weight = weight_ij(mesh, vh_outer, v2_neighbor, cache);			
+			weights_vh_outer.push_back(make_pair(v2_neighbor, weight));			
+		}
+
+		// Sum up the last term (w_j_n * q_n)
+		PM::Scalar w_j_n = weight_ij(mesh, vh_outer, vh_n, cache);		
+		weights_vh_outer.push_back(make_pair(vh_n, w_j_n));
+
+		// Store weights that we will use to update vh_outer		
+		vertexUpdates.push_back(make_pair(vh_outer, weights_vh_outer));
+	}
+}
+
+void ProgressiveMesh::computeDetailVectors(int desiredDetailLevel)
+{
+	endGeomorph();
+	endSelectiveRefinement();
+
+	// splits may get detail vectors they didn't have
+	replay.clear();
+	bands.clear();
+
+	rankVertices();
+
+	if (parallelDetailVectors)
+	{
+		computeDetailVectorsParallel(desiredDetailLevel);
+		return;
+	}
+
+	// TODO remove duplication with restoreDetailVectors
+
+	vector<PM::Point> detail;
+
+	while ( is_refinable() && currentVCount < desiredDetailLevel )	
+	{
+		// Clear coefficient and weight hash
+		clear_hashes();
+
+		// Compute local frame without using new vertex, while the mesh
+		// is still at the level of the split
+		Frame<PM> frame(mesh, (pmIter-1)->v1, &vertexRank);
+
+		// Add new vertex
+		PMInfoContainer::iterator iter = refine();
+
+		// Get the iterator of the new vertex		
+		PM::VertexHandle vh_new = iter->v0;
+		int r = splitIndex(iter);
+
+		// Compute vertex weights
+		VertexUpdateList vertexUpdates;
+		computeVertexWeights(vh_new, vertexUpdates);
+		
+		// One detail vector per updated vertex, all stored on the split
+		computeSplitDetail(vertexUpdates, frame, detail);
+		details.write(r, &detail[0], detail.size());
+	}
+}
+
+void ProgressiveMesh::computeSplitDetail(
+	const VertexUpdateList& vertexUpdates, Frame<PM>& frame, vector<PM::Point>& detail)
+{
+	detail.clear();
+	if (vertexUpdates.empty()) return;
+
+	// The new vertex moves to its relaxed position after the first
+	// update, since its 1-ring depends on it; the mesh is left alone.
+	PM::VertexHandle vh_new = vertexUpdates[0].first;
+	PM::Point vertex_new_pos = mesh.point(vh_new);
+
+	bool first = true;
+
+	VertexUpdateList::const_iterator vit, vend = vertexUpdates.end();
+	for (vit = vertexUpdates.begin(); vit != vend; ++vit)
+	{
+		PM::VertexHandle vh = vit->first;
+		const VertexWeights& weights = vit->second;
+
+		// Sum weights * neighbors
+		PM::Point q_n(0,0,0);
+		VertexWeights::const_iterator wit, wend = weights.end();
+		for (wit = weights.begin(); wit != wend; ++wit)
+		{
+			PM::VertexHandle q_k = wit->first;
+			PM::Scalar w = wit->second;
+			
+			q_n += w * (q_k == vh_new ? vertex_new_pos : mesh.point(q_k));
+		}
+
+		// store detail vector
+		PM::Point new_dv = (vh == vh_new ? vertex_new_pos : mesh.point(vh)) - q_n;
+		PM::Point local_dv = frame.project(new_dv);
+		detail.push_back(local_dv);
+
+		if (first) {
+			vertex_new_pos = q_n;
+			first = false;
+		}
+	}
+}
+
+// A run of splits from first on whose detail vectors can be computed
+// at the same time; returns the split after it. Computing one needs the
+// mesh within 4 rings of its v1 (the weights of the 1-ring of v0 look 2
+// rings further, plus the diamonds of those edges), and splitting only
+// changes the 1-ring of v1, so a run whose 4-rings around v1 don't
+// overlap doesn't see its own splits.
+int ProgressiveMesh::nextDetailBatch(int first, int last, vector<int>& owner, vector<int>& visited, int& stampValue)
+{
+	const int maxBatch = 256, ringDepth = 4;
+
+	int batch = ++stampValue;
+	vector<PM::VertexHandle> ring;
+
+	int r;
+	for (r = first; r < last && r - first < maxBatch; r++)
+	{
+		PM::VertexHandle v1 = splitInfo(r).v1;
+
+		// added by a split of this run
+		if (mesh.vertex(v1).deleted()) break;
+
+		int visit = ++stampValue;
+		ring.assign(1, v1);
+		visited[v1.idx()] = visit;
+
+		int levelBegin = 0;
+		for (int depth = 0; depth < ringDepth; depth++)
+		{
+			int levelEnd = ring.size();
+			for (int i = levelBegin; i < levelEnd; i++)
+			{
+				for (PM::VertexVertexIter vv_it = mesh.vv_iter(ring[i]); vv_it; ++vv_it)
+				{
+					if (visited[vv_it.handle().idx()] != visit)
+					{
+						visited[vv_it.handle().idx()] = visit;
+						ring.push_back(vv_it.handle());
+					}
+				}
+			}
+			levelBegin = levelEnd;
+		}
+
+		bool overlaps = false;
+		for (int i = 0; i < ring.size() && !overlaps; i++)
+			overlaps = (owner[ring[i].idx()] == batch);
+		if (overlaps) break;
+
+		for (int i = 0; i < ring.size(); i++)
+			owner[ring[i].idx()] = batch;
+	}
+
+	assert(r > first || first == last);
+	return r;
+}
+
+// Same detail vectors as one split at a time: each phase of the serial
+// loop is done for a whole run of splits, which are in order and far
+// enough apart for their splits not to matter to each other.
+void ProgressiveMesh::computeDetailVectorsParallel(int desiredDetailLevel)
+{
+	// splits [first, last) are to be computed
+	int first = splitIndex(pmIter) + 1;
+	int last = min(first + max(0, desiredDetailLevel - currentVCount),
+		int(pmInfos.size()) - streamSplitsPending);
+	if (first >= last) return;
+
+	// room for every vertex, so that no thread grows the cache
+	if (vertexWeightCache.size() < mesh.n_vertices())
+		vertexWeightCache.resize(mesh.n_vertices());
+
+	vector<int> owner(mesh.n_vertices(), 0), visited(mesh.n_vertices(), 0);
+	int stampValue = 0;
+
+	vector<VertexUpdateList> vertexUpdates;
+	vector<Frame<PM> > frames;
+	vector<vector<PM::Point> > detail;
+
+	int r = first;
+	while (r < last)
+	{
+		int end = nextDetailBatch(r, last, owner, visited, stampValue);
+		int n = end - r, i;
+
+		vertexUpdates.resize(n);
+		frames.resize(n);
+		detail.resize(n);
+
+		// 1. local frames, before the splits
+#pragma omp parallel for schedule(dynamic, 16)
+		for (i = 0; i < n; i++)
+			frames[i] = Frame<PM>(mesh, splitInfo(r+i).v1, &vertexRank);
+
+		// 2. weights of the new vertices
+		for (i = 0; i < n; i++)
+			refine();
+
+#pragma omp parallel
+		{
+			DividedDifferenceCache cache;
+
+#pragma omp for schedule(dynamic, 1)
+			for (i = 0; i < n; i++)
+			{
+				cache.clear();
+				vertexUpdates[i].clear();
+				computeVertexWeights(splitInfo(r+i).v0, vertexUpdates[i], cache);
+			}
+		}
+
+		// 3. detail vectors
+#pragma omp parallel for schedule(dynamic, 16)
+		for (i = 0; i < n; i++)
+			computeSplitDetail(vertexUpdates[i], frames[i], detail[i]);
+
+		for (i = 0; i < n; i++)
+			details.write(r+i, &detail[i][0], detail[i].size());
+
+		r = end;
+	}
+}
+
+void ProgressiveMesh::restoreDetailVectors(int desiredDetailLevel)
+{
+	endGeomorph();
+	endSelectiveRefinement();
+
+	// moves vertices behind the replay's back
+	replay.dropBaseline();
+
+	// a read clears the ranks, and a stream adds vertices
+	if (vertexRank.size() != mesh.n_vertices()) rankVertices();
+
+	Timer t;
+	cout << "Restoring detail vectors... ";	
+
+	while ( is_refinable() && currentVCount < desiredDetailLevel )	
+	{
+		// Clear coefficient and weight hash
+		clear_hashes();
+
+		DetailVectorStore::Span detail = details.get(splitIndex(pmIter-1));
+
+		if (detail.empty()) {
+			// This level has no detail vectors -- we probably did not want to compute them
+			refine();
+			continue;
+		}
+
+		// Compute local frame without using new vertex, while the mesh
+		// is still at the level of the split
+		Frame<PM> frame(mesh, (pmIter-1)->v1, &vertexRank);
+
+		// Add new vertex
+		PMInfoContainer::iterator iter = refine();
+
+		// Get the iterator of the new vertex		
+		PM::VertexHandle vh_new = iter->v0;
+
+		// Compute vertex weights, using original mesh points
+		vector<VertexUpdate> vertexUpdates;
+		computeVertexWeights(vh_new, vertexUpdates);
+
+		// Make sure to compute all new positions, before updating any of them
+		typedef pair<PM::VertexHandle, PM::Point> PointUpdate;
+		vector<PointUpdate> pointUpdates;
+		
+		bool first = true;
+
+		// Detail vectors are all stored on the split
+		int d = 0;
+
+		// Relax vertices
+		vector<VertexUpdate>::iterator vit, vend = vertexUpdates.end();
+		for (vit = vertexUpdates.begin(); vit != vend; ++vit)
+		{
+			PM::VertexHandle vh = vit->first;
+			VertexWeights& weights = vit->second;
+			
+			// Sum weights * neighbors
+			PM::Point q_n(0,0,0);
+			vector<VertexWeight>::iterator wit, wend = weights.end();
+			for (wit = weights.begin(); wit != wend; ++wit)
+			{
+				PM::VertexHandle q_k = wit->first;
+				PM::Scalar w = wit->second;
+				
+				q_n += w * mesh.point(q_k);
+				//cout << "w * q_k = " << w << " * " << mesh.point(q_k) << " = "
+				//	<< (w * mesh.point(q_k)) << ", " << endl;
+			}
+
+			//cout << vh.idx() << ": q_n = " << q_n << ", local_dv = " << local_dv << endl;
+
+			assert(d < detail.size());
+			PM::Point dv = detail[d++];
+			PM::Point local_dv = frame.unproject(dv);
+			PM::Point relaxed_point = q_n;
+			PM::Point updated_point = relaxed_point + local_dv;
+
+			if (first) {
+				// New vertex gets updated immediately to relaxed position,
+				// since 1-ring depends on that new position
+				mesh.set_point(vh, relaxed_point);
+				first = false;
+			} 
+
+			// All vertices need to be updated to relaxed + detail
+			pointUpdates.push_back(make_pair(vh, updated_point));
+
+		}
+
+		// Now, perform deferred updates
+		vector<PointUpdate>::iterator pu_it, pu_end(pointUpdates.end());
+		for (pu_it = pointUpdates.begin(); pu_it != pu_end; ++pu_it)
+		{
+			mesh.set_point(pu_it->first, pu_it->second);
+		}	       
+	}
+
+	cout << "(" << t.get_elapsed() << "s)" << endl;
+}
+
+void ProgressiveMesh::compileReplay()
+{
+	Timer t;
+	cout << "Compiling detail vector replay... ";
+
+	// the same walk as restoreDetailVectors(), recording what it reads
+	int level = currentVCount;
+	coarsenToLevelN(minVCount);
+	rankVertices();
+	replay.begin(minVCount, maxVCount, mesh.n_vertices());
+
+	vector<PM::VertexHandle> corners;
+	vector<int> cornerIndices;
+	PM::VertexHandle to;
+
+	while ( is_refinable() && currentVCount < maxVCount )
+	{
+		clear_hashes();
+
+		int r = splitIndex(pmIter-1);
+		if (details.get(r).empty())
+		{
+			refine();
+			continue;
+		}
+
+		PM::VertexHandle vh_old = (pmIter-1)->v1;
+		Frame<PM>::stencil(mesh, vh_old, corners, to, &vertexRank);
+
+		PMInfoContainer::iterator iter = refine();
+
+		VertexUpdateList vertexUpdates;
+		computeVertexWeights(iter->v0, vertexUpdates);
+
+		cornerIndices.resize(corners.size());
+		for (int i = 0; i < corners.size(); i++)
+			cornerIndices[i] = corners[i].idx();
+		replay.addSplit(r, vh_old.idx(), to.idx(), cornerIndices);
+
+		VertexUpdateList::iterator vit, vend = vertexUpdates.end();
+		for (vit = vertexUpdates.begin(); vit != vend; ++vit)
+		{
+			replay.addUpdate(vit->first.idx());
+
+			VertexWeights::iterator wit, wend = vit->second.end();
+			for (wit = vit->second.begin(); wit != wend; ++wit)
+				replay.addWeight(wit->first.idx(), wit->second);
+		}
+	}
+
+	replay.end();
+	coarsenToLevelN(level);
+
+	cout << "(" << replay.getSplitCount() << " splits, " << replay.getMemoryUsage() 
+		<< " bytes) (" << t.get_elapsed() << "s)" << endl;
+}
+
+void ProgressiveMesh::replayDetailVectors()
+{
+	endGeomorph();
+	endSelectiveRefinement();
+
+	// replays come after the detail vectors change, so the bands are stale
+	bands.clear();
+
+	// splits still arriving aren't in the program
+	if (streamSplitsPending > 0)
+	{
+		coarsenToLevelN(minVCount);
+		restoreDetailVectors(maxVCount);
+		return;
+	}
+
+	if (replay.empty()) compileReplay();
+
+	Timer t;
+	cout << "Replaying detail vectors... ";
+
+	// vertices don't move on splits, so the topology can come first
+	refineToLevelN(maxVCount);
+
+	int n = mesh.n_vertices();
+	vector<PM::Point> points(n);
+	for (int i = 0; i < n; i++)
+		points[i] = mesh.point(PM::VertexHandle(i));
+
+	if (n > 0) replay.run(&points[0], details);
+
+	for (int i = 0; i < n; i++)
+		mesh.set_point(PM::VertexHandle(i), points[i]);
+
+	cout << "(" << t.get_elapsed() << "s)" << endl;
+}
+
+int ProgressiveMesh::replayDetailVectors(const vector<int>& changedSplits)
+{
+	endGeomorph();
+	endSelectiveRefinement();
+
+	if (replay.empty() || !replay.hasBaseline() || streamSplitsPending > 0)
+	{
+		replayDetailVectors();
+		return replay.getSplitCount();
+	}
+
+	refineToLevelN(maxVCount);
+	bands.clear();
+
+	vector<int> moved;
+	int evaluated = replay.update(details, changedSplits, moved);
+
+	for (int i = 0; i < moved.size(); i++)
+		mesh.set_point(PM::VertexHandle(moved[i]), replay.getPosition(moved[i]));
+
+	return evaluated;
+}
+
+bool ProgressiveMesh::applyDetailBands(const vector<float>& factors)
+{
+	if (detailBandCount < 2 || factors.size() != detailBandCount || streamSplitsPending > 0)
+		return false;
+
+	endGeomorph();
+	endSelectiveRefinement();
+
+	if (bands.empty())
+	{
+		if (!replay.hasBaseline()) replayDetailVectors();
+
+		Timer t;
+		cout << "Building detail bands... ";
+		bands.build(replay, details, vertexOrdering.size(), detailBandCount);
+		cout << "(" << bands.getBandCount() << " bands, " << bands.getMemoryUsage()
+			<< " bytes) (" << t.get_elapsed() << "s)" << endl;
+
+		bandFactors.assign(detailBandCount, 1.0f);
+	}
+
+	// the detail vectors follow, so that a replay later on starts from
+	// the filtered model rather than undoing it
+	int splitCount = vertexOrdering.size();
+	for (int r = 0; r < details.getSplitCount(); r++)
+	{
+		float factor = DetailBands::interpolate(factors, r, splitCount);
+		if (factor != 1.0f) details.scale(r, factor);
+	}
+
+	for (int k = 0; k < detailBandCount; k++)
+		bandFactors[k] *= factors[k];
+
+	refineToLevelN(maxVCount);
+
+	int n = mesh.n_vertices();
+	vector<PM::Point> points(n);
+	if (n > 0) bands.evaluate(bandFactors, &points[0]);
+
+	// the vertices are no longer where the last replay put them
+	replay.dropBaseline();
+	for (int i = 0; i < n; i++)
+		mesh.set_point(PM::VertexHandle(i), points[i]);
+
+	return true;
+}
+
+void ProgressiveMesh::stepComputeDetailVectors()
+{
+	computeDetailVectors(currentVCount-1);
+}
+
+ProgressiveMesh::DetailError ProgressiveMesh::setDetailPrecision(DetailVectorStore::Precision p)
+{
+	DetailError error = { 0.0f, 0.0f };
+
+	detailPrecision = p;
+	if (details.getPrecision() == p) return error;
+
+	// nothing to restore yet
+	if (details.size() == 0 || streamSplitsPending > 0)
+	{
+		details.setPrecision(p);
+		return error;
+	}
+
+	endGeomorph();
+	endSelectiveRefinement();
+
+	Timer t;
+	int level = currentVCount;
+	size_t before = details.getMemoryUsage();
+
+	// vertices don't move on splits, so after restoring to the finest
+	// level every vertex is where this precision puts it
+	replayDetailVectors();
+
+	int n = mesh.n_vertices();
+	vector<PM::Point> reference(n);
+	for (int i = 0; i < n; i++)
+		reference[i] = mesh.point(PM::VertexHandle(i));
+
+	details.setPrecision(p);
+
+	replayDetailVectors();
+
+	double sum = 0.0;
+	for (int i = 0; i < n; i++)
+	{
+		float d = (mesh.point(PM::VertexHandle(i)) - reference[i]).norm();
+		error.maxError = max(error.maxError, d);
+		sum += double(d) * d;
+	}
+	error.rmsError = n ? float(sqrt(sum / n)) : 0.0f;
+
+	coarsenToLevelN(level);
+
+	static const char* names[] = { "full", "half", "int16" };
+	float diagonal = (bbox_max - bbox_min).norm();
+	cout << "Detail vectors at " << names[p] << " precision: " << before << " -> "
+		<< details.getMemoryUsage() << " bytes, error max " << error.maxError
+		<< " rms " << error.rmsError << " (bounding box diagonal " << diagonal 
+		<< ") (" << t.get_elapsed() << "s)" << endl;
+
+	return error;
+}
+
+void ProgressiveMesh::smooth()
+{
+	// Deprecated
+
+	for (int i=vertexOrdering.size()/2; i < vertexOrdering.size(); i++)	
+	{
+		details.scale(i, 0.9f);
+	}
+
+	replayDetailVectors();
 }
\ No newline at end of file
@@ -1,127 +1,443 @@
-/*
-@file ProgressiveMesh.h
-
-ProgressiveMesh implements Hoppe's progressive meshes, using half-edge
-collapses that are driven by the Garland-Heckbert error metric biased
-by edge length.
-
-It knows how to coarsen, refine, load and save models, and how to
-compute multiresolution detail vectors.
-*/
-#ifndef PROGRESSIVEMESH_H
-#define PROGRESSIVEMESH_H
-
-// general includes
-#include <vector>
-#include "TriMesh.h"
-
-extern double get_cpu_time();
-
-// Timer helper class
-class Timer {
-public:
-	Timer() { reset(); }
-	void reset() { t0 = get_cpu_time(); }
-	double get_elapsed() const { return get_cpu_time() - t0; }
-private:
-	double t0;	
-};
-
-typedef OpenMesh::Decimater::ModQuadricT<PM> Quadrics;
-typedef OpenMesh::Decimater::DecimaterT<PM> Decimater;
-typedef OpenMesh::Decimater::DecimaterT<PM>::ProgMeshInfoContainer PMInfoContainer;
-
-class ProgressiveMesh
-{
-
-protected:
-
-	// Compute bounding box of mesh
-	void computeBoundingBox();
-
-	// Mesh data
-	PM mesh;
-
-	PM::Point bbox_min, bbox_max;
-	int minVCount, maxVCount, currentVCount;	 	
-
-	// Progressive Mesh data
-	PMInfoContainer pmInfos;
-	PMInfoContainer::iterator pmIter;	
-
-	std::vector<PM::VertexHandle> vertexOrdering;
-
-public:
-
-	ProgressiveMesh()
-	{
-		pmIter = pmInfos.end();
-		minVCount = maxVCount = currentVCount=0;
-		bbox_min  = PM::Point(-5, -5, -5);
-		bbox_max  = PM::Point( 5,  5,  5);
-	};
-
-	virtual ~ProgressiveMesh(){};
-
-	/// Get current level
-	int getCurrentLevel(){return currentVCount;};
-	int getMinLevel(){return minVCount;};
-	int getMaxLevel(){return maxVCount;};
-
-	/// Returns true iff the mesh is still refinable
-	bool is_refinable();
-
-	/// Refine one level of the progressive mesh
-	PMInfoContainer::iterator refine();
-
-	/// Refine mesh up to n vertices
-	void refineToLevelN(int n);
-
-	/// Return true iff mesh can be coarsened
-	bool is_coarsenable();
-
-	/// Simplify one level
-	PMInfoContainer::iterator coarsen();
-
-	/// Coarsen mesh down to n vertices
-	void coarsenToLevelN(int n);
-	
-
-	/// Read a file
-	bool readFile(const char* filename=NULL);
-
-	/// Write a file
-	bool writeFile(const char* filename=NULL);
-
-	/// Read PM file
-	bool readPMFile(const char* filename=NULL);
-
-	/// Build the hierarchy
-	void buildPM();
-
-	/// Compute detail vectors, up to desired detail level
-	void computeDetailVectors(int desiredDetailLevel);
-
-	/// Restore detail vectors, up to desired detail level
-	void restoreDetailVectors(int desiredDetailLevel);
-
-	void stepComputeDetailVectors();
-
-	// Compute vertex weights for relaxation operator
-	typedef std::pair<PM::VertexHandle,PM::Scalar> VertexWeight;
-	typedef std::vector<VertexWeight> VertexWeights;
-	typedef std::pair<PM::VertexHandle,VertexWeights> VertexUpdate;
-	typedef std::vector<VertexUpdate> VertexUpdateList;
-
-	// Cached interface
-	void computeVertexWeights(PM::VertexHandle vh_n, std::vector<VertexUpdate>& vertexUpdates);
-	typedef std::vector<VertexUpdateList> VertexUpdateListCache;
-	VertexUpdateListCache vertexWeightCache;
-
-	/// Vertex weight calculation	
-	void computeVertexWeights_calc(PM::VertexHandle vh_n, std::vector<VertexUpdate>& vertexUpdates);
-
-	void smooth();
-};
-
-#endif
+/*
+@file ProgressiveMesh.h
+
+ProgressiveMesh implements Hoppe's progressive meshes, using half-edge
+collapses that are driven by the Garland-Heckbert error metric biased
+by edge length.
+
+It knows how to coarsen, refine, load and save models, and how to
+compute multiresolution detail vectors.
+*/
+#ifndef PROGRESSIVEMESH_H
+#define PROGRESSIVEMESH_H
+
+// general includes
+#include <vector>
+#include "TriMesh.h"
+#include "VertexHierarchy.h"
+#include "DetailVectorStore.h"
+#include "DetailReplay.h"
+#include "DetailBands.h"
+
+extern double get_cpu_time();
+extern double get_wall_time();
+
+// Timer helper class
+class Timer {
+public:
+	Timer() { reset(); }
+	void reset() { t0 = get_cpu_time(); }
+	double get_elapsed() const { return get_cpu_time() - t0; }
+private:
+	double t0;	
+};
+
+typedef OpenMesh::Decimater::ModQuadricSoAT<PM> Quadrics;
+typedef OpenMesh::Decimater::DAryHeapT<PM,4> DecimaterHeap;
+typedef OpenMesh::Decimater::DecimaterT<PM,DecimaterHeap> Decimater;
+typedef Decimater::ProgMeshInfoContainer PMInfoContainer;
+typedef Decimater::Observer DecimationObserver;
+
+class PMStreamReader;
+struct DividedDifferenceCache;
+template <class Mesh> class Frame;
+
+class ProgressiveMesh
+{
+
+protected:
+
+	// Compute bounding box of mesh
+	void computeBoundingBox();
+
+	// Mesh data
+	PM mesh;
+
+	PM::Point bbox_min, bbox_max;
+	int minVCount, maxVCount, currentVCount;	 	
+
+	// Progressive Mesh data
+	PMInfoContainer pmInfos;
+	PMInfoContainer::iterator pmIter;	
+
+	// vertexOrdering[r] is the vertex split r adds
+	std::vector<PM::VertexHandle> vertexOrdering;
+
+	// Where each vertex comes in the numbering of writeCompressedPM():
+	// base vertices by index, then the vertex split r adds. Frames point
+	// their tangent by it, so that a .pmz read back has the same frames.
+	std::vector<int> vertexRank;
+	void rankVertices();
+
+	// Detail vectors by split, see computeDetailVectors()
+	DetailVectorStore details;
+	DetailVectorStore::Precision detailPrecision;
+
+	// restoreDetailVectors() from minVCount to maxVCount, compiled by
+	// compileReplay() on first use
+	DetailReplay replay;
+	void compileReplay();
+
+	// Bands for applyDetailBands(), built on first use from the detail
+	// vectors and the replay's baseline; bandFactors are the factors
+	// applied since, compounded
+	DetailBands bands;
+	std::vector<float> bandFactors;
+	int detailBandCount;
+
+	/// Refinement index of a split record (0 = the coarsest split)
+	int splitIndex(PMInfoContainer::iterator it) { return int(pmInfos.end() - it) - 1; }
+
+	// Decimation limits, see buildPM()
+	DecimationObserver* decimationObserver;
+	double decimationBudget;
+	volatile bool* decimationCancel;
+	bool decimationInterrupted;
+
+	// Vertex clustering before decimation, see readFile()
+	int clusteringTarget;
+	std::vector<int> clusterMap;
+
+	// Out-of-core simplification of large OBJ files, see readFile()
+	size_t streamingBudget;
+	size_t streamingPeakRSS;
+
+	// Progressive stream being read, see openStream(). pmInfos is sized
+	// for all splits up front; the first streamSplitsPending entries
+	// have not arrived yet.
+	PMStreamReader* stream;
+	enum StreamState { STREAM_HEADER, STREAM_BASE_VERTICES, STREAM_BASE_FACES, STREAM_SPLITS };
+	StreamState streamState;
+	int streamRead;			// records of the current part read so far
+	int streamBaseVertexCount, streamBaseFaceCount;
+	int streamSplitsPending;
+	bool streamBaseDone;
+
+	/// Read as much of the stream as has arrived, see pollStream()
+	bool readStreamHeader();
+	bool readStreamBase();
+	bool readStreamSplits(int maxSplits);
+
+	// Connectivity of the mesh at one level. Vertices don't move when
+	// collapsing or splitting, so the connectivity is all there is to it.
+	struct Checkpoint
+	{
+		int level;
+		int pmIndex;					// pmIter - pmInfos.begin()
+		std::vector<int> vertexHalfedges;
+		std::vector<int> halfedges;		// next, to vertex, face
+		std::vector<int> faceHalfedges;
+		std::vector<unsigned char> deleted;	// vertices, edges, faces
+	};
+
+	// Checkpoints every checkpointInterval levels from minVCount up,
+	// built on demand by jumpToLevelN() within checkpointBudget bytes
+	// plus checkpointBytesPerVertex per vertex. checkpointInterval is -1
+	// once none fit, so that they aren't tried again for this model.
+	std::vector<Checkpoint> checkpoints;
+	size_t checkpointBudget, checkpointBytesPerVertex;
+	int checkpointInterval;
+
+	void clearCheckpoints() { checkpoints.clear(); checkpointInterval = 0; }
+	void buildCheckpoints();
+	void saveCheckpoint(Checkpoint& checkpoint);
+	void restoreCheckpoint(const Checkpoint& checkpoint);
+
+	// Selective refinement, see refineRegion(). While splitActive is not
+	// empty, the mesh is not at a level: split r (in refinement order) is
+	// done iff splitActive[r].
+	VertexHierarchy hierarchy;
+	std::vector<char> splitActive;
+
+	Decimater::ProgMeshInfo& splitInfo(int r);
+	bool beginSelectiveRefinement();
+	void applySplits(const std::vector<char>& target);
+
+	/// Split or collapse one vertex, without any bookkeeping
+	void splitVertex(Decimater::ProgMeshInfo& info);
+	void collapseVertex(Decimater::ProgMeshInfo& info);
+
+	// Geomorph, see buildGeomorph(). The mesh has the topology of the
+	// finer level; these are the vertices its splits add, with where
+	// they are at the coarser and at the finer level.
+	std::vector<PM::VertexHandle> geomorphVertices;
+	std::vector<PM::Point> geomorphStart, geomorphEnd;
+
+	// Detail vectors of several splits at once, see
+	// setParallelDetailVectors()
+	bool parallelDetailVectors;
+	void computeDetailVectorsParallel(int desiredDetailLevel);
+	int nextDetailBatch(int first, int last, std::vector<int>& owner, std::vector<int>& visited,
+		int& stampValue);
+
+public:
+
+	ProgressiveMesh()
+	{
+		pmIter = pmInfos.end();
+		minVCount = maxVCount = currentVCount=0;
+		bbox_min  = PM::Point(-5, -5, -5);
+		bbox_max  = PM::Point( 5,  5,  5);
+		decimationObserver = NULL;
+		decimationBudget = 0.0;
+		decimationCancel = NULL;
+		decimationInterrupted = false;
+		clusteringTarget = 0;
+		streamingBudget = 0;
+		streamingPeakRSS = 0;
+		stream = NULL;
+		streamSplitsPending = 0;
+		streamBaseDone = false;
+		checkpointBudget = 0;
+		checkpointBytesPerVertex = 0;
+		checkpointInterval = 0;
+		detailPrecision = DetailVectorStore::FULL;
+		detailBandCount = 0;
+#if defined(_OPENMP)
+		parallelDetailVectors = true;
+#else
+		parallelDetailVectors = false;
+#endif
+	};
+
+	virtual ~ProgressiveMesh() { closeStream(); };
+
+	/// Get current level
+	int getCurrentLevel(){return currentVCount;};
+	int getMinLevel(){return minVCount;};
+	int getMaxLevel(){return maxVCount;};
+
+	/// Finest level that can be reached now; below getMaxLevel() while
+	/// a stream is still arriving
+	int getAvailableLevel(){return maxVCount - streamSplitsPending;};
+
+	/// Returns true iff the mesh is still refinable
+	bool is_refinable();
+
+	/// Refine one level of the progressive mesh
+	PMInfoContainer::iterator refine();
+
+	/// Refine mesh up to n vertices
+	void refineToLevelN(int n);
+
+	/// Return true iff mesh can be coarsened
+	bool is_coarsenable();
+
+	/// Simplify one level
+	PMInfoContainer::iterator coarsen();
+
+	/// Coarsen mesh down to n vertices
+	void coarsenToLevelN(int n);
+
+	/// Go to n vertices, from the nearest checkpoint below n if that is
+	/// much closer than the current level
+	void jumpToLevelN(int n);
+
+	/// Keep checkpoints for jumpToLevelN() in at most about bytes, plus
+	/// bytesPerVertex for every vertex of the model, of memory (0 = none,
+	/// the default); fewer bytes, further apart. A checkpoint takes about
+	/// 90 bytes per vertex, so a fixed budget alone leaves large models
+	/// without any.
+	void setCheckpointBudget(size_t bytes, size_t bytesPerVertex = 0)
+	{
+		checkpointBudget = bytes;
+		checkpointBytesPerVertex = bytesPerVertex;
+		clearCheckpoints();
+	}
+
+	/// Levels between checkpoints, 0 if there are none
+	int getCheckpointInterval() { return checkpoints.empty() ? 0 : checkpointInterval; }
+
+	/// Build the vertex hierarchy for refineRegion() and coarsenRegion()
+	/// (done on demand)
+	void buildVertexHierarchy();
+	const VertexHierarchy& getVertexHierarchy() { return hierarchy; }
+
+	/// Add the splits of the vertices in region, and the splits they
+	/// depend on, coarsest first while the mesh has at most maxVertices
+	/// (0 = no limit). The rest of the mesh stays as it is. Returns the
+	/// number of vertices.
+	int refineRegion(const Region& region, int maxVertices = 0);
+
+	/// Undo the splits of the vertices in region, and those that depend
+	/// on them. Returns the number of vertices.
+	int coarsenRegion(const Region& region);
+
+	/// True while the mesh is refined selectively, not at a level
+	bool isSelective() { return !splitActive.empty(); }
+
+	/// Back to a level: keeps the splits up to the first one not done.
+	/// Changing the level or the detail does this first.
+	void endSelectiveRefinement();
+
+	/// Go to level fine and prepare a geomorph down to level coarse:
+	/// setGeomorph() then moves the vertices the splits in between add
+	/// without changing the topology
+	void buildGeomorph(int coarse, int fine);
+
+	/// Blend between the positions of the coarse (t = 0) and the fine
+	/// level (t = 1) of the geomorph
+	void setGeomorph(float t);
+
+	/// Put the vertices back at the fine level and drop the geomorph.
+	/// Changing the level or the detail does this first.
+	void endGeomorph();
+
+	/// True while a geomorph is in use
+	bool hasGeomorph() { return !geomorphVertices.empty(); }
+	
+
+	/// Read a file
+	bool readFile(const char* filename=NULL);
+
+	/// Cluster OBJ files read by readFile() down to about n vertices
+	/// before anything else is built (0 = off, the default)
+	void setClusteringTarget(int n) { clusteringTarget = n; }
+
+	/// Original vertex index -> vertex of the clustered mesh
+	/// (empty if the last file was read without clustering)
+	const std::vector<int>& getClusterMap() { return clusterMap; }
+
+	/// Stream OBJ files read by readFile() through StreamingDecimater,
+	/// using at most about bytes of memory (0 = off, the default)
+	void setStreamingBudget(size_t bytes) { streamingBudget = bytes; }
+
+	/// Peak resident set size of the last streamed read, in bytes
+	size_t getStreamingPeakRSS() { return streamingPeakRSS; }
+
+	/// Write a file
+	bool writeFile(const char* filename=NULL);
+
+	/// Read PM file (binary format, see PMFile.h)
+	bool readPMFile(const char* filename=NULL);
+
+	/// Write the hierarchy as a PM file, used by writeFile() for ".pm"
+	bool writePMFile(const char* filename=NULL);
+
+	/// Write the hierarchy compressed (format in PMCodec.h), used by
+	/// writeFile() for ".pmz"
+	bool writeCompressedPM(const char* filename=NULL);
+
+	/// Read a file written by writeCompressedPM(), at full detail
+	bool readCompressedPM(const char* filename);
+
+	/// Start reading a progressive stream (format in PMStream.h), which
+	/// may still be being written. Reads what has arrived.
+	bool openStream(const char* filename);
+
+	/// Read up to maxSplits more split records of the stream, without
+	/// waiting for data. Returns true if anything new was read.
+	bool pollStream(int maxSplits = 100000);
+
+	/// True while a stream is open and not read to the end
+	bool isStreaming() { return stream != NULL; }
+
+	/// True once the base mesh of the stream has been read
+	bool hasStreamBaseMesh() { return streamBaseDone; }
+
+	/// Stop reading the stream; the splits read so far stay usable
+	void closeStream();
+
+	/// Write the hierarchy as a progressive stream, used by writeFile()
+	/// for ".pms"
+	bool writePMStream(const char* filename=NULL);
+
+	/// Build the hierarchy
+	void buildPM();
+
+	/// Progress callback for the decimation in buildPM(), NULL for none
+	void setDecimationObserver(DecimationObserver* observer) { decimationObserver = observer; }
+
+	/// Wall clock limit for the decimation in buildPM(), 0 for none
+	void setDecimationTimeBudget(double seconds) { decimationBudget = seconds; }
+
+	/// Stop the decimation in buildPM() when *flag becomes true
+	void setDecimationCancelFlag(volatile bool* flag) { decimationCancel = flag; }
+
+	/// True iff the last buildPM() stopped decimating early. The hierarchy
+	/// is then complete, but its base mesh is finer than it could be.
+	bool wasDecimationInterrupted() { return decimationInterrupted; }
+
+	/// Compute detail vectors, up to desired detail level
+	void computeDetailVectors(int desiredDetailLevel);
+
+	/// Compute the detail vectors of runs of splits that are far enough
+	/// apart not to see each other, on all cores (OpenMP). The result is
+	/// the same as one split at a time. On by default with OpenMP.
+	void setParallelDetailVectors(bool parallel) { parallelDetailVectors = parallel; }
+
+	/// Restore detail vectors, up to desired detail level
+	void restoreDetailVectors(int desiredDetailLevel);
+
+	/// Restore detail vectors from the coarsest level to the finest, as
+	/// coarsenToLevelN(getMinLevel()) and restoreDetailVectors(getMaxLevel())
+	/// do, but by running a program compiled from them on the first call
+	/// (see DetailReplay.h). Ends at the finest level.
+	void replayDetailVectors();
+
+	/// After the detail vectors of changedSplits (refinement indices)
+	/// changed: the same as replayDetailVectors() from the positions the
+	/// last one started from, but only evaluates the splits the changes
+	/// reach. Falls back to replayDetailVectors() when vertices were
+	/// moved some other way since. Returns the splits evaluated.
+	int replayDetailVectors(const std::vector<int>& changedSplits);
+
+	/// Filter with bandCount precomputed bands (see DetailBands.h),
+	/// 0 = off, the default. They take bandCount * 3 floats per vertex.
+	void setDetailBands(int bandCount) { detailBandCount = bandCount; bands.clear(); }
+	int getDetailBands() { return detailBandCount; }
+
+	/// Scale the detail vectors of every split by factors interpolated
+	/// between the nodes (factors[k] is for DetailBands::getNode(k)),
+	/// and put the vertices where replaying puts them, from the bands
+	/// instead of a replay. Factors compound with those of earlier
+	/// calls, as scaling the detail vectors does. Builds the bands on the
+	/// first call after the detail vectors changed some other way. Ends
+	/// at the finest level. Returns false if bands are off, or the model
+	/// is still streaming in.
+	bool applyDetailBands(const std::vector<float>& factors);
+
+	void stepComputeDetailVectors();
+
+	/// Detail vectors of all splits
+	const DetailVectorStore& getDetailVectors() { return details; }
+
+	/// How far restoring moves the vertices from where it put them at
+	/// the previous precision
+	struct DetailError
+	{
+		float maxError, rmsError;
+	};
+
+	/// Keep the detail vectors at precision p, now and for the models
+	/// built or read later. Converting restores the model at both
+	/// precisions and reports the error.
+	DetailError setDetailPrecision(DetailVectorStore::Precision p);
+	DetailVectorStore::Precision getDetailPrecision() { return detailPrecision; }
+
+	// Compute vertex weights for relaxation operator
+	typedef std::pair<PM::VertexHandle,PM::Scalar> VertexWeight;
+	typedef std::vector<VertexWeight> VertexWeights;
+	typedef std::pair<PM::VertexHandle,VertexWeights> VertexUpdate;
+	typedef std::vector<VertexUpdate> VertexUpdateList;
+
+	// Cached interface
+	void computeVertexWeights(PM::VertexHandle vh_n, std::vector<VertexUpdate>& vertexUpdates);
+	void computeVertexWeights(PM::VertexHandle vh_n, std::vector<VertexUpdate>& vertexUpdates,
+		DividedDifferenceCache& cache);
+	typedef std::vector<VertexUpdateList> VertexUpdateListCache;
+	VertexUpdateListCache vertexWeightCache;
+
+	/// Vertex weight calculation	
+	void computeVertexWeights_calc(PM::VertexHandle vh_n, std::vector<VertexUpdate>& vertexUpdates,
+		DividedDifferenceCache& cache);
+
+	/// Detail vectors of the split that added vertexUpdates[0].first,
+	/// in the frame of the vertex it split from. Only reads the mesh.
+	void computeSplitDetail(const VertexUpdateList& vertexUpdates, Frame<PM>& frame,
+		std::vector<PM::Point>& detail);
+
+	void smooth();
+};
+
+#endif
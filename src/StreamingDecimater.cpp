@@ -0,0 +1,389 @@
+#include <cassert>
+#include <math.h>
+#include <algorithm>
+#include <iostream>
+#include "StreamingDecimater.h"
+#include "ProgressiveMesh.h"
+#include "OBJStream.h"
+
+#pragma warning(disable: 4018)  // signed/unsigned mismatch
+
+using namespace std;
+
+// Faces may only use the vertices read before them; both passes over
+// the faces skip the same ones
+static bool validFace(const int tri[3], int verticesSoFar)
+{
+	for (int k = 0; k < 3; k++)
+		if (tri[k] < 0 || tri[k] >= verticesSoFar) return false;
+	return true;
+}
+
+// Deepest cut of the chunk tree, about 2^-11 of the bounding box across
+static const int MAX_CHUNK_DEPTH = 32;
+
+// Faces buffered per chunk before they go to the scratch file
+static const int FACES_PER_WRITE = 256;
+
+bool StreamingDecimater::simplify(const char* filename, PM& mesh)
+{
+	Timer t;
+	peakRSS = 0;
+	vertexFile = faceFile = NULL;
+	outPoints.clear();
+	outTriangles.clear();
+	sharedIndex.clear();
+
+	cout << "Streaming " << filename << " (budget " << (memoryBudget >> 20) << " MB)... " << endl;
+
+	if (!readVertices(filename))
+	{
+		if (vertexFile) fclose(vertexFile);
+		return false;
+	}
+
+	// chunks that fit the budget, output reduced to fit it too
+	int facesPerChunk = max(1, int(memoryBudget / BYTES_PER_FACE));
+	ratio = min(1.0f, float(facesPerChunk) / float(max(faceCount, 1)));
+	buildChunks(facesPerChunk);
+
+	bool ok = splitFaces(filename);
+
+	int chunks = 0;
+	for (int c = 0; ok && c < chunkTree.size(); c++)
+	{
+		if (chunkFill[c] == 0) continue;
+		decimateChunk(c);
+		chunks++;
+	}
+
+	fclose(vertexFile);
+	if (faceFile) fclose(faceFile);
+	vertexChunk.clear();
+	vertexShared.clear();
+	sharedIndex.clear();
+	chunkStart.clear();
+	chunkFill.clear();
+	chunkBuffer.clear();
+
+	if (!ok)
+	{
+		cout << "Can't write the scratch files for " << filename << "." << endl;
+		return false;
+	}
+
+	// build the coarse mesh
+	mesh.clear();
+	std::vector<PM::VertexHandle> vhandles(outPoints.size());
+	for (int i = 0; i < outPoints.size(); i++)
+		vhandles[i] = mesh.add_vertex(outPoints[i]);
+
+	for (int f = 0; f < outTriangles.size(); f += 3)
+		mesh.add_face(vhandles[outTriangles[f]], vhandles[outTriangles[f+1]], vhandles[outTriangles[f+2]]);
+
+	updatePeakRSS();
+
+	cout << vertexCount << " vertices, " << faceCount << " faces streamed into "
+		<< mesh.n_vertices() << " vertices, " << mesh.n_faces() << " faces ("
+		<< chunks << " chunks, peak RSS " << (peakRSS >> 20) << " MB, "
+		<< t.get_elapsed() << "s)" << endl;
+
+	return true;
+}
+
+bool StreamingDecimater::readVertices(const char* filename)
+{
+	OBJStream obj;
+	if (!obj.open(filename)) return false;
+
+	vertexFile = tmpfile();
+	if (!vertexFile)
+	{
+		cout << "Can't create a scratch file for " << filename << "." << endl;
+		return false;
+	}
+
+	vertexCount = faceCount = 0;
+	vertexFaces.clear();
+
+	PM::Point p;
+	int tri[3];
+	OBJStream::Record record;
+
+	while ((record = obj.next(p, tri)) != OBJStream::END)
+	{
+		if (record == OBJStream::VERTEX)
+		{
+			if (vertexCount == 0) bbox_min = bbox_max = p;
+			for (int k = 0; k < 3; k++)
+			{
+				bbox_min[k] = min(bbox_min[k], p[k]);
+				bbox_max[k] = max(bbox_max[k], p[k]);
+			}
+
+			if (fwrite(&p[0], sizeof(float), 3, vertexFile) != 3)
+			{
+				cout << "Can't write the scratch files for " << filename << "." << endl;
+				return false;
+			}
+			vertexFaces.push_back(0);
+			vertexCount++;
+		}
+		else if (validFace(tri, vertexCount))
+		{
+			vertexFaces[tri[0]]++;
+			faceCount++;
+		}
+	}
+
+	return vertexCount > 0;
+}
+
+void StreamingDecimater::buildChunks(int facesPerChunk)
+{
+	ChunkNode root;
+	root.min = bbox_min;
+	root.max = bbox_max;
+	root.axis = 0;
+	root.split = 0.0f;
+	root.child = -1;
+	root.depth = 0;
+	root.faces = faceCount;
+	chunkTree.assign(1, root);
+
+	// Cut every leaf with too many faces in half across its longest
+	// side, and count again. Only boxes the surface passes through get
+	// cut, so every chunk fits the budget however much of the bounding
+	// box is empty.
+	for (;;)
+	{
+		bool cut = false;
+		int n = chunkTree.size();
+		for (int c = 0; c < n; c++)
+		{
+			if (chunkTree[c].child >= 0 || chunkTree[c].faces <= facesPerChunk
+				|| chunkTree[c].depth >= MAX_CHUNK_DEPTH) continue;
+
+			ChunkNode low = chunkTree[c];
+			PM::Point extent = low.max - low.min;
+			int axis = 0;
+			for (int k = 1; k < 3; k++)
+				if (extent[k] > extent[axis]) axis = k;
+
+			float split = (low.min[axis] + low.max[axis]) * 0.5f;
+			low.depth++;
+			low.faces = 0;
+			ChunkNode high = low;
+			low.max[axis] = split;
+			high.min[axis] = split;
+
+			chunkTree[c].axis = axis;
+			chunkTree[c].split = split;
+			chunkTree[c].child = chunkTree.size();
+			chunkTree.push_back(low);
+			chunkTree.push_back(high);
+			cut = true;
+		}
+		if (!cut) break;
+
+		for (int c = 0; c < chunkTree.size(); c++)
+			chunkTree[c].faces = 0;
+
+		rewind(vertexFile);
+		for (int i = 0; i < vertexCount; i++)
+		{
+			float p[3];
+			fread(p, sizeof(float), 3, vertexFile);
+			chunkTree[chunkOf(PM::Point(p[0], p[1], p[2]))].faces += vertexFaces[i];
+		}
+	}
+
+	std::vector<int>().swap(vertexFaces);
+}
+
+int StreamingDecimater::chunkOf(const PM::Point& p) const
+{
+	int c = 0;
+	while (chunkTree[c].child >= 0)
+		c = chunkTree[c].child + (p[chunkTree[c].axis] >= chunkTree[c].split ? 1 : 0);
+	return c;
+}
+
+bool StreamingDecimater::splitFaces(const char* filename)
+{
+	// chunk of every vertex, from the scratch file
+	vertexChunk.resize(vertexCount);
+	vertexShared.assign(vertexCount, false);
+
+	rewind(vertexFile);
+	for (int i = 0; i < vertexCount; i++)
+	{
+		float p[3];
+		fread(p, sizeof(float), 3, vertexFile);
+		vertexChunk[i] = chunkOf(PM::Point(p[0], p[1], p[2]));
+	}
+
+	// one scratch file for all chunks, each in a part as large as its
+	// face count, so there is only ever one file open for them
+	faceFile = tmpfile();
+	if (!faceFile) return false;
+
+	int n = chunkTree.size();
+	chunkStart.resize(n);
+	chunkFill.assign(n, 0);
+	chunkBuffer.assign(n, std::vector<int>());
+
+	long start = 0;
+	for (int c = 0; c < n; c++)
+	{
+		chunkStart[c] = start;
+		if (chunkTree[c].child < 0) start += chunkTree[c].faces;
+	}
+
+	// faces go to the chunk of their first vertex; a vertex used by a
+	// face of another chunk lies on a seam
+	OBJStream obj;
+	if (!obj.open(filename)) return false;
+
+	PM::Point p;
+	int tri[3];
+	OBJStream::Record record;
+
+	while ((record = obj.next(p, tri)) != OBJStream::END)
+	{
+		if (record != OBJStream::TRIANGLE) continue;
+		if (!validFace(tri, obj.getVertexCount())) continue;
+
+		int chunk = vertexChunk[tri[0]];
+		for (int k = 1; k < 3; k++)
+		{
+			if (vertexChunk[tri[k]] != chunk)
+			{
+				vertexShared[tri[0]] = true;
+				vertexShared[tri[k]] = true;
+			}
+		}
+
+		std::vector<int>& buffer = chunkBuffer[chunk];
+		buffer.insert(buffer.end(), tri, tri + 3);
+		if (buffer.size() >= 3 * FACES_PER_WRITE && !flushChunk(chunk))
+			return false;
+	}
+
+	for (int c = 0; c < n; c++)
+	{
+		if (!flushChunk(c)) return false;
+		std::vector<int>().swap(chunkBuffer[c]);
+	}
+
+	return true;
+}
+
+bool StreamingDecimater::flushChunk(int chunk)
+{
+	std::vector<int>& buffer = chunkBuffer[chunk];
+	if (buffer.empty()) return true;
+
+	int faces = buffer.size() / 3;
+	assert(chunkFill[chunk] + faces <= chunkTree[chunk].faces);
+
+	fseek(faceFile, (chunkStart[chunk] + chunkFill[chunk]) * long(3 * sizeof(int)), SEEK_SET);
+	bool ok = fwrite(&buffer[0], 3 * sizeof(int), faces, faceFile) == faces;
+	chunkFill[chunk] += faces;
+	buffer.clear();
+	return ok;
+}
+
+void StreamingDecimater::decimateChunk(int chunk)
+{
+	// faces of the chunk
+	std::vector<int> triangles(3 * chunkFill[chunk]);
+	fseek(faceFile, chunkStart[chunk] * long(3 * sizeof(int)), SEEK_SET);
+	int read = fread(&triangles[0], 3 * sizeof(int), chunkFill[chunk], faceFile);
+	triangles.resize(3 * read);
+
+	// its vertices, sorted by global index
+	std::vector<int> globalIds(triangles);
+	sort(globalIds.begin(), globalIds.end());
+	globalIds.erase(unique(globalIds.begin(), globalIds.end()), globalIds.end());
+
+	PM part;
+	std::vector<PM::VertexHandle> vhandles(globalIds.size());
+	for (int i = 0; i < globalIds.size(); i++)
+	{
+		float p[3];
+		fseek(vertexFile, long(globalIds[i]) * 3 * sizeof(float), SEEK_SET);
+		fread(p, sizeof(float), 3, vertexFile);
+		vhandles[i] = part.add_vertex(PM::Point(p[0], p[1], p[2]));
+
+		// seams stay as they are
+		if (vertexShared[globalIds[i]])
+			part.vertex(vhandles[i]).set_locked(true);
+	}
+
+	for (int f = 0; f < triangles.size(); f += 3)
+	{
+		PM::VertexHandle v[3];
+		for (int k = 0; k < 3; k++)
+			v[k] = vhandles[lower_bound(globalIds.begin(), globalIds.end(), triangles[f+k]) - globalIds.begin()];
+		part.add_face(v[0], v[1], v[2]);
+	}
+	triangles.clear();
+
+	part.update_face_normals();
+
+	// decimate; decimate(0) would collapse all it can, so a chunk that
+	// keeps all its vertices is left alone
+	int collapses = int(part.n_vertices() * (1.0f - ratio));
+	if (collapses > 0)
+	{
+		Decimater decimater(part);
+		Quadrics modQuadric(part);
+		decimater.registrate(modQuadric);
+		decimater.initialize();
+		decimater.cache_priorities(true);
+#if defined(_OPENMP)
+		decimater.parallel_independent_sets(true);
+#endif
+		decimater.decimate(collapses);
+	}
+
+	updatePeakRSS();
+
+	// append to output; vertices keep their input position, so shared
+	// ones are matched by global index
+	std::vector<int> outIndex(globalIds.size(), -1);
+	for (int i = 0; i < globalIds.size(); i++)
+	{
+		if (part.vertex(vhandles[i]).deleted()) continue;
+
+		int g = globalIds[i];
+		if (vertexShared[g])
+		{
+			std::map<int,int>::iterator it = sharedIndex.find(g);
+			if (it != sharedIndex.end())
+			{
+				outIndex[i] = it->second;
+				continue;
+			}
+			sharedIndex[g] = outPoints.size();
+		}
+
+		outIndex[i] = outPoints.size();
+		outPoints.push_back(part.point(vhandles[i]));
+	}
+
+	for (PM::FaceIter f_it = part.faces_begin(); f_it != part.faces_end(); ++f_it)
+	{
+		if (f_it->deleted()) continue;
+
+		// no garbage collection, so vertex i still has index i
+		for (PM::FaceVertexIter fv_it = part.fv_iter(f_it.handle()); fv_it; ++fv_it)
+			outTriangles.push_back(outIndex[fv_it.handle().idx()]);
+	}
+}
+
+void StreamingDecimater::updatePeakRSS()
+{
+	peakRSS = max(peakRSS, get_peak_rss());
+}
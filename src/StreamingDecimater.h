@@ -0,0 +1,114 @@
+// Out-of-core simplification of OBJ files larger than memory.
+//
+// The file is streamed twice, the vertex scratch file a few more times:
+//
+//  1. vertices go to a binary scratch file, the bounding box is taken,
+//     and the faces of every vertex (as their first vertex) are counted
+//  2. the chunks are cut (see buildChunks()), then every face goes to
+//     the part of one face scratch file that holds the chunk of its
+//     first vertex; vertices used by faces of different chunks are
+//     marked shared
+//  3. each chunk is loaded as a PM, decimated with its shared vertices
+//     locked, and appended to the coarse output mesh
+//
+// Locking the shared vertices keeps the seams between chunks intact,
+// so the chunks stitch together by vertex index. In memory at any time
+// are one chunk, the coarse output, and a few bytes per input vertex
+// (chunk, face count, shared bit, output index of shared vertices).
+//
+// The memory budget sets both the chunk size and the size of the coarse
+// mesh handed to buildPM().
+
+#ifndef STREAMING_DECIMATER_H
+#define STREAMING_DECIMATER_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <vector>
+#include <map>
+#include "TriMesh.h"
+
+extern size_t get_peak_rss();
+
+class StreamingDecimater
+{
+public:
+	StreamingDecimater(size_t memoryBudget = 256 << 20) : memoryBudget(memoryBudget) {}
+
+	/// Bytes a chunk, and the coarse result, may take
+	void setMemoryBudget(size_t bytes) { memoryBudget = bytes; }
+	size_t getMemoryBudget() const { return memoryBudget; }
+
+	/// Simplify an OBJ file into mesh. Returns false if it can't be read,
+	/// or the scratch files can't be written.
+	bool simplify(const char* filename, PM& mesh);
+
+	/// Largest resident set seen during the last simplify(), in bytes
+	size_t getPeakRSS() const { return peakRSS; }
+
+	/// Rough size of a PM face (with its share of vertices, edges and
+	/// the per-vertex traits), used to turn the budget into face counts
+	enum { BYTES_PER_FACE = 400 };
+
+private:
+	/// Pass 1: vertices to the scratch file, bounding box, faces per
+	/// vertex
+	bool readVertices(const char* filename);
+
+	/// Cut the bounding box into chunks of at most facesPerChunk faces
+	void buildChunks(int facesPerChunk);
+
+	/// Pass 2: faces to the face scratch file, shared vertices
+	bool splitFaces(const char* filename);
+
+	/// Write the faces buffered for a chunk to its part of the scratch file
+	bool flushChunk(int chunk);
+
+	/// Pass 3: decimate one chunk, append it to the output
+	void decimateChunk(int chunk);
+
+	/// Leaf of the chunk tree that holds p
+	int chunkOf(const PM::Point& p) const;
+
+	void updatePeakRSS();
+
+	size_t memoryBudget, peakRSS;
+
+	// input
+	FILE* vertexFile;
+	int vertexCount, faceCount;
+	PM::Point bbox_min, bbox_max;
+
+	// faces that have vertex v as their first vertex, until the chunks
+	// are cut
+	std::vector<int> vertexFaces;
+
+	// Chunks are the leaves of a kd-tree over the bounding box. Node c
+	// is cut at split along axis into the nodes child and child+1, or
+	// is a leaf (child = -1) holding faces faces.
+	struct ChunkNode
+	{
+		PM::Point min, max;
+		int axis, child, depth, faces;
+		float split;
+	};
+	std::vector<ChunkNode> chunkTree;
+	float ratio;
+
+	// faces of chunk c: faceFile from face chunkStart[c], chunkFill[c]
+	// of them written so far, the rest in chunkBuffer[c]
+	FILE* faceFile;
+	std::vector<long> chunkStart;
+	std::vector<int> chunkFill;
+	std::vector<std::vector<int> > chunkBuffer;
+
+	std::vector<int> vertexChunk;
+	std::vector<bool> vertexShared;
+
+	// coarse output; shared vertices are added once
+	std::vector<PM::Point> outPoints;
+	std::vector<int> outTriangles;
+	std::map<int,int> sharedIndex;
+};
+
+#endif
@@ -1,43 +1,46 @@
-#ifndef TRIMESH_H
-#define TRIMESH_H
-
-// openmesh includes
-#include <OpenMesh/IO/BinaryHelper.hh>
-#include <OpenMesh/IO/MeshIO.hh>
-#include <OpenMesh/Mesh/Types/TriMesh_ArrayKernelT.hh>
-#ifdef _MSC_VER
-#  ifndef OM_STATIC_BUILD
-#  define OM_STATIC_BUILD
-#  endif
-#  define INCLUDE_TEMPLATES
-#  include <OpenMesh/IO/IOInstances.hh>
-#endif
-
-// openmesh tools
-#include <OpenMeshTools/Decimater/DecimaterT.hh>
-#include <OpenMeshTools/Decimater/ModQuadricT.hh>
-
-#include <vector>
-
-struct RelaxationTraits : public OpenMesh::DefaultTraits
-{	
-	FaceAttributes(OpenMesh::DefaultAttributer::Normal);
-
-	// Store Points as floats
-	typedef OpenMesh::Vec3f Point;
-
-	VertexTraits
-	{
-	public:		
-		// TODO why can't inherit directly?
-		OpenMesh::Geometry::QuadricT<double>  quadric;
-
-		Point orig_point;
-		std::vector<Point> detailVectors;
-	};
-};
-
-OM_Merge_Traits(RelaxationTraits, OpenMesh::Decimater::DefaultTraits, PMTraits);
-typedef OpenMesh::TriMesh_ArrayKernelT<PMTraits> PM;
-
+#ifndef TRIMESH_H
+#define TRIMESH_H
+
+// openmesh includes
+#include <OpenMesh/IO/BinaryHelper.hh>
+#include <OpenMesh/IO/MeshIO.hh>
+#include <OpenMesh/Mesh/Types/TriMesh_ArrayKernelT.hh>
+#ifdef _MSC_VER
+#  ifndef OM_STATIC_BUILD
+#  define OM_STATIC_BUILD
+#  endif
+#  define INCLUDE_TEMPLATES
+#  include <OpenMesh/IO/IOInstances.hh>
+#endif
+
+// openmesh tools
+#include <OpenMeshTools/Decimater/DecimaterT.hh>
+#include <OpenMeshTools/Decimater/ModQuadricT.hh>
+#include <OpenMeshTools/Decimater/ModQuadricSoAT.hh>
+
+#include <vector>
+
+// Only what editing and filtering need lives in the vertex. The decimater
+// keeps its quadrics, collapse targets and heap in side arrays that go
+// away after buildPM(), so Decimater::DefaultTraits is not merged in.
+struct RelaxationTraits : public OpenMesh::DefaultTraits
+{	
+	// status for collapse/split and garbage collection
+	VertexAttributes(OpenMesh::DefaultAttributer::Status);
+	EdgeAttributes(OpenMesh::DefaultAttributer::Status);
+	FaceAttributes(OpenMesh::DefaultAttributer::Status |
+		OpenMesh::DefaultAttributer::Normal);
+
+	// Store Points as floats
+	typedef OpenMesh::Vec3f Point;
+
+	VertexTraits
+	{
+	public:		
+		Point orig_point;
+	};
+};
+
+typedef OpenMesh::TriMesh_ArrayKernelT<RelaxationTraits> PM;
+
 #endif
\ No newline at end of file
@@ -1,285 +1,866 @@
-#include <iostream>
-#include "UnitTests.h"
-#include "TriMesh.h"
-#include "MeshOp.h"
-#include "DividedDifference.h"
-#include "Frame.h"
-
-#pragma warning(disable: 4018)  // signed/unsigned mismatch
-
-using namespace std;
-
-template <class Mesh>
-void print(Mesh& mesh, Mesh::HalfedgeHandle heh)
-{
-	PM::VertexHandle vh_to = mesh.to_vertex_handle(heh);
-	PM::VertexHandle vh_from = mesh.from_vertex_handle(heh);
-
-	PM::Point p_to = mesh.point(vh_to);
-	PM::Point p_from = mesh.point(vh_from);
-
-	cout << "[" << p_from << "]" << " -> [" << p_to << "]" << endl;
-}
-
-// TODO automatic test framework?
-
-void test_findTwoRingNeighborhood()
-{
-	cout << "\nTesting [test_findTwoRingNeighborhood].." << endl;
-
-	PM mesh;
-	OpenMesh::MeshIO::read_mesh(mesh, "triplesquare.obj");	
-
-	if (mesh.n_vertices() == 0) return;
-
-	PM::VertexHandle vh = mesh.handle(*mesh.vertices_begin());
-	vector<PM::VertexHandle> vertices = findTwoRingNeighborhood(mesh, vh);
-
-	int indx = 0;
-	PM::Point p;	
-
-	for (int i=0; i < vertices.size(); i++)
-	{
-        indx = vertices[i].idx();
-		p = mesh.point(vertices[i]);
-		cout << p << endl;
-	}
-
-}
-
-void test_findE2Neighborhood()
-{
-    cout << "\nTesting [test_findE2Neighborhood].." << endl;
-
-	PM mesh;
-	OpenMesh::MeshIO::read_mesh(mesh, "triplesquare.obj");	
-
-	if (mesh.n_vertices() == 0) return;
-
-	PM::VertexHandle vh = mesh.handle(*mesh.vertices_begin());
-	vector<PM::HalfedgeHandle> edges = findE2Neighborhood(mesh, vh);
-
-	for (int i=0; i < edges.size(); i++)
-	{        		
-		print(mesh, edges[i]);
-	}
-}
-
-void test_findDiamond()
-{
-    cout << "\nTesting [test_findDiamond].." << endl;
-
-	PM mesh;
-	OpenMesh::MeshIO::read_mesh(mesh, "triplesquare.obj");	
-
-	if (mesh.n_vertices() == 0) return;
-
-	PM::HalfedgeHandle heh = mesh.halfedge_handle(mesh.handle(*mesh.vertices_begin()));
-	vector<PM::VertexHandle> vertices = findDiamond(mesh, heh);
-
-	PM::Point p;	
-
-	cout << "The first edge: " << mesh.point(mesh.from_vertex_handle(heh)) << " " 
-		<< mesh.point(mesh.to_vertex_handle(heh)) << endl;
-
-	for (int i=0; i < vertices.size(); i++)
-	{
-		p = mesh.point(vertices[i]);
-		cout << p << endl;
-	}
-}
-
-void test_triangleArea()
-{
-	cout << "\nTesting [triangleArea].." << endl;
-
-	PM::Point a(0,0,0), b(0,0,1), c(1,0,0);
-
-	cout << "triangle area1: " << OpenMesh::Geometry::triangleArea(b, a, c) << endl;
-	cout << "triangle area2: " << OpenMesh::Geometry::triangleArea(b, c, a) << endl;
-}
-
-void test_computeHingeArea()
-{
-	cout << "\nTesting [computeHingeArea]..." << endl;
-	{ // Should be 0
-		PM::Point a(0,0,0), b(0,0,1), c(1,0,0), d(-1,0,0);
-		cout << "triangle hinge area: " << computeHingeArea(a, b, c, d) << endl;
-	}
-	{ // Should be 0
-		PM::Point a(0,0,0), b(0,0,1), c(1,0,0), d(0,-1,0);
-		cout << "triangle hinge area: " << computeHingeArea(a, b, c, d) << endl;
-	}
-
-	{ // Should be 1
-		PM::Point a(0,0,0), b(0,0,1), c(1,0,0), d(-1,0,0);
-		cout << "triangle hinge area: " << computeHingeArea(b, a, c, d) << endl;
-	}
-	{ // Should be 1
-		PM::Point a(0,0,0), b(0,0,1), c(1,0,0), d(0,-1,0);
-		cout << "triangle hinge area: " << computeHingeArea(b, a, c, d) << endl;
-	}
-
-	{ // (Plane) Should be 1/2
-		PM::Point a(0,0,0), b(0,0,1), c(1,0,1), d(-1,0,0);
-		cout << "triangle hinge area: " << computeHingeArea(b, a, c, d) << endl;
-	}
-	{ // (Non-planar) Should be 1/2
-		PM::Point a(0,0,0), b(0,0,1), c(0,1,1), d(-1,0,0);
-		cout << "triangle hinge area: " << computeHingeArea(b, a, c, d) << endl;
-	}
-
-	{ // (Plane) Should be 1/2
-		PM::Point a(0,0,0), b(0,0,1), c(2,0,1), d(-1,0,0);
-		cout << "triangle hinge area: " << computeHingeArea(a, b, c, d) << endl;
-	}
-	{ // (Non-planar) Should be 1/2
-		PM::Point a(0,0,0), b(0,0,1), c(0,2,1), d(-1,0,0);
-		cout << "triangle hinge area: " << computeHingeArea(a, b, c, d) << endl;
-	}
-}
-
-void test_calculateAreas()
-{
-    cout << "\nTesting [test_calculateAreas].." << endl;
-
-	PM mesh;
-	OpenMesh::MeshIO::read_mesh(mesh, "hinge-sharp.obj");	
-
-	if (mesh.n_vertices() == 0) return;	
-
-	store_original_mesh(mesh);
-
-	// TODO weird results when using vertex iter -> halfedge iter
-	//PM::VertexIter vit = mesh.vertices_begin();
-	PM::EdgeIter eit = mesh.edges_begin();
-	PM::EdgeHandle eh = mesh.handle(*eit);
-	PM::HalfedgeHandle heh = mesh.halfedge_handle(eh, 0);		
-	PM::HalfedgeHandle heh1 = mesh.next_halfedge_handle(heh);
-	PM::HalfedgeHandle heh2 = mesh.next_halfedge_handle(heh1);
-	print(mesh, heh);
-	print(mesh, heh1);
-	print(mesh, heh2);
-
-	PM::Scalar A_jkL1, A_jkL2, A_kL1L2, A_jL1L2;
-
-	calculateAreas(mesh, heh, A_jkL1, A_jkL2, A_kL1L2, A_jL1L2);
-
-	cout << "A_jkL1  = " << A_jkL1  << endl;
-	cout << "A_jkL2  = " << A_jkL2  << endl;
-	cout << "A_kL1L2 = " << A_kL1L2 << endl;
-	cout << "A_jL1L2 = " << A_jL1L2 << endl;
-}
-
-void test_coeff()
-{
-    cout << "\nTesting [test_coeff].." << endl;
-
-	PM mesh;
-	OpenMesh::MeshIO::read_mesh(mesh, "hinge.obj");	
-
-	PM::EdgeIter eit = mesh.edges_begin();
-	PM::EdgeHandle eh = mesh.handle(*eit);
-	PM::HalfedgeHandle heh = mesh.halfedge_handle(eh, 0);
-	PM::VertexHandle vh = mesh.from_vertex_handle(heh);
-	PM::Scalar c = coeff(mesh, heh, vh);
-}
-
-void test_weight()
-{
-    cout << "\nTesting [test_weight].." << endl;
-
-	PM mesh;
-	OpenMesh::MeshIO::read_mesh(mesh, "triplesquare.obj");	
-
-	if (mesh.n_vertices() == 0) return;
-
-	PM::EdgeIter eit = mesh.edges_begin();
-	PM::EdgeHandle eh = mesh.handle(*eit);
-	PM::HalfedgeHandle heh = mesh.halfedge_handle(eh, 0);
-	PM::VertexHandle from = mesh.from_vertex_handle(heh);
-	PM::VertexHandle to = mesh.to_vertex_handle(heh);
-
-	print(mesh, heh);
-
-	PM::Scalar weight = weight_ij(mesh, from, to);
-
-	cout << "Weight_ij = " << weight << endl;
-}
-
-void test_frame() 
-{
-	// Test that local frame is sane
-    cout << "\nTesting [test_frame].." << endl;
-
-	PM mesh;
-	OpenMesh::MeshIO::read_mesh(mesh, "hinge.obj");	
-
-	if (mesh.n_vertices() == 0) return;
-
-	PM::EdgeIter eit = mesh.edges_begin();
-	PM::EdgeHandle eh = mesh.handle(*eit);
-	PM::HalfedgeHandle heh = mesh.halfedge_handle(eh, 0);
-	PM::VertexHandle vh = mesh.from_vertex_handle(heh);
-
-	Frame<PM> frame(mesh, vh);
-	cout << "Frame: " << frame.U << " , " << frame.T << " , " << frame.V << endl;
-}
-
-void test_weight_sum() 
-{
-	// Test that weights of a vertex surrounded by planar
-	// traingles sum to unity
-	cout << "\nTesting [test_weight_sum].." << endl;
-
-	PM mesh;
-	OpenMesh::MeshIO::read_mesh(mesh, "funky-square.obj");	
-	store_original_mesh(mesh);
-
-	if (mesh.n_vertices() == 0) return;
-
-	PM::Point zero(0,0,0);
-
-	PM::VertexIter vit = mesh.vertices_begin();
-	while (vit != mesh.vertices_end() && mesh.point(*vit) != zero) ++vit;
-
-	if (vit == mesh.vertices_end())
-	{
-		cout << "Couldn't find 0 vertex!" << endl;
-	}
-
-	PM::VertexHandle vh_n = mesh.handle(*vit);
-
-	typedef std::vector<PM::VertexHandle> VertexHandles;
-	VertexHandles vertices = findTwoRingNeighborhood(mesh, vh_n);
-
-	PM::Scalar sum = PM::Scalar();
-
-	for (int i=0; i<vertices.size(); i++) 
-	{
-		PM::VertexHandle j = vertices[i];
-		// Relax new mesh, using weights from original mesh		
-		PM::Scalar weight = weight_ij(mesh, vh_n, j);		
-		cout << "w = " << weight << ", p = " << mesh.point(j) << endl;
-
-		sum += weight;
-	}
-
-	cout << "sum = " << sum << endl;
-}
-
-void run_tests()
-{	
-	//cout << "Running unit tests..." << endl;
-
-	//test_frame();
-	//test_weight();
-	//test_coeff();
-	//test_calculateAreas();
-	//test_computeHingeArea();
-	//test_triangleArea();
-	//test_findTwoRingNeighborhood();
-	//test_findE2Neighborhood();
-	//test_findDiamond();
-	//test_weight_sum();
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+#include "UnitTests.h"
+#include "TriMesh.h"
+#include "ProgressiveMesh.h"
+#include "PMCodec.h"
+#include "MeshOp.h"
+#include "DividedDifference.h"
+#include "Frame.h"
+
+#pragma warning(disable: 4018)  // signed/unsigned mismatch
+
+using namespace std;
+
+template <class Mesh>
+void print(Mesh& mesh, Mesh::HalfedgeHandle heh)
+{
+	PM::VertexHandle vh_to = mesh.to_vertex_handle(heh);
+	PM::VertexHandle vh_from = mesh.from_vertex_handle(heh);
+
+	PM::Point p_to = mesh.point(vh_to);
+	PM::Point p_from = mesh.point(vh_from);
+
+	cout << "[" << p_from << "]" << " -> [" << p_to << "]" << endl;
+}
+
+// TODO automatic test framework?
+
+void test_findTwoRingNeighborhood()
+{
+	cout << "\nTesting [test_findTwoRingNeighborhood].." << endl;
+
+	PM mesh;
+	OpenMesh::MeshIO::read_mesh(mesh, "triplesquare.obj");	
+
+	if (mesh.n_vertices() == 0) return;
+
+	PM::VertexHandle vh = mesh.handle(*mesh.vertices_begin());
+	vector<PM::VertexHandle> vertices = findTwoRingNeighborhood(mesh, vh);
+
+	int indx = 0;
+	PM::Point p;	
+
+	for (int i=0; i < vertices.size(); i++)
+	{
+        indx = vertices[i].idx();
+		p = mesh.point(vertices[i]);
+		cout << p << endl;
+	}
+
+}
+
+void test_findE2Neighborhood()
+{
+    cout << "\nTesting [test_findE2Neighborhood].." << endl;
+
+	PM mesh;
+	OpenMesh::MeshIO::read_mesh(mesh, "triplesquare.obj");	
+
+	if (mesh.n_vertices() == 0) return;
+
+	PM::VertexHandle vh = mesh.handle(*mesh.vertices_begin());
+	vector<PM::HalfedgeHandle> edges = findE2Neighborhood(mesh, vh);
+
+	for (int i=0; i < edges.size(); i++)
+	{        		
+		print(mesh, edges[i]);
+	}
+}
+
+void test_findDiamond()
+{
+    cout << "\nTesting [test_findDiamond].." << endl;
+
+	PM mesh;
+	OpenMesh::MeshIO::read_mesh(mesh, "triplesquare.obj");	
+
+	if (mesh.n_vertices() == 0) return;
+
+	PM::HalfedgeHandle heh = mesh.halfedge_handle(mesh.handle(*mesh.vertices_begin()));
+	vector<PM::VertexHandle> vertices = findDiamond(mesh, heh);
+
+	PM::Point p;	
+
+	cout << "The first edge: " << mesh.point(mesh.from_vertex_handle(heh)) << " " 
+		<< mesh.point(mesh.to_vertex_handle(heh)) << endl;
+
+	for (int i=0; i < vertices.size(); i++)
+	{
+		p = mesh.point(vertices[i]);
+		cout << p << endl;
+	}
+}
+
+void test_triangleArea()
+{
+	cout << "\nTesting [triangleArea].." << endl;
+
+	PM::Point a(0,0,0), b(0,0,1), c(1,0,0);
+
+	cout << "triangle area1: " << OpenMesh::Geometry::triangleArea(b, a, c) << endl;
+	cout << "triangle area2: " << OpenMesh::Geometry::triangleArea(b, c, a) << endl;
+}
+
+void test_computeHingeArea()
+{
+	cout << "\nTesting [computeHingeArea]..." << endl;
+	{ // Should be 0
+		PM::Point a(0,0,0), b(0,0,1), c(1,0,0), d(-1,0,0);
+		cout << "triangle hinge area: " << computeHingeArea(a, b, c, d) << endl;
+	}
+	{ // Should be 0
+		PM::Point a(0,0,0), b(0,0,1), c(1,0,0), d(0,-1,0);
+		cout << "triangle hinge area: " << computeHingeArea(a, b, c, d) << endl;
+	}
+
+	{ // Should be 1
+		PM::Point a(0,0,0), b(0,0,1), c(1,0,0), d(-1,0,0);
+		cout << "triangle hinge area: " << computeHingeArea(b, a, c, d) << endl;
+	}
+	{ // Should be 1
+		PM::Point a(0,0,0), b(0,0,1), c(1,0,0), d(0,-1,0);
+		cout << "triangle hinge area: " << computeHingeArea(b, a, c, d) << endl;
+	}
+
+	{ // (Plane) Should be 1/2
+		PM::Point a(0,0,0), b(0,0,1), c(1,0,1), d(-1,0,0);
+		cout << "triangle hinge area: " << computeHingeArea(b, a, c, d) << endl;
+	}
+	{ // (Non-planar) Should be 1/2
+		PM::Point a(0,0,0), b(0,0,1), c(0,1,1), d(-1,0,0);
+		cout << "triangle hinge area: " << computeHingeArea(b, a, c, d) << endl;
+	}
+
+	{ // (Plane) Should be 1/2
+		PM::Point a(0,0,0), b(0,0,1), c(2,0,1), d(-1,0,0);
+		cout << "triangle hinge area: " << computeHingeArea(a, b, c, d) << endl;
+	}
+	{ // (Non-planar) Should be 1/2
+		PM::Point a(0,0,0), b(0,0,1), c(0,2,1), d(-1,0,0);
+		cout << "triangle hinge area: " << computeHingeArea(a, b, c, d) << endl;
+	}
+}
+
+void test_calculateAreas()
+{
+    cout << "\nTesting [test_calculateAreas].." << endl;
+
+	PM mesh;
+	OpenMesh::MeshIO::read_mesh(mesh, "hinge-sharp.obj");	
+
+	if (mesh.n_vertices() == 0) return;	
+
+	store_original_mesh(mesh);
+
+	// TODO weird results when using vertex iter -> halfedge iter
+	//PM::VertexIter vit = mesh.vertices_begin();
+	PM::EdgeIter eit = mesh.edges_begin();
+	PM::EdgeHandle eh = mesh.handle(*eit);
+	PM::HalfedgeHandle heh = mesh.halfedge_handle(eh, 0);		
+	PM::HalfedgeHandle heh1 = mesh.next_halfedge_handle(heh);
+	PM::HalfedgeHandle heh2 = mesh.next_halfedge_handle(heh1);
+	print(mesh, heh);
+	print(mesh, heh1);
+	print(mesh, heh2);
+
+	PM::Scalar A_jkL1, A_jkL2, A_kL1L2, A_jL1L2;
+
+	calculateAreas(mesh, heh, A_jkL1, A_jkL2, A_kL1L2, A_jL1L2);
+
+	cout << "A_jkL1  = " << A_jkL1  << endl;
+	cout << "A_jkL2  = " << A_jkL2  << endl;
+	cout << "A_kL1L2 = " << A_kL1L2 << endl;
+	cout << "A_jL1L2 = " << A_jL1L2 << endl;
+}
+
+void test_coeff()
+{
+    cout << "\nTesting [test_coeff].." << endl;
+
+	PM mesh;
+	OpenMesh::MeshIO::read_mesh(mesh, "hinge.obj");	
+
+	PM::EdgeIter eit = mesh.edges_begin();
+	PM::EdgeHandle eh = mesh.handle(*eit);
+	PM::HalfedgeHandle heh = mesh.halfedge_handle(eh, 0);
+	PM::VertexHandle vh = mesh.from_vertex_handle(heh);
+	PM::Scalar c = coeff(mesh, heh, vh);
+}
+
+void test_weight()
+{
+    cout << "\nTesting [test_weight].." << endl;
+
+	PM mesh;
+	OpenMesh::MeshIO::read_mesh(mesh, "triplesquare.obj");	
+
+	if (mesh.n_vertices() == 0) return;
+
+	PM::EdgeIter eit = mesh.edges_begin();
+	PM::EdgeHandle eh = mesh.handle(*eit);
+	PM::HalfedgeHandle heh = mesh.halfedge_handle(eh, 0);
+	PM::VertexHandle from = mesh.from_vertex_handle(heh);
+	PM::VertexHandle to = mesh.to_vertex_handle(heh);
+
+	print(mesh, heh);
+
+	PM::Scalar weight = weight_ij(mesh, from, to);
+
+	cout << "Weight_ij = " << weight << endl;
+}
+
+void test_frame() 
+{
+	// Test that local frame is sane
+    cout << "\nTesting [test_frame].." << endl;
+
+	PM mesh;
+	OpenMesh::MeshIO::read_mesh(mesh, "hinge.obj");	
+
+	if (mesh.n_vertices() == 0) return;
+
+	PM::EdgeIter eit = mesh.edges_begin();
+	PM::EdgeHandle eh = mesh.handle(*eit);
+	PM::HalfedgeHandle heh = mesh.halfedge_handle(eh, 0);
+	PM::VertexHandle vh = mesh.from_vertex_handle(heh);
+
+	Frame<PM> frame(mesh, vh);
+	cout << "Frame: " << frame.U << " , " << frame.T << " , " << frame.V << endl;
+}
+
+void test_weight_sum() 
+{
+	// Test that weights of a vertex surrounded by planar
+	// traingles sum to unity
+	cout << "\nTesting [test_weight_sum].." << endl;
+
+	PM mesh;
+	OpenMesh::MeshIO::read_mesh(mesh, "funky-square.obj");	
+	store_original_mesh(mesh);
+
+	if (mesh.n_vertices() == 0) return;
+
+	PM::Point zero(0,0,0);
+
+	PM::VertexIter vit = mesh.vertices_begin();
+	while (vit != mesh.vertices_end() && mesh.point(*vit) != zero) ++vit;
+
+	if (vit == mesh.vertices_end())
+	{
+		cout << "Couldn't find 0 vertex!" << endl;
+	}
+
+	PM::VertexHandle vh_n = mesh.handle(*vit);
+
+	typedef std::vector<PM::VertexHandle> VertexHandles;
+	VertexHandles vertices = findTwoRingNeighborhood(mesh, vh_n);
+
+	PM::Scalar sum = PM::Scalar();
+
+	for (int i=0; i<vertices.size(); i++) 
+	{
+		PM::VertexHandle j = vertices[i];
+		// Relax new mesh, using weights from original mesh		
+		PM::Scalar weight = weight_ij(mesh, vh_n, j);		
+		cout << "w = " << weight << ", p = " << mesh.point(j) << endl;
+
+		sum += weight;
+	}
+
+	cout << "sum = " << sum << endl;
+}
+
+template <class Scalar>
+void compare_quadric_soa(PM& mesh, double tolerance)
+{
+	typedef OpenMesh::Decimater::ModQuadricT<PM> Quadrics;
+	typedef OpenMesh::Decimater::ModQuadricSoAT<PM,Scalar> QuadricsSoA;
+
+	Quadrics modQuadric(mesh);
+	QuadricsSoA modQuadricSoA(mesh);
+	modQuadric.initialize();
+	modQuadricSoA.initialize();
+
+	double maxError = 0.0;
+	int count = 0;
+
+	// every halfedge, in the order the decimater asks for them
+	for (PM::VertexIter vit = mesh.vertices_begin(); vit != mesh.vertices_end(); ++vit)
+	{
+		PM::VertexHandle vh = mesh.handle(*vit);
+
+		for (PM::VertexOHalfedgeIter voh_it(mesh, vh); voh_it; ++voh_it)
+		{
+			Quadrics::CollapseInfo ci(mesh, voh_it.handle());
+			double p = modQuadric.collapse_priority(ci);
+			double pSoA = modQuadricSoA.collapse_priority(ci);
+
+			double error = fabs(p - pSoA) / (fabs(p) > 1e-12 ? fabs(p) : 1.0);
+			if (error > maxError) maxError = error;
+			count++;
+		}
+	}
+
+	cout << count << " halfedges, sizeof(Scalar) = " << sizeof(Scalar) 
+		<< ", max relative error = " << maxError 
+		<< (maxError <= tolerance ? " (ok)" : " (FAILED)") << endl;
+}
+
+void test_quadric_soa()
+{
+	// Test that the batched quadric module agrees with ModQuadricT
+	cout << "\nTesting [test_quadric_soa].." << endl;
+
+	PM mesh;
+	OpenMesh::MeshIO::read_mesh(mesh, "manifold-cow.obj");	
+
+	if (mesh.n_vertices() == 0) return;
+
+	compare_quadric_soa<double>(mesh, 1e-6);
+	// float coefficients cancel in flat regions, only a coarse match
+	compare_quadric_soa<float>(mesh, 1e-2);
+}
+
+static void read_bytes(const char* filename, vector<char>& bytes)
+{
+	ifstream in(filename, ios::binary);
+	bytes.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+}
+
+void test_pm_file()
+{
+	// Test that a .pm file survives reading and writing it again
+	cout << "\nTesting [test_pm_file].." << endl;
+
+	ProgressiveMesh pm;
+	if (!pm.readFile("pawn.obj")) return;
+	pm.buildPM();
+	pm.writeFile("test_pm_file.pm");
+
+	ProgressiveMesh loaded;
+	bool ok = loaded.readPMFile("test_pm_file.pm");
+	cout << "Read: " << (ok ? "ok" : "FAILED") << endl;
+
+	cout << "Levels: " << loaded.getMinLevel() << ".." << loaded.getMaxLevel()
+		<< " (expected " << pm.getMinLevel() << ".." << pm.getMaxLevel() << ")" << endl;
+
+	loaded.writeFile("test_pm_file2.pm");
+
+	vector<char> a, b;
+	read_bytes("test_pm_file.pm", a);
+	read_bytes("test_pm_file2.pm", b);
+	cout << "Rewritten file identical: " << (a == b ? "yes" : "NO") 
+		<< " (" << a.size() << " bytes)" << endl;
+}
+
+void test_detail_vector_store()
+{
+	// Test that rewriting one split keeps the others intact, and that
+	// the compact precisions stay close
+	cout << "\nTesting [test_detail_vector_store].." << endl;
+
+	DetailVectorStore store;
+	vector<PM::Point> detail;
+	for (int r = 0; r < 4; r++)
+	{
+		detail.clear();
+		for (int d = 0; d <= r; d++)
+			detail.push_back(PM::Point(r, d, 0.001f * d));
+		store.write(r, &detail[0], detail.size());
+	}
+
+	// split 1 grows, split 2 gets none
+	detail.clear();
+	for (int d = 0; d < 5; d++)
+		detail.push_back(PM::Point(1, d, 0.001f * d));
+	store.write(1, &detail[0], detail.size());
+	store.write(2, NULL, 0);
+
+	bool ok = store.size() == 1 + 5 + 4 && store.get(2).empty() && store.get(7).empty();
+	for (int r = 0; r < 4; r++)
+	{
+		DetailVectorStore::Span span = store.get(r);
+		for (int d = 0; d < span.size(); d++)
+			ok = ok && span[d] == PM::Point(r, d, 0.001f * d);
+	}
+	cout << "Spans: " << (ok ? "ok" : "FAILED") << endl;
+
+	DetailVectorStore::Precision precisions[] = { DetailVectorStore::HALF, DetailVectorStore::INT16 };
+	for (int k = 0; k < 2; k++)
+	{
+		DetailVectorStore compact = store;
+		compact.setPrecision(precisions[k]);
+
+		float maxError = 0.0f;
+		for (int r = 0; r < 4; r++)
+			for (int d = 0; d < store.get(r).size(); d++)
+				maxError = max(maxError, (compact.get(r)[d] - store.get(r)[d]).norm());
+
+		cout << (k ? "int16" : "half") << ": " << compact.getMemoryUsage() << " bytes (full "
+			<< store.getMemoryUsage() << "), max error " << maxError << " (expected < 0.002)" << endl;
+	}
+}
+
+// Gives the tests the faces of the current level
+class LevelFaces : public ProgressiveMesh
+{
+public:
+	void faces(vector<vector<int> >& faces)
+	{
+		faces.clear();
+		for (PM::FaceIter f_it = mesh.faces_begin(); f_it != mesh.faces_end(); ++f_it)
+		{
+			if (mesh.face(f_it.handle()).deleted()) continue;
+
+			vector<int> face;
+			for (PM::FaceVertexIter fv_it = mesh.fv_iter(f_it.handle()); fv_it; ++fv_it)
+				face.push_back(fv_it.handle().idx());
+			rotate(face.begin(), min_element(face.begin(), face.end()), face.end());
+			faces.push_back(face);
+		}
+		sort(faces.begin(), faces.end());
+	}
+
+	void points(vector<PM::Point>& points)
+	{
+		points.resize(mesh.n_vertices());
+		for (int i = 0; i < points.size(); i++)
+			points[i] = mesh.point(PM::VertexHandle(i));
+	}
+
+	void setPoints(const vector<PM::Point>& points)
+	{
+		for (int i = 0; i < points.size(); i++)
+			mesh.set_point(PM::VertexHandle(i), points[i]);
+	}
+
+	/// Scale the detail vectors of the finer half, as a filter would
+	void scaleFineDetails(float factor)
+	{
+		for (int r = details.getSplitCount() / 2; r < details.getSplitCount(); r++)
+			details.scale(r, factor);
+	}
+
+	/// Scale the detail vectors of the splits that add a vertex near
+	/// center, as a filter with the sphere on would; returns them
+	vector<int> scaleDetailsNear(const PM::Point& center, float radius, float factor)
+	{
+		vector<int> splits;
+		for (int r = 0; r < vertexOrdering.size(); r++)
+		{
+			if ((mesh.point(vertexOrdering[r]) - center).norm() > radius) continue;
+			details.scale(r, factor);
+			splits.push_back(r);
+		}
+		return splits;
+	}
+
+	/// Detail vectors of every split, in refinement order
+	void detailVectors(vector<vector<PM::Point> >& out)
+	{
+		out.resize(details.getSplitCount());
+		for (int r = 0; r < out.size(); r++)
+		{
+			DetailVectorStore::Span detail = details.get(r);
+			out[r].resize(detail.size());
+			for (int i = 0; i < detail.size(); i++)
+				out[r][i] = detail[i];
+		}
+	}
+
+	float getDiagonal() { return (bbox_max - bbox_min).norm(); }
+
+	/// The vertex every split adds, in refinement order
+	void splitVertices(vector<int>& vertices)
+	{
+		vertices.resize(vertexOrdering.size());
+		for (int r = 0; r < vertices.size(); r++)
+			vertices[r] = vertexOrdering[r].idx();
+	}
+
+	bool isActive(int v) { return !mesh.vertex(PM::VertexHandle(v)).deleted(); }
+
+	/// Where scaling the detail vectors of every split by the factor
+	/// interpolated from the band factors puts the vertices, replayed
+	/// from the last replay's start in its frames, as the bands assume
+	void frozenReplay(const vector<float>& factors, vector<PM::Point>& points)
+	{
+		vector<PM::Point> frames;
+		replay.freezeFrames(frames);
+
+		int splitCount = vertexOrdering.size();
+		vector<float> splitFactors(details.getSplitCount());
+		for (int r = 0; r < splitFactors.size(); r++)
+			splitFactors[r] = DetailBands::interpolate(factors, r, splitCount);
+
+		points = replay.getBaselineStart();
+		if (!points.empty()) replay.runFrozen(&points[0], details, frames, splitFactors);
+	}
+
+	/// Vertices in the order writeCompressedPM() numbers them: the base
+	/// mesh, then the vertex of every split, coarsest first
+	void compressedOrder(vector<int>& order)
+	{
+		int level = currentVCount;
+		coarsenToLevelN(minVCount);
+
+		order.clear();
+		for (PM::VertexIter v_it = mesh.vertices_begin(); v_it != mesh.vertices_end(); ++v_it)
+			if (!mesh.vertex(v_it.handle()).deleted()) order.push_back(v_it.handle().idx());
+		for (int r = 0; r < vertexOrdering.size(); r++)
+			order.push_back(vertexOrdering[r].idx());
+
+		refineToLevelN(level);
+	}
+};
+
+void test_pmz()
+{
+	// Test that a .pmz file reads back with the same levels and faces,
+	// the points within half a quantization step, and details that the
+	// loaded model rebuilds
+	cout << "\nTesting [test_pmz].." << endl;
+
+	LevelFaces pm;
+	if (!pm.readFile("pawn.obj")) return;
+	pm.buildPM();
+	bool ok = pm.writeFile("test_pmz.pmz");
+
+	LevelFaces loaded;
+	ok = ok && loaded.readCompressedPM("test_pmz.pmz");
+	cout << "Read: " << (ok ? "ok" : "FAILED") << endl;
+	if (!ok) return;
+
+	cout << "Levels: " << loaded.getMinLevel() << ".." << loaded.getMaxLevel()
+		<< " (expected " << pm.getMinLevel() << ".." << pm.getMaxLevel() << ")" << endl;
+
+	pm.refineToLevelN(pm.getMaxLevel());
+
+	vector<int> order, newIndex;
+	pm.compressedOrder(order);
+	newIndex.assign(order.size(), -1);
+	for (int i = 0; i < order.size(); i++)
+		newIndex[order[i]] = i;
+
+	// faces, renumbered as in the file
+	vector<vector<int> > faces, loadedFaces;
+	pm.faces(faces);
+	loaded.faces(loadedFaces);
+	for (int f = 0; f < faces.size(); f++)
+	{
+		for (int k = 0; k < faces[f].size(); k++)
+			faces[f][k] = newIndex[faces[f][k]];
+		rotate(faces[f].begin(), min_element(faces[f].begin(), faces[f].end()), faces[f].end());
+	}
+	sort(faces.begin(), faces.end());
+	cout << "Faces matching: " << (faces == loadedFaces ? "yes" : "NO") << " (" 
+		<< loadedFaces.size() << " of " << faces.size() << ")" << endl;
+
+	vector<char> bytes;
+	read_bytes("test_pmz.pmz", bytes);
+	PMZHeader header;
+	memcpy(&header, &bytes[0], sizeof(header));
+
+	vector<PM::Point> points, loadedPoints;
+	pm.points(points);
+	loaded.points(loadedPoints);
+
+	float maxError = 0.0f;
+	for (int i = 0; i < min(order.size(), loadedPoints.size()); i++)
+		for (int k = 0; k < 3; k++)
+			maxError = max(maxError, float(fabs(points[order[i]][k] - loadedPoints[i][k])));
+
+	bool same = order.size() == loadedPoints.size() && maxError <= 0.5f * header.step * 1.001f;
+	cout << "Points within half a step: " << (same ? "yes" : "NO") << " (" << loadedPoints.size() 
+		<< " of " << order.size() << ", max error " << maxError << ", step " << header.step << ")" << endl;
+
+	// details rebuilt on the loaded model, in its own frames, against the
+	// ones read back: they only agree if the frames survived renumbering
+	vector<vector<PM::Point> > read, rebuilt;
+	loaded.detailVectors(read);
+	loaded.coarsenToLevelN(loaded.getMinLevel());
+	loaded.computeDetailVectors(loaded.getMaxLevel());
+	loaded.detailVectors(rebuilt);
+
+	float maxDetailError = 0.0f, tolerance = 1e-3f * pm.getDiagonal();
+	bool sameSizes = read.size() == rebuilt.size();
+	for (int r = 0; sameSizes && r < read.size(); r++)
+	{
+		if (read[r].size() != rebuilt[r].size()) { sameSizes = false; break; }
+		for (int i = 0; i < read[r].size(); i++)
+			maxDetailError = max(maxDetailError, (read[r][i] - rebuilt[r][i]).norm());
+	}
+
+	same = sameSizes && maxDetailError <= tolerance;
+	cout << "Rebuilt details matching: " << (same ? "yes" : "NO") << " (max error " << maxDetailError 
+		<< ", tolerance " << tolerance << " = 1e-3 of the diagonal)" << endl;
+}
+
+void test_checkpoints()
+{
+	// Test that jumping through checkpoints gives the same mesh as 
+	// stepping one level at a time
+	cout << "\nTesting [test_checkpoints].." << endl;
+
+	LevelFaces pm;
+	if (!pm.readFile("pawn.obj")) return;
+	pm.buildPM();
+
+	int levels[] = { pm.getMinLevel(), pm.getMaxLevel(), pm.getMinLevel() + 7, 
+		(pm.getMinLevel() + pm.getMaxLevel()) / 2, pm.getMaxLevel() - 3, pm.getMinLevel() + 1 };
+	int failed = 0, interval = 0;
+
+	for (int i = 0; i < sizeof(levels) / sizeof(levels[0]); i++)
+	{
+		vector<vector<int> > jumped, stepped;
+
+		pm.setCheckpointBudget(256 << 10);
+		pm.jumpToLevelN(levels[i]);
+		pm.faces(jumped);
+		interval = pm.getCheckpointInterval();
+
+		pm.setCheckpointBudget(0);
+		pm.jumpToLevelN(pm.getMaxLevel());
+		pm.jumpToLevelN(levels[i]);
+		pm.faces(stepped);
+
+		if (jumped != stepped) failed++;
+	}
+
+	cout << "Checkpoint jumps matching steps: " << (failed ? "NO" : "yes") 
+		<< " (" << failed << " levels differ, checkpoints every " << interval << " levels)" << endl;
+}
+
+// Everything
+class AllRegion : public Region
+{
+public:
+	virtual bool contains(const PM& mesh, PM::VertexHandle vh) const { return true; }
+};
+
+void test_selective_refinement()
+{
+	// Test that refining a region, then the rest, gives the finest mesh,
+	// and that coarsening the region again undoes it
+	cout << "\nTesting [test_selective_refinement].." << endl;
+
+	LevelFaces pm;
+	if (!pm.readFile("pawn.obj")) return;
+	pm.buildPM();
+
+	vector<vector<int> > finest, base, selective;
+	pm.jumpToLevelN(pm.getMaxLevel());
+	pm.faces(finest);
+	pm.jumpToLevelN(pm.getMinLevel());
+	pm.faces(base);
+
+	// around a vertex halfway down the hierarchy, so that some splits
+	// are in and some are not
+	vector<int> added;
+	vector<PM::Point> points;
+	pm.splitVertices(added);
+	pm.points(points);
+	if (added.empty()) return;
+	PM::Point center = points[added[added.size() / 2]];
+	float radius = 0.15f * pm.getDiagonal();
+	SphereRegion sphere(center, radius);
+
+	int vertices = pm.refineRegion(sphere);
+	bool partial = pm.getMinLevel() < vertices && vertices < pm.getMaxLevel();
+	cout << "Refined region to " << vertices << " vertices, between " << pm.getMinLevel() 
+		<< " and " << pm.getMaxLevel() << ": " << (partial ? "yes" : "NO") << endl;
+
+	int inside = 0, inactiveInside = 0, inactiveOutside = 0;
+	for (int r = 0; r < added.size(); r++)
+	{
+		bool in = (points[added[r]] - center).sqrnorm() <= radius * radius;
+		if (in) inside++;
+		if (!pm.isActive(added[r]))
+		{
+			if (in) inactiveInside++;
+			else inactiveOutside++;
+		}
+	}
+	cout << "Region active, some of the rest not: " << (inside > 0 && inactiveInside == 0 && inactiveOutside > 0 ? "yes" : "NO") 
+		<< " (" << inside << " splits in the region, " << inactiveInside << " of them not done, " 
+		<< inactiveOutside << " outside not done)" << endl;
+
+	pm.coarsenRegion(sphere);
+	pm.faces(selective);
+	cout << "Coarsened back to base: " << (selective == base ? "yes" : "NO") << endl;
+
+	pm.refineRegion(sphere);
+	pm.refineRegion(AllRegion());
+	pm.faces(selective);
+	cout << "Region, then the rest, gives the finest mesh: " 
+		<< (selective == finest ? "yes" : "NO") << endl;
+}
+
+void test_parallel_details()
+{
+	// Test that detail vectors computed a run of splits at a time are
+	// the same, bit for bit, as one split at a time
+	cout << "\nTesting [test_parallel_details].." << endl;
+
+	ProgressiveMesh serial, parallel;
+	serial.setParallelDetailVectors(false);
+	parallel.setParallelDetailVectors(true);
+	if (!serial.readFile("pawn.obj") || !parallel.readFile("pawn.obj")) return;
+	serial.buildPM();
+	parallel.buildPM();
+
+	const DetailVectorStore& a = serial.getDetailVectors();
+	const DetailVectorStore& b = parallel.getDetailVectors();
+	int differ = 0;
+	for (int r = 0; r < max(a.getSplitCount(), b.getSplitCount()); r++)
+	{
+		DetailVectorStore::Span sa = a.get(r), sb = b.get(r);
+		bool same = sa.size() == sb.size();
+		for (int d = 0; same && d < sa.size(); d++)
+		{
+			PM::Point pa = sa[d], pb = sb[d];
+			same = memcmp(&pa, &pb, sizeof(PM::Point)) == 0;
+		}
+		if (!same) differ++;
+	}
+
+	cout << "Parallel detail vectors matching serial: " << (differ ? "NO" : "yes") 
+		<< " (" << differ << " of " << a.getSplitCount() << " splits differ)" << endl;
+}
+
+void test_replay()
+{
+	// Test that the compiled replay puts every vertex exactly where
+	// restoring does, after the detail vectors changed
+	cout << "\nTesting [test_replay].." << endl;
+
+	LevelFaces pm;
+	if (!pm.readFile("pawn.obj")) return;
+	pm.buildPM();
+	pm.scaleFineDetails(0.5f);
+
+	vector<PM::Point> before, restored, replayed;
+	pm.points(before);
+	pm.coarsenToLevelN(pm.getMinLevel());
+	pm.restoreDetailVectors(pm.getMaxLevel());
+	pm.points(restored);
+
+	pm.setPoints(before);
+	pm.replayDetailVectors();
+	pm.points(replayed);
+
+	bool same = restored.size() == replayed.size() && (restored.empty() ||
+		memcmp(&restored[0], &replayed[0], restored.size() * sizeof(PM::Point)) == 0);
+	cout << "Replay matching restore: " << (same ? "yes" : "NO") 
+		<< " (level " << pm.getCurrentLevel() << " of " << pm.getMaxLevel() << ")" << endl;
+}
+
+void test_incremental_replay()
+{
+	// Test that replaying only what changed detail vectors reach gives
+	// the same as replaying everything
+	cout << "\nTesting [test_incremental_replay].." << endl;
+
+	LevelFaces pm;
+	if (!pm.readFile("pawn.obj")) return;
+	pm.buildPM();
+
+	vector<PM::Point> start, incremental, full;
+	pm.points(start);
+	pm.replayDetailVectors();
+
+	// a radius relative to the model, as bench_region has, so that the
+	// change reaches some splits but not all
+	vector<int> changed = pm.scaleDetailsNear(start[0], 0.1f * pm.getDiagonal(), 0.5f);
+	int evaluated = pm.replayDetailVectors(changed);
+	pm.points(incremental);
+
+	int splits = pm.getMaxLevel() - pm.getMinLevel();
+	bool partial = !changed.empty() && int(changed.size()) < evaluated && evaluated < splits;
+	cout << "Evaluated more than changed, less than all: " << (partial ? "yes" : "NO") << " (" 
+		<< changed.size() << " splits changed, " << evaluated << " of " << splits << " evaluated)" << endl;
+
+	pm.setPoints(start);
+	pm.replayDetailVectors();
+	pm.points(full);
+
+	bool same = incremental.size() == full.size() && (full.empty() ||
+		memcmp(&incremental[0], &full[0], full.size() * sizeof(PM::Point)) == 0);
+	cout << "Incremental replay matching full: " << (same ? "yes" : "NO") << endl;
+}
+
+void test_detail_bands()
+{
+	// Test that bands all scaled by 1 put the vertices where replaying
+	// does, and bands with one boosted where scaling every split by its
+	// interpolated factor does in the same frozen frames, up to rounding
+	cout << "\nTesting [test_detail_bands].." << endl;
+
+	LevelFaces pm;
+	if (!pm.readFile("pawn.obj")) return;
+	pm.buildPM();
+	pm.setDetailBands(8);
+
+	vector<PM::Point> replayed, banded, frozen;
+	pm.replayDetailVectors();
+	pm.points(replayed);
+
+	// the reference needs the baseline, which applying the bands drops
+	vector<float> boosted(8, 1.0f);
+	boosted[3] = 2.0f;
+	pm.frozenReplay(boosted, frozen);
+
+	bool applied = pm.applyDetailBands(vector<float>(8, 1.0f));
+	pm.points(banded);
+
+	float maxError = 0.0f;
+	for (int i = 0; i < min(replayed.size(), banded.size()); i++)
+		maxError = max(maxError, (replayed[i] - banded[i]).norm());
+
+	cout << "Bands matching replay: " << (applied && maxError < 1e-4f ? "yes" : "NO") 
+		<< " (max error " << maxError << ")" << endl;
+
+	// compounds with the factors of 1 before
+	applied = pm.applyDetailBands(boosted);
+	pm.points(banded);
+
+	maxError = 0.0f;
+	for (int i = 0; i < min(frozen.size(), banded.size()); i++)
+		maxError = max(maxError, (frozen[i] - banded[i]).norm());
+
+	float tolerance = 1e-5f * pm.getDiagonal();
+	bool same = applied && frozen.size() == banded.size() && maxError <= tolerance;
+	cout << "Boosted band matching frozen replay: " << (same ? "yes" : "NO") << " (max error " 
+		<< maxError << ", tolerance " << tolerance << " = 1e-5 of the diagonal)" << endl;
+}
+
+void run_tests()
+{	
+	//cout << "Running unit tests..." << endl;
+
+	//test_frame();
+	//test_weight();
+	//test_coeff();
+	//test_calculateAreas();
+	//test_computeHingeArea();
+	//test_triangleArea();
+	//test_findTwoRingNeighborhood();
+	//test_findE2Neighborhood();
+	//test_findDiamond();
+	//test_weight_sum();
+	//test_quadric_soa();
+	//test_pm_file();
+	//test_pmz();
+	//test_detail_vector_store();
+	//test_checkpoints();
+	//test_selective_refinement();
+	//test_parallel_details();
+	//test_replay();
+	//test_incremental_replay();
+	//test_detail_bands();
 }
\ No newline at end of file
@@ -1,7 +1,7 @@
-#ifndef UNITTESTS_H
-#define UNITTESTS_H
-
-// Unautomated unit test framework
-void run_tests();
-
+#ifndef UNITTESTS_H
+#define UNITTESTS_H
+
+// Unautomated unit test framework
+void run_tests();
+
 #endif
\ No newline at end of file
@@ -0,0 +1,211 @@
+#include <stdlib.h>
+#include <math.h>
+#include <algorithm>
+#include <iostream>
+#include "VertexClustering.h"
+#include "OBJStream.h"
+
+#pragma warning(disable: 4018)  // signed/unsigned mismatch
+
+using namespace std;
+
+bool VertexClustering::readOBJ(const char* filename)
+{
+	OBJStream obj;
+	if (!obj.open(filename)) return false;
+
+	points.clear();
+	triangles.clear();
+
+	PM::Point p;
+	int tri[3];
+	OBJStream::Record record;
+
+	while ((record = obj.next(p, tri)) != OBJStream::END)
+	{
+		if (record == OBJStream::VERTEX)
+			points.push_back(p);
+		else
+			triangles.insert(triangles.end(), tri, tri + 3);
+	}
+
+	if (points.empty()) return false;
+
+	// drop faces with bad indices
+	int n = 0;
+	for (int t = 0; t < triangles.size(); t += 3)
+	{
+		bool valid = true;
+		for (int k = 0; k < 3; k++)
+			if (triangles[t+k] < 0 || triangles[t+k] >= points.size()) valid = false;
+
+		if (!valid) continue;
+		for (int k = 0; k < 3; k++)
+			triangles[n++] = triangles[t+k];
+	}
+	triangles.resize(n);
+
+	// bounding box
+	bbox_min = bbox_max = points[0];
+	for (int i = 0; i < points.size(); i++)
+	{
+		for (int k = 0; k < 3; k++)
+		{
+			bbox_min[k] = min(bbox_min[k], points[i][k]);
+			bbox_max[k] = max(bbox_max[k], points[i][k]);
+		}
+	}
+
+	cout << points.size() << " vertices, " << triangles.size() / 3 << " triangles read." << endl;
+	return true;
+}
+
+float VertexClustering::cellSize(int res) const
+{
+	PM::Point extent = bbox_max - bbox_min;
+	float longest = max(extent[0], max(extent[1], extent[2]));
+	if (longest <= 0.0f) longest = 1.0f;
+
+	return longest / res;
+}
+
+VertexClustering::Cell VertexClustering::cellOf(const PM::Point& p, float cellSize) const
+{
+	Cell c;
+	c.x = int((p[0] - bbox_min[0]) / cellSize);
+	c.y = int((p[1] - bbox_min[1]) / cellSize);
+	c.z = int((p[2] - bbox_min[2]) / cellSize);
+	return c;
+}
+
+int VertexClustering::countCells(int res) const
+{
+	float size = cellSize(res);
+
+	std::vector<Cell> cells(points.size());
+	for (int i = 0; i < points.size(); i++)
+		cells[i] = cellOf(points[i], size);
+
+	sort(cells.begin(), cells.end());
+	return unique(cells.begin(), cells.end()) - cells.begin();
+}
+
+int VertexClustering::findResolution(int targetVertexCount) const
+{
+	// Occupied cells of a surface grow with the square of the
+	// resolution; correct the estimate a few times.
+	int res = 64;
+
+	for (int i = 0; i < 6; i++)
+	{
+		int count = countCells(res);
+		if (abs(count - targetVertexCount) < targetVertexCount / 20) break;
+
+		int next = int(res * sqrt(double(targetVertexCount) / double(max(count, 1))) + 0.5);
+		next = max(1, min(next, 1 << 20));
+		if (next == res) break;
+		res = next;
+	}
+
+	return res;
+}
+
+void VertexClustering::cluster(int targetVertexCount)
+{
+	int n = points.size();
+
+	clusterMap.resize(n);
+	clusterPoints.clear();
+	clusterTriangles.clear();
+
+	if (targetVertexCount >= n || targetVertexCount <= 0)
+	{
+		// nothing to do
+		gridResolution = 0;
+		for (int i = 0; i < n; i++) clusterMap[i] = i;
+		clusterPoints = points;
+		clusterTriangles = triangles;
+		return;
+	}
+
+	gridResolution = findResolution(targetVertexCount);
+	float size = cellSize(gridResolution);
+
+	// sort vertices by cell; a run of equal cells is one cluster
+	typedef std::pair<Cell, int> CellVertex;
+	std::vector<CellVertex> cells(n);
+	for (int i = 0; i < n; i++)
+		cells[i] = CellVertex(cellOf(points[i], size), i);
+
+	sort(cells.begin(), cells.end());
+
+	for (int first = 0; first < n; )
+	{
+		int last = first;
+		PM::Point sum(0, 0, 0);
+
+		while (last < n && cells[last].first == cells[first].first)
+		{
+			clusterMap[cells[last].second] = clusterPoints.size();
+			sum += points[cells[last].second];
+			last++;
+		}
+
+		clusterPoints.push_back(sum / float(last - first));
+		first = last;
+	}
+
+	// remap triangles, drop degenerate and duplicate ones
+	typedef std::pair<std::pair<int,int>,int> TriangleKey;
+	std::vector< std::pair<TriangleKey,int> > keys;
+
+	for (int t = 0; t < triangles.size(); t += 3)
+	{
+		int a = clusterMap[triangles[t]], b = clusterMap[triangles[t+1]], c = clusterMap[triangles[t+2]];
+		if (a == b || b == c || c == a) continue;
+
+		int v[3] = { a, b, c };
+		sort(v, v + 3);
+		keys.push_back(std::make_pair(TriangleKey(std::make_pair(v[0], v[1]), v[2]), t));
+	}
+
+	sort(keys.begin(), keys.end());
+
+	for (int k = 0; k < keys.size(); k++)
+	{
+		if (k > 0 && keys[k].first == keys[k-1].first) continue;
+
+		int t = keys[k].second;
+		for (int i = 0; i < 3; i++)
+			clusterTriangles.push_back(clusterMap[triangles[t+i]]);
+	}
+
+	cout << "Clustered " << n << " vertices into " << clusterPoints.size()
+		<< " (grid " << gridResolution << "), " << clusterTriangles.size() / 3
+		<< " triangles left." << endl;
+}
+
+int VertexClustering::buildMesh(PM& mesh)
+{
+	mesh.clear();
+
+	std::vector<PM::VertexHandle> vhandles(clusterPoints.size());
+	for (int i = 0; i < clusterPoints.size(); i++)
+		vhandles[i] = mesh.add_vertex(clusterPoints[i]);
+
+	// clustering does not preserve manifoldness, OpenMesh refuses the
+	// faces that would break it
+	int dropped = 0;
+	for (int t = 0; t < clusterTriangles.size(); t += 3)
+	{
+		PM::FaceHandle fh = mesh.add_face(vhandles[clusterTriangles[t]],
+			vhandles[clusterTriangles[t+1]], vhandles[clusterTriangles[t+2]]);
+
+		if (!fh.is_valid()) dropped++;
+	}
+
+	if (dropped > 0)
+		cout << dropped << " non-manifold triangles dropped." << endl;
+
+	return dropped;
+}
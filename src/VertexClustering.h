@@ -0,0 +1,75 @@
+// Uniform grid vertex clustering (Rossignac and Borrel), used to cut
+// huge scanned meshes down before the quadric decimater sees them.
+//
+// The input is read into flat arrays (points and index triples), so a
+// mesh too large for PM with its per-vertex quadrics and detail vectors
+// can still be clustered. All vertices in one grid cell merge into
+// their mean; triangles that collapse to an edge or point, or that
+// duplicate another triangle, are dropped.
+//
+// clusterMap maps every original vertex to its cluster, which is also
+// its vertex index in the mesh written by buildMesh().
+
+#ifndef VERTEX_CLUSTERING_H
+#define VERTEX_CLUSTERING_H
+
+#include <vector>
+#include "TriMesh.h"
+
+class VertexClustering
+{
+public:
+	VertexClustering() : gridResolution(0) {}
+
+	/// Read vertices and faces of an OBJ file (polygons are fanned)
+	bool readOBJ(const char* filename);
+
+	/// Cluster to roughly targetVertexCount vertices
+	void cluster(int targetVertexCount);
+
+	/// Build the clustered mesh, returns the number of faces dropped
+	/// because they would make the mesh non-manifold
+	int buildMesh(PM& mesh);
+
+	int getVertexCount() const { return points.size(); }
+	int getClusterCount() const { return clusterPoints.size(); }
+	int getGridResolution() const { return gridResolution; }
+
+	/// Original vertex index -> cluster index
+	std::vector<int> clusterMap;
+
+private:
+	/// Grid cell of a point, for a grid with res cells along the longest side
+	struct Cell
+	{
+		int x, y, z;
+		bool operator<(const Cell& c) const
+		{
+			if (x != c.x) return x < c.x;
+			if (y != c.y) return y < c.y;
+			return z < c.z;
+		}
+		bool operator==(const Cell& c) const { return x == c.x && y == c.y && z == c.z; }
+	};
+
+	Cell cellOf(const PM::Point& p, float cellSize) const;
+
+	/// Number of occupied cells at a given resolution
+	int countCells(int res) const;
+
+	/// Grid resolution giving about targetVertexCount occupied cells
+	int findResolution(int targetVertexCount) const;
+
+	float cellSize(int res) const;
+
+	std::vector<PM::Point> points;
+	std::vector<int> triangles;
+
+	std::vector<PM::Point> clusterPoints;
+	std::vector<int> clusterTriangles;
+
+	PM::Point bbox_min, bbox_max;
+	int gridResolution;
+};
+
+#endif
@@ -0,0 +1,75 @@
+#include <algorithm>
+#include "VertexHierarchy.h"
+
+#pragma warning(disable: 4018)  // signed/unsigned mismatch
+
+using namespace std;
+
+void VertexHierarchy::clear()
+{
+	splitCount = 0;
+	intro.clear();
+	parent.clear();
+	depStart.clear();
+	deps.clear();
+	touched.clear();
+}
+
+void VertexHierarchy::begin(int vertexCount)
+{
+	clear();
+	intro.assign(vertexCount, -1);
+	parent.assign(vertexCount, -1);
+	touched.resize(vertexCount);
+	depStart.push_back(0);
+}
+
+void VertexHierarchy::addSplit(int v0, int v1, const vector<int>& ring)
+{
+	int r = splitCount++;
+
+	intro[v0] = r;
+	parent[v0] = v1;
+
+	// everything that shaped the one-ring of v1 so far
+	vector<int>& before = touched[v1];
+	sort(before.begin(), before.end());
+	before.erase(unique(before.begin(), before.end()), before.end());
+	deps.insert(deps.end(), before.begin(), before.end());
+	depStart.push_back(deps.size());
+
+	// r depends on all of them, so later splits of v1 only need r
+	before.assign(1, r);
+	touched[v0].assign(1, r);
+
+	for (int i = 0; i < ring.size(); i++)
+		if (ring[i] != v1) touched[ring[i]].push_back(r);
+}
+
+void VertexHierarchy::end()
+{
+	vector<vector<int> >().swap(touched);
+}
+
+void VertexHierarchy::markWithDependencies(int r, vector<char>& marked, vector<int>& added) const
+{
+	if (marked[r]) return;
+
+	int first = added.size();
+	marked[r] = 1;
+	added.push_back(r);
+
+	// the new ones double as the stack
+	for (int i = first; i < added.size(); i++)
+	{
+		int s = added[i];
+		for (const int* d = dependenciesBegin(s); d != dependenciesEnd(s); ++d)
+		{
+			if (!marked[*d])
+			{
+				marked[*d] = 1;
+				added.push_back(*d);
+			}
+		}
+	}
+}
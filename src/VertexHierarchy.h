@@ -0,0 +1,155 @@
+/*
+@file VertexHierarchy.h
+
+The splits of a progressive mesh as a vertex hierarchy, for selective
+refinement (after Hoppe, "View-dependent refinement of progressive
+meshes"). Every vertex a split adds is a child of the vertex it splits
+from, which gives a forest with the base mesh vertices at the roots.
+
+Splits don't have to be done in the order of pmInfos: split r only
+needs the splits that shaped the one-ring of its v1 up to then. Those
+are its dependencies: the split that added v1, and every earlier split
+whose new vertex was a neighbor of v1. Any set of splits that contains
+the dependencies of its members can be done in refinement order and
+gives the same one-rings around them as the full sequence.
+
+Splits are numbered in refinement order, 0 = the coarsest.
+*/
+#ifndef VERTEXHIERARCHY_H
+#define VERTEXHIERARCHY_H
+
+#include <vector>
+#include "TriMesh.h"
+
+class VertexHierarchy
+{
+public:
+
+	VertexHierarchy() : splitCount(0) {}
+
+	void clear();
+	bool empty() const { return splitCount == 0; }
+
+	/// Start building for vertexCount vertices
+	void begin(int vertexCount);
+
+	/// Add the next split, of v1 into v1 and v0; ring is the one-ring of
+	/// v0 right after the split
+	void addSplit(int v0, int v1, const std::vector<int>& ring);
+
+	/// Done building
+	void end();
+
+	int getSplitCount() const { return splitCount; }
+
+	/// Split that adds v, -1 for base mesh vertices
+	int getIntroducingSplit(int v) const { return intro[v]; }
+
+	/// Vertex that v is split from, -1 for base mesh vertices
+	int getParent(int v) const { return parent[v]; }
+
+	/// Splits that have to be done before split r
+	const int* dependenciesBegin(int r) const { return deps.empty() ? NULL : &deps[0] + depStart[r]; }
+	const int* dependenciesEnd(int r) const { return deps.empty() ? NULL : &deps[0] + depStart[r+1]; }
+
+	/// Mark split r and everything it depends on in marked; the newly
+	/// marked splits are appended to added
+	void markWithDependencies(int r, std::vector<char>& marked, std::vector<int>& added) const;
+
+private:
+
+	int splitCount;
+	std::vector<int> intro, parent;
+
+	// dependencies of split r: deps[depStart[r]..depStart[r+1])
+	std::vector<int> depStart, deps;
+
+	// while building: splits that changed the one-ring of each vertex
+	// since its last split
+	std::vector<std::vector<int> > touched;
+};
+
+/// Where to refine, see ProgressiveMesh::refineRegion()
+class Region
+{
+public:
+	virtual ~Region() {}
+	virtual bool contains(const PM& mesh, PM::VertexHandle vh) const = 0;
+};
+
+class SphereRegion : public Region
+{
+public:
+	SphereRegion(const PM::Point& center, float radius) : center(center), radius(radius) {}
+
+	virtual bool contains(const PM& mesh, PM::VertexHandle vh) const
+	{
+		return (mesh.point(vh) - center).sqrnorm() <= radius * radius;
+	}
+
+private:
+	PM::Point center;
+	float radius;
+};
+
+/// Intersection of half spaces normal|p + d >= 0, e.g. the six planes of
+/// a view frustum
+class FrustumRegion : public Region
+{
+public:
+	void addPlane(const PM::Point& normal, float d)
+	{
+		normals.push_back(normal);
+		offsets.push_back(d);
+	}
+
+	virtual bool contains(const PM& mesh, PM::VertexHandle vh) const
+	{
+		const PM::Point& p = mesh.point(vh);
+		for (int i = 0; i < normals.size(); i++)
+			if ((normals[i] | p) + offsets[i] < 0.0f) return false;
+		return true;
+	}
+
+private:
+	std::vector<PM::Point> normals;
+	std::vector<float> offsets;
+};
+
+/// Everything not in another region
+class ComplementRegion : public Region
+{
+public:
+	ComplementRegion(const Region& region) : region(region) {}
+
+	virtual bool contains(const PM& mesh, PM::VertexHandle vh) const
+	{
+		return !region.contains(mesh, vh);
+	}
+
+private:
+	const Region& region;
+};
+
+/// Some vertices and everything split from them
+class VertexSetRegion : public Region
+{
+public:
+	VertexSetRegion(const VertexHierarchy& hierarchy, int vertexCount)
+		: hierarchy(hierarchy), selected(vertexCount, 0) {}
+
+	void add(PM::VertexHandle vh) { selected[vh.idx()] = 1; }
+
+	virtual bool contains(const PM& mesh, PM::VertexHandle vh) const
+	{
+		for (int v = vh.idx(); v >= 0; v = hierarchy.getParent(v))
+			if (selected[v]) return true;
+		return false;
+	}
+
+private:
+	const VertexHierarchy& hierarchy;
+	std::vector<char> selected;
+};
+
+#endif
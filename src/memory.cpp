@@ -0,0 +1,44 @@
+/************************************************************************
+
+  Routines for measuring memory use.
+
+ ************************************************************************/
+
+#include <stddef.h>
+
+#if defined(WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+
+// Largest working set of the process so far, in bytes
+size_t get_peak_rss()
+{
+    PROCESS_MEMORY_COUNTERS counters;
+
+    if( !GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) )
+	return 0;
+
+    return counters.PeakWorkingSetSize;
+}
+
+#else
+#include <sys/time.h>
+#include <sys/resource.h>
+
+// Largest resident set of the process so far, in bytes
+size_t get_peak_rss()
+{
+    struct rusage r;
+
+    getrusage(RUSAGE_SELF, &r);
+
+#if defined(__APPLE__)
+    return (size_t)r.ru_maxrss;          // bytes
+#else
+    return (size_t)r.ru_maxrss * 1024;   // kilobytes
+#endif
+}
+
+#endif
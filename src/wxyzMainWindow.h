@@ -1,388 +1,410 @@
-/*
-@file wxyzMainWindow.h
-
-Main window UI
-*/
-
-#ifndef WXYZMAINWINDOW_H
-#define WXYZMAINWINDOW_H
-
-// standard fox objects
-#include "fx.h"
-#include "fx3d.h"
-// my fox object
-#include "FXGLPM.h"
-#include "FXGLAxis.h"
-#include "FXGLGrid.h"
-#include "FXSmoothCanvas.h"
-
-// Main Window
-class WxyzMainWindow : public FXMainWindow
-{
-
-	FXDECLARE(WxyzMainWindow)
-
-private:
-	FXMenuPane		*filemenu;		// file menu
-	FXMenuPane		*helpmenu;		// help menu
-	FXStatusBar		*statusbar;		// Status bar
-	FXMenuBar		*menubar;		// Menu bar
-	FXSmoothCanvas	*canvas;        // Canvas to draw into
-	FXSlider		*pmLevelSlider; // display the current level
-	FXGLVisual		*glvisual;		// enables opengl window
-	FXGLViewer		*gldisplay;		// place to draw
-	FXSpinner		*neighborhoodSelectionLevelSpinner;
-	FXSpinner	*range;				// range of the frequency
-
-	FXGLPM		*pmMesh;		// scene object
-	FXGLAxis	*glAxis;
-	FXGLGrid	*glGrid;
-	FXGLGroup	*foxScene;		// scene object
-
-	FXGLSphere	*fxSphere;
-	FXDial	*radiusSlider; 
-	bool flagSphere;
-	PM::Point center;
-	float radius,oldradius;
-	FXdouble dminscale;
-	FXDataTarget       dt;
-
-protected:
-	WxyzMainWindow(){};
-	void initVariables();
-	void initGUI();
-	void updateSphere();
-
-public:
-	enum
-	{
-		ID_ABOUT=FXMainWindow::ID_LAST,
-		ID_OPEN,
-		ID_SAVE,
-		ID_GLVIEWER,
-		ID_BUILD_PM,
-		ID_PM_LEVEL_CHANGE,
-		// ID_SMOOTH_PM,
-		ID_RECOMPUTE_DETAIL,
-		ID_NEIGHBORHOOD_LEVEL_CHANGE,
-		ID_SPHERE,
-		ID_RADIUS_CHANGE,
-		ID_SHADING,
-		ID_REALTIME,
-		ID_APPLY,				// apply the frequency function
-		ID_CHANGE_RANGE,		// range of the frequency function
-		ID_RESET				// reset range
-	};
-
-	
-	// WxyzMainWindow constructor
-	WxyzMainWindow(FXApp* a);
-
-	// Initialize
-	virtual void create();
-
-	// WxyzMainWindow destructor
-	virtual ~WxyzMainWindow();
-
-	// set of message handlers
-	long onPaint(FXObject*,FXSelector,void*);
-	long onMouseDown(FXObject*,FXSelector,void*);
-	long onRightBtClicked(FXObject*,FXSelector,void*);
-	long onMouseMove(FXObject*,FXSelector,void*);
-	long onMouseRelease(FXObject*,FXSelector,void*);
-
-	long onCmdOpen(FXObject*,FXSelector,void*);
-	long onCmdSave(FXObject*,FXSelector,void*);
-	long onCmdAbout(FXObject*,FXSelector,void*);
-	long onUpdatePMLevel(FXObject*,FXSelector,void*);
-	long onBuildPM(FXObject*,FXSelector,void*);
-	// long onSmoothPM(FXObject*,FXSelector,void*);
-	long onRecomputeDetail(FXObject*,FXSelector,void*);
-	long onNeighborhoodLevelChange(FXObject*,FXSelector,void*);
-	long onSphere(FXObject*,FXSelector,void*);
-	long onRadiusChange(FXObject*,FXSelector,void*);
-	long onApply(FXObject*,FXSelector,void*);
-	long onChangeRealtime(FXObject*,FXSelector,void*);
-	long onApplyRealTime(FXObject*,FXSelector,void*);
-	long onChangeRange(FXObject*,FXSelector,void*);
-	long onReset(FXObject*,FXSelector,void*);
-	long onChangeShading(FXObject*,FXSelector,void*);
-
-	// update
-	void updateScene();
-};
-
-FXDEFMAP(WxyzMainWindow) WxyzMainWindowMap[]={
-
-	//________Message_Type_____________________ID____________Message_Handler_______
-	FXMAPFUNC(SEL_LEFTBUTTONPRESS,  WxyzMainWindow::ID_ABOUT, WxyzMainWindow::onMouseDown),
-	FXMAPFUNC(SEL_RIGHTBUTTONPRESS,	WxyzMainWindow::ID_ABOUT, WxyzMainWindow::onRightBtClicked),
-	FXMAPFUNC(SEL_MOTION,			WxyzMainWindow::ID_ABOUT, WxyzMainWindow::onMouseMove),
-	FXMAPFUNC(SEL_LEFTBUTTONRELEASE,WxyzMainWindow::ID_ABOUT, WxyzMainWindow::onMouseRelease),
-	FXMAPFUNC(SEL_PAINT,   WxyzMainWindow::ID_ABOUT, WxyzMainWindow::onPaint),
-	FXMAPFUNC(SEL_COMMAND, WxyzMainWindow::ID_OPEN, WxyzMainWindow::onCmdOpen),
-	FXMAPFUNC(SEL_COMMAND, WxyzMainWindow::ID_SAVE, WxyzMainWindow::onCmdSave),
-	FXMAPFUNC(SEL_COMMAND, WxyzMainWindow::ID_ABOUT, WxyzMainWindow::onCmdAbout),
-	FXMAPFUNC(SEL_COMMAND, WxyzMainWindow::ID_BUILD_PM, WxyzMainWindow::onBuildPM),
-	FXMAPFUNC(SEL_CHANGED, WxyzMainWindow::ID_PM_LEVEL_CHANGE, WxyzMainWindow::onUpdatePMLevel),
-	// FXMAPFUNC(SEL_COMMAND, WxyzMainWindow::ID_SMOOTH_PM, WxyzMainWindow::onSmoothPM),
-	FXMAPFUNC(SEL_COMMAND, WxyzMainWindow::ID_RECOMPUTE_DETAIL, WxyzMainWindow::onRecomputeDetail),
-	FXMAPFUNC(SEL_COMMAND, WxyzMainWindow::ID_NEIGHBORHOOD_LEVEL_CHANGE, WxyzMainWindow::onNeighborhoodLevelChange),
-	FXMAPFUNC(SEL_COMMAND, WxyzMainWindow::ID_SPHERE, WxyzMainWindow::onSphere),
-	FXMAPFUNC(SEL_COMMAND, WxyzMainWindow::ID_RADIUS_CHANGE, WxyzMainWindow::onRadiusChange),
-	FXMAPFUNC(SEL_COMMAND, WxyzMainWindow::ID_APPLY,  WxyzMainWindow::onApply),
-	FXMAPFUNC(SEL_COMMAND, WxyzMainWindow::ID_CHANGE_RANGE,  WxyzMainWindow::onChangeRange),
-	FXMAPFUNC(SEL_COMMAND, WxyzMainWindow::ID_RESET,  WxyzMainWindow::onReset),
-	FXMAPFUNC(SEL_COMMAND, WxyzMainWindow::ID_SHADING,  WxyzMainWindow::onChangeShading),
-	FXMAPFUNC(SEL_COMMAND, WxyzMainWindow::ID_REALTIME,  WxyzMainWindow::onChangeRealtime),
-};
-
-// Bitmap icon data
-const unsigned char cowiconChar[]={
-  0x47,0x49,0x46,0x38,0x39,0x61,0x20,0x00,0x20,0x00,0xe6,0x00,0x00,0x00,0x00,0x00,
-  0xff,0xff,0xff,0x00,0x00,0x20,0x00,0x00,0x1b,0x00,0x00,0x19,0x00,0x00,0x15,0x00,
-  0x00,0x12,0x00,0x00,0x0c,0x00,0x00,0x09,0x00,0x00,0x04,0x00,0x01,0x22,0x00,0x04,
-  0x25,0x00,0x08,0x29,0x00,0x0c,0x2c,0x00,0x0f,0x33,0x00,0x0e,0x2f,0x00,0x13,0x37,
-  0x00,0x14,0x38,0x00,0x16,0x3a,0x00,0x1b,0x42,0x00,0x1a,0x40,0x00,0x20,0x45,0x00,
-  0x22,0x47,0x00,0x29,0x52,0x00,0x27,0x4c,0x00,0x25,0x4b,0x00,0x2e,0x57,0x00,0x2b,
-  0x53,0x00,0x32,0x5c,0x00,0x31,0x59,0x00,0x39,0x63,0x00,0x35,0x5e,0x00,0x3c,0x65,
-  0x00,0x38,0x60,0x01,0x40,0x6a,0x00,0x3e,0x67,0x01,0x45,0x6d,0x04,0x4a,0x71,0x04,
-  0x47,0x6f,0x07,0x50,0x77,0x07,0x4c,0x75,0x09,0x51,0x78,0x0d,0x53,0x7c,0x0f,0x5a,
-  0x83,0x0f,0x58,0x80,0x13,0x5f,0x89,0x13,0x5c,0x85,0x19,0x66,0x90,0x19,0x63,0x8c,
-  0x1b,0x67,0x92,0x21,0x6f,0x9a,0x0d,0x57,0x7e,0x15,0x62,0x8a,0x1b,0x6a,0x95,0x1e,
-  0x6d,0x97,0x21,0x71,0x9c,0x27,0x78,0xa1,0x27,0x76,0x9e,0x2b,0x7a,0xa4,0x2e,0x80,
-  0xa8,0x2e,0x7d,0xa5,0x31,0x82,0xab,0x33,0x84,0xad,0x3c,0x8c,0xb5,0x24,0x75,0x9c,
-  0x33,0x85,0xad,0x37,0x89,0xaf,0x39,0x8b,0xb3,0x3c,0x90,0xb6,0x3f,0x92,0xba,0x42,
-  0x95,0xba,0x45,0x98,0xc0,0x45,0x97,0xbc,0x47,0x9c,0xc1,0x4b,0x9e,0xc3,0x4d,0x9f,
-  0xc7,0x59,0xab,0xd0,0x4d,0xa3,0xc7,0x51,0xa4,0xc8,0x53,0xa7,0xca,0x57,0xaa,0xce,
-  0x5c,0xaf,0xd3,0x5c,0xae,0xd0,0x60,0xb3,0xd5,0x63,0xb5,0xd8,0x66,0xb6,0xd8,0x6f,
-  0xbd,0xdf,0x75,0xc2,0xe2,0x7d,0xc9,0xe9,0x80,0xcd,0xec,0x83,0xce,0xed,0x8b,0xd5,
-  0xf3,0x96,0xdc,0xf8,0x69,0xba,0xda,0x6c,0xbc,0xdc,0x71,0xc1,0xdf,0x75,0xc6,0xe3,
-  0x77,0xc8,0xe6,0x7a,0xc8,0xe6,0x85,0xd0,0xed,0x89,0xd4,0xf0,0x8f,0xd8,0xf4,0x92,
-  0xdb,0xf4,0x98,0xdf,0xfa,0x9e,0xe3,0xfe,0x9c,0xe1,0xfa,0xa4,0xe8,0xff,0xa1,0xe6,
-  0xff,0xaa,0xec,0xff,0xad,0xef,0xff,0xd0,0xff,0xff,0xa7,0xeb,0xff,0xb3,0xf3,0xff,
-  0xc3,0xfe,0xff,0xdf,0xff,0xff,0xeb,0xff,0xff,0xaf,0xf2,0xff,0xff,0xff,0xff,0xff,
-  0xff,0xff,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
-  0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x21,0xf9,0x04,
-  0x01,0x00,0x00,0x76,0x00,0x2c,0x00,0x00,0x00,0x00,0x20,0x00,0x20,0x00,0x00,0x07,
-  0xff,0x80,0x76,0x82,0x83,0x84,0x83,0x4d,0x85,0x88,0x89,0x8a,0x83,0x4e,0x47,0x8b,
-  0x8f,0x8f,0x28,0x47,0x1c,0x90,0x95,0x88,0x29,0x11,0x96,0x88,0x4e,0x8f,0x14,0x00,
-  0x9a,0x83,0x38,0x22,0x90,0x00,0x02,0x38,0xa0,0x2a,0x0a,0x94,0x8f,0x0d,0x2a,0x5f,
-  0x64,0x4a,0x50,0x46,0x61,0x89,0x50,0x47,0x4c,0x38,0x07,0x89,0x5c,0x71,0x84,0x1e,
-  0x21,0x5a,0x6b,0x66,0x51,0x3e,0x3e,0x3b,0x32,0x38,0x37,0x47,0x60,0x68,0x69,0x3f,
-  0x27,0x88,0x55,0x67,0x60,0x58,0x44,0x3e,0x41,0x82,0x31,0x18,0x2c,0x2e,0x2a,0x31,
-  0x30,0x35,0x36,0x40,0x2f,0x35,0x51,0x62,0x26,0x8a,0x64,0x67,0xd3,0x66,0x40,0x39,
-  0x37,0x45,0x76,0x29,0x45,0x3a,0x5d,0x52,0x54,0x42,0x3a,0x38,0x43,0x41,0x3e,0x37,
-  0x82,0x59,0x10,0xc5,0x51,0xc3,0x85,0x4c,0x14,0x25,0x28,0x68,0xfc,0xc8,0x72,0xc6,
-  0x07,0x8e,0x28,0x60,0xc0,0x88,0x91,0x32,0x64,0x48,0x12,0x25,0x4e,0xa8,0xe8,0x10,
-  0xd1,0x64,0x4d,0xa1,0x34,0x67,0xb6,0x90,0xe1,0x02,0xe6,0x01,0x45,0x30,0x3c,0xbc,
-  0x68,0x81,0xc2,0xa5,0xcc,0x98,0x22,0x3d,0x76,0x28,0xa1,0x02,0xe6,0x47,0x93,0x1f,
-  0x3e,0x10,0xad,0xd9,0xb2,0x05,0x4d,0x17,0x23,0x20,0x98,0xb0,0xf0,0x40,0x83,0x8d,
-  0x0e,0x34,0x66,0xc6,0x80,0xb1,0xb2,0x83,0xc7,0x0f,0x29,0x49,0x9c,0x80,0x49,0x93,
-  0x28,0x0c,0x17,0x34,0x4b,0x62,0x90,0x98,0x30,0x23,0x42,0x93,0x2c,0x58,0xcc,0x70,
-  0x39,0x43,0xe5,0x48,0x93,0x21,0x38,0x64,0xfc,0xb8,0x72,0x68,0xd1,0x1b,0x8f,0x82,
-  0xff,0x44,0x88,0x10,0xc2,0x64,0xe4,0x96,0x2c,0x3f,0x98,0x3c,0x39,0x82,0x63,0x05,
-  0x0d,0xaa,0xa0,0x4a,0x5c,0xa8,0xb1,0x44,0x4a,0x19,0x2d,0x52,0x88,0x18,0x51,0x8c,
-  0x04,0x19,0x28,0x3b,0x21,0x60,0x6c,0xb8,0xd1,0x24,0x09,0x18,0x32,0x43,0x88,0xdc,
-  0xf8,0x71,0xc3,0xc6,0x8d,0x17,0xa0,0x32,0x6c,0x78,0xf1,0x01,0x48,0x90,0x24,0x4f,
-  0xc0,0x10,0x01,0x62,0xc3,0x05,0x8a,0x15,0x2d,0x5e,0xa0,0xa8,0x04,0x21,0x83,0x02,
-  0x0c,0x32,0x52,0xdc,0xe8,0x51,0xe4,0xc8,0x12,0x19,0x39,0x46,0x7c,0x48,0x02,0x85,
-  0xc8,0x91,0x24,0x4c,0x0b,0xcd,0x00,0x20,0x41,0x82,0x85,0x14,0x22,0x08,0x40,0xb0,
-  0x91,0xa3,0x46,0x90,0x1e,0x46,0x74,0xdc,0x00,0x21,0xc1,0x08,0x0d,0x2d,0x57,0xd0,
-  0x7c,0xd9,0xf2,0x66,0x90,0x8b,0x0e,0x19,0x30,0x38,0x38,0xf1,0x62,0x46,0x87,0x02,
-  0x02,0x54,0xe0,0xe8,0xd1,0xe3,0x74,0x10,0x18,0x29,0x20,0x2c,0xd1,0x42,0x62,0x88,
-  0x8e,0x23,0x66,0xa0,0xf1,0x84,0x1d,0x3d,0xc4,0xc0,0x01,0x06,0x12,0x88,0x70,0x43,
-  0x0e,0x2e,0x50,0xb0,0x80,0x03,0x30,0xd0,0xd0,0x82,0x10,0x45,0x20,0xf1,0xc4,0x06,
-  0x13,0xb0,0x90,0x03,0x18,0x3d,0xc0,0x50,0x46,0x10,0x64,0x88,0x11,0x86,0x0b,0x50,
-  0x74,0x40,0x01,0x08,0x19,0xbc,0x90,0x44,0x10,0x34,0x58,0x30,0xc0,0x03,0x17,0xe4,
-  0xc0,0x03,0x0b,0x36,0xc8,0x40,0x83,0x06,0x1a,0x20,0xd1,0x43,0x13,0xaf,0x54,0x61,
-  0xc4,0x16,0x5d,0x54,0xd1,0xc1,0x08,0x10,0x8c,0xe0,0x40,0x0c,0x31,0x3c,0x51,0x04,
-  0xf8,0x10,0x11,0x48,0x10,0x41,0x02,0x10,0xa0,0x10,0xc3,0x0c,0x2c,0xcc,0x50,0x02,
-  0x05,0x1c,0xf0,0x30,0x44,0x13,0x42,0xe0,0x80,0x44,0x11,0x39,0x40,0xa6,0x01,0x08,
-  0x11,0x88,0x30,0xc3,0x11,0x5e,0x74,0xe1,0xc3,0x05,0x16,0x50,0x70,0x01,0x00,0x00,
-  0x44,0xe0,0xc0,0x03,0x0f,0xc0,0x27,0x84,0x05,0x2d,0x28,0xd1,0x04,0x10,0x50,0x2c,
-  0x21,0x88,0x07,0x23,0xcc,0xf0,0x00,0x6c,0x47,0x5c,0x71,0x05,0x0f,0x25,0x74,0xf0,
-  0xc1,0x81,0x08,0x38,0x00,0x42,0x09,0x2e,0x8c,0x50,0x00,0x9c,0x0a,0xa8,0xa0,0x01,
-  0x09,0x33,0x0c,0xa2,0xc1,0x08,0x21,0x50,0xa0,0x02,0x11,0x58,0x88,0x01,0x85,0x0e,
-  0x30,0x90,0xf0,0x01,0x08,0x5b,0xc1,0xa9,0xaa,0x0a,0x8f,0x9c,0x50,0x02,0x03,0x22,
-  0xb0,0xe0,0x84,0x19,0x69,0x08,0x01,0x44,0x0c,0x2e,0x84,0x10,0x9c,0x0d,0x2d,0xc4,
-  0x60,0xc3,0x06,0x95,0xa8,0x40,0x42,0x03,0x30,0xf0,0x10,0x45,0x19,0x6f,0x04,0x01,
-  0xc4,0x38,0x2e,0xe8,0x20,0x03,0x0f,0x3a,0xf0,0xd0,0x83,0xb4,0x90,0xac,0x30,0x82,
-  0x05,0x30,0x38,0x61,0x45,0x1a,0x6f,0x08,0x11,0x84,0x0e,0x2f,0xc8,0x98,0x0c,0x0e,
-  0x3c,0xd8,0x10,0x05,0x0c,0x90,0xd0,0x60,0x22,0x0c,0x50,0x8c,0x71,0xc6,0x1a,0x45,
-  0x04,0xb1,0x43,0x0e,0x3b,0x38,0x04,0x04,0x0e,0x3b,0x3c,0xe0,0x04,0xba,0x8f,0xb4,
-  0x20,0x42,0x07,0x2f,0xa8,0xb4,0x45,0x1a,0x47,0x5c,0x87,0x6f,0x10,0x3f,0xf4,0x20,
-  0xc4,0x0e,0x10,0x08,0x01,0xcd,0x23,0x81,0x00,0x00,0x3b
-  };
-
-
-// File Open
-const unsigned char fileopeniconChar[]=
-{
-	0x47,0x49,0x46,0x38,0x37,0x61,0x10,0x00,0x10,0x00,0xf2,0x00,0x00,0xb2,0xc0,0xdc,
-	0x00,0x00,0x00,0x00,0xff,0x00,0xff,0xff,0x00,0x80,0x80,0x80,0xff,0xff,0xff,0x00,
-	0x00,0x00,0x00,0x00,0x00,0x2c,0x00,0x00,0x00,0x00,0x10,0x00,0x10,0x00,0x00,0x03,
-	0x45,0x08,0xba,0x1c,0xfe,0x2c,0xae,0x20,0x44,0x90,0x91,0xd6,0x8b,0x95,0xb6,0x1c,
-	0x00,0x79,0x95,0x25,0x3e,0x03,0x31,0x3c,0xa5,0x73,0xaa,0xf0,0xda,0xae,0x5e,0xfa,
-	0xdc,0xb8,0xa3,0x06,0xc5,0xd0,0xff,0x3e,0x9f,0xc3,0x16,0x04,0x02,0x75,0x81,0xa2,
-	0xb2,0x77,0x49,0xf2,0x96,0xc5,0x26,0x21,0x69,0x54,0x36,0xa9,0x50,0xa6,0xe7,0x59,
-	0xfd,0x71,0x72,0x60,0x4e,0x02,0x00,0x3b
-};
-
-
-// File Save
-const unsigned char filesaveiconChar[]={
-  0x47,0x49,0x46,0x38,0x37,0x61,0x10,0x00,0x10,0x00,0xf3,0x00,0x00,0x80,0x80,0x80,
-  0xb2,0xc0,0xdc,0xff,0xff,0xff,0xff,0xff,0x00,0x00,0x00,0x00,0x80,0x80,0x00,0x00,
-  0x00,0xff,0x00,0xff,0xff,0x00,0x00,0x80,0xc0,0xc0,0xc0,0x00,0x80,0x80,0x00,0x00,
-  0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x2c,0x00,0x00,
-  0x00,0x00,0x10,0x00,0x10,0x00,0x00,0x04,0x5a,0x10,0xc8,0x19,0xaa,0xbd,0x40,0x0c,
-  0x91,0xc1,0xfd,0xc0,0x36,0x10,0x24,0xf1,0x59,0x99,0x58,0x4c,0x2c,0xba,0x19,0x5a,
-  0x26,0xcc,0x9c,0x17,0x64,0xc6,0x01,0xcb,0x74,0x77,0xe7,0x07,0x9d,0x0c,0xc6,0x99,
-  0x49,0x04,0x40,0x1d,0x12,0xd1,0x29,0x85,0x90,0x41,0xdd,0x81,0x39,0x4b,0x24,0x08,
-  0x29,0x68,0x94,0x4a,0xc3,0x8a,0xb4,0x53,0x9e,0x00,0x5b,0x4a,0x86,0x69,0xe3,0x89,
-  0x01,0xc1,0x6e,0x8b,0x4d,0x16,0x85,0x02,0x3b,0x41,0xc3,0x31,0x68,0xfb,0x09,0x50,
-  0xea,0x93,0x22,0x00,0x3b
-  };
-
-
-// No shading
-const unsigned char nolight[]={
-  0x47,0x49,0x46,0x38,0x37,0x61,0x10,0x00,0x10,0x00,0xf2,0x00,0x00,0xb2,0xc0,0xdc,
-  0x00,0x00,0x00,0xc0,0xc0,0xc0,0x80,0x80,0x00,0x00,0x00,0x80,0x80,0x80,0x80,0x00,
-  0x00,0x00,0x00,0x00,0x00,0x2c,0x00,0x00,0x00,0x00,0x10,0x00,0x10,0x00,0x00,0x03,
-  0x33,0x08,0x1a,0xac,0xfe,0x2e,0x88,0x19,0x20,0x94,0x02,0x57,0xbb,0xb2,0xdf,0x9c,
-  0x24,0x66,0x5c,0x24,0x82,0x25,0xc0,0xa0,0x69,0x30,0xb0,0x0f,0x11,0xbd,0x1c,0x61,
-  0x9b,0xb0,0x7d,0x3b,0x85,0xa5,0xef,0xa5,0x1f,0xb0,0x26,0x4c,0x09,0x87,0x90,0xa3,
-  0x2c,0x65,0x49,0x00,0x00,0x3b
-  };
-
-// Shading
-const unsigned char light[]={
-  0x47,0x49,0x46,0x38,0x37,0x61,0x10,0x00,0x10,0x00,0xf2,0x00,0x00,0xb2,0xc0,0xdc,
-  0x00,0x00,0x00,0xff,0xff,0x00,0xff,0xff,0xff,0x80,0x80,0x00,0x00,0x00,0xff,0x80,
-  0x80,0x80,0x00,0x00,0x00,0x2c,0x00,0x00,0x00,0x00,0x10,0x00,0x10,0x00,0x00,0x03,
-  0x34,0x08,0x10,0xac,0xfe,0x2e,0x88,0x19,0x20,0x94,0x62,0x50,0x1b,0xb3,0xaf,0xdc,
-  0xe2,0x69,0x60,0xc8,0x08,0x4d,0x18,0xa5,0xaa,0x12,0x10,0xa5,0x55,0x14,0x2e,0xcc,
-  0xcd,0xb3,0xcb,0x3a,0x78,0xae,0x18,0xb2,0x1e,0x2d,0x24,0xf4,0xdd,0x8a,0xc4,0xe2,
-  0x30,0x88,0x6c,0x41,0x12,0x00,0x3b
-  };
-
-/* Generated by reswrap from file milo24.gif */
-const unsigned char miloIconChar[]={
-  0x47,0x49,0x46,0x38,0x39,0x61,0x18,0x00,0x18,0x00,0xf7,0x00,0x00,0x00,0x00,0x00,
-  0xff,0xff,0xff,0x68,0x68,0x68,0x65,0x64,0x65,0x64,0x64,0x66,0x63,0x63,0x65,0x67,
-  0x67,0x68,0x65,0x66,0x67,0x68,0x69,0x69,0x6b,0x6b,0x6a,0xd0,0xcc,0xad,0xdb,0xd7,
-  0xb7,0xd4,0xd0,0xb1,0xc8,0xc4,0xa7,0xc7,0xc3,0xa6,0xd9,0xd4,0xb4,0xd0,0xcb,0xad,
-  0xcf,0xca,0xac,0xce,0xc9,0xab,0xc8,0xc3,0xa6,0xc7,0xc2,0xa5,0xc4,0xbf,0xa3,0xd5,
-  0xd0,0xb2,0xd3,0xce,0xb0,0xd1,0xcc,0xae,0xce,0xc9,0xac,0xcc,0xc7,0xaa,0xbd,0xb7,
-  0x9b,0xcb,0xc5,0xa7,0xc6,0xc0,0xa3,0xcb,0xc5,0xa8,0xbc,0xb5,0x99,0xc0,0xb9,0x9d,
-  0xbf,0xb9,0x9e,0xc3,0xbd,0xa2,0xc2,0xbc,0xa1,0xc0,0xba,0x9f,0xba,0xb2,0x96,0xab,
-  0xa4,0x8a,0xbc,0xb5,0x9a,0xbb,0xb4,0x99,0xb7,0xb0,0x96,0xb6,0xaf,0x95,0xb5,0xae,
-  0x94,0xb4,0xad,0x93,0xba,0xb3,0x99,0xc7,0xc0,0xa5,0xc2,0xbb,0xa1,0xad,0xa7,0x90,
-  0x9f,0x9a,0x87,0x94,0x90,0x82,0xaf,0xa7,0x8e,0xad,0xa5,0x8c,0xb9,0xb1,0x97,0xb2,
-  0xaa,0x91,0xb1,0xa9,0x90,0xb0,0xa8,0x8f,0x9a,0x91,0x79,0x9f,0x96,0x7e,0xac,0xa3,
-  0x89,0xa9,0xa0,0x87,0xa5,0x9c,0x84,0xa4,0x9b,0x83,0xac,0xa3,0x8a,0xab,0xa2,0x89,
-  0xa6,0x9d,0x85,0xb0,0xa7,0x8e,0xaf,0xa6,0x8d,0xab,0xa2,0x8a,0xaa,0xa1,0x89,0xa9,
-  0xa0,0x88,0xb3,0xaa,0x92,0x91,0x8b,0x7b,0x86,0x82,0x76,0x9f,0x95,0x7d,0xa3,0x99,
-  0x81,0xb3,0xa9,0x8f,0xa1,0x98,0x81,0xaf,0xa5,0x8d,0x8d,0x87,0x78,0x88,0x84,0x7a,
-  0xa3,0x98,0x7f,0x96,0x8c,0x75,0x95,0x8b,0x74,0x91,0x87,0x71,0xa1,0x96,0x7e,0xa0,
-  0x95,0x7d,0x9f,0x95,0x7e,0xa1,0x97,0x80,0xa5,0x9b,0x84,0xa8,0x9e,0x87,0x95,0x8d,
-  0x7b,0x7b,0x78,0x71,0x84,0x79,0x63,0x96,0x8a,0x73,0x8f,0x84,0x6e,0x8e,0x83,0x6d,
-  0x96,0x8b,0x74,0x95,0x8a,0x73,0x94,0x89,0x73,0x93,0x88,0x72,0x86,0x7c,0x68,0x9a,
-  0x8f,0x78,0x9d,0x92,0x7b,0x98,0x8d,0x77,0x9b,0x90,0x7a,0xa2,0x97,0x80,0x9d,0x92,
-  0x7c,0x6b,0x6a,0x68,0x77,0x6c,0x58,0x80,0x74,0x5f,0x82,0x76,0x61,0x8b,0x7f,0x69,
-  0x88,0x7c,0x67,0x87,0x7b,0x66,0x8d,0x81,0x6b,0x93,0x87,0x71,0x90,0x84,0x6f,0x8d,
-  0x82,0x6d,0x8b,0x80,0x6b,0x93,0x87,0x72,0x6a,0x66,0x5f,0x6c,0x60,0x4d,0x6f,0x63,
-  0x50,0x7f,0x73,0x5f,0x7f,0x73,0x60,0x85,0x79,0x65,0x88,0x7c,0x68,0x8c,0x80,0x6c,
-  0x4a,0x3e,0x2d,0x45,0x3a,0x2a,0x4e,0x42,0x30,0x4f,0x43,0x32,0x4d,0x42,0x31,0x5f,
-  0x52,0x3f,0x67,0x59,0x45,0x61,0x54,0x41,0x65,0x58,0x45,0x67,0x5a,0x47,0x6b,0x5e,
-  0x4a,0x69,0x5c,0x49,0x6a,0x5d,0x4a,0x63,0x57,0x45,0x5a,0x4f,0x3f,0x6c,0x5f,0x4c,
-  0x6f,0x62,0x4f,0x76,0x69,0x55,0x73,0x66,0x53,0x72,0x65,0x52,0x75,0x68,0x55,0x76,
-  0x69,0x56,0x7c,0x6f,0x5b,0x77,0x6a,0x57,0x7e,0x71,0x5d,0x79,0x6c,0x59,0x7b,0x6e,
-  0x5b,0x7e,0x71,0x5e,0x7d,0x70,0x5d,0x83,0x76,0x62,0x86,0x79,0x65,0x84,0x77,0x63,
-  0x88,0x7b,0x67,0x8b,0x7e,0x6a,0x60,0x59,0x4f,0x6f,0x6d,0x6a,0x4a,0x3d,0x2b,0x4d,
-  0x40,0x2f,0x48,0x3c,0x2c,0x52,0x45,0x33,0x4a,0x3e,0x2e,0x53,0x46,0x34,0x50,0x43,
-  0x32,0x54,0x47,0x35,0x51,0x44,0x33,0x52,0x45,0x34,0x56,0x49,0x37,0x57,0x4a,0x38,
-  0x58,0x4b,0x39,0x5e,0x50,0x3d,0x59,0x4c,0x3a,0x56,0x49,0x38,0x5b,0x4e,0x3c,0x5c,
-  0x4f,0x3d,0x53,0x47,0x37,0x63,0x55,0x42,0x5d,0x50,0x3e,0x64,0x56,0x43,0x5e,0x51,
-  0x3f,0x65,0x57,0x44,0x68,0x5a,0x47,0x61,0x54,0x42,0x69,0x5b,0x48,0x6a,0x5c,0x49,
-  0x60,0x53,0x42,0x6c,0x5e,0x4b,0x65,0x58,0x46,0x67,0x5a,0x48,0x6e,0x60,0x4d,0x72,
-  0x64,0x51,0x75,0x67,0x54,0x74,0x66,0x53,0x6e,0x61,0x4f,0x6d,0x60,0x4e,0x52,0x48,
-  0x3b,0x7b,0x6d,0x5a,0x3e,0x32,0x23,0x3f,0x33,0x24,0x41,0x35,0x26,0x42,0x36,0x27,
-  0x43,0x37,0x28,0x44,0x38,0x29,0x4c,0x3f,0x2f,0x4d,0x40,0x30,0x4e,0x41,0x31,0x5b,
-  0x4d,0x3b,0x5a,0x4c,0x3b,0x60,0x52,0x40,0x5d,0x4f,0x3e,0x61,0x53,0x41,0x66,0x57,
-  0x45,0x67,0x59,0x47,0x5d,0x50,0x40,0x71,0x63,0x51,0x4f,0x45,0x39,0x3c,0x30,0x22,
-  0x3a,0x2e,0x21,0x40,0x34,0x26,0x46,0x39,0x2a,0x3f,0x33,0x26,0x47,0x3a,0x2b,0x4a,
-  0x3d,0x2e,0x43,0x37,0x2a,0x4c,0x3f,0x30,0x46,0x3a,0x2d,0x4e,0x41,0x33,0x45,0x38,
-  0x2b,0x4a,0x40,0x36,0x66,0x63,0x60,0x41,0x35,0x2a,0x3c,0x31,0x27,0x39,0x2c,0x21,
-  0x34,0x28,0x1f,0x31,0x25,0x1d,0x2a,0x1f,0x19,0x69,0x69,0x69,0x67,0x67,0x67,0xff,
-  0xff,0xff,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
-  0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x21,0xf9,0x04,
-  0x01,0x00,0x00,0xf6,0x00,0x2c,0x00,0x00,0x00,0x00,0x18,0x00,0x18,0x00,0x00,0x08,
-  0xff,0x00,0xe1,0x89,0x73,0x94,0x2c,0x11,0xa3,0x5c,0xb9,0x80,0x71,0xc2,0x53,0x45,
-  0x4b,0x91,0x2b,0x58,0x8c,0x18,0x51,0x91,0x61,0x01,0x8b,0x2e,0x25,0x9e,0x99,0x1b,
-  0x47,0xc8,0x96,0xad,0x55,0x86,0x70,0x59,0x0a,0xf5,0xe5,0x8e,0x1c,0x40,0x8b,0x64,
-  0xbd,0x1a,0xa6,0xe6,0x82,0x09,0x4b,0x6e,0xd8,0xb9,0x5b,0x17,0x0e,0xda,0xba,0x55,
-  0xaa,0x54,0xed,0xe2,0x06,0x09,0x52,0x27,0x3c,0x9a,0xa8,0x35,0x03,0xc7,0x08,0x04,
-  0x07,0x20,0x3b,0x24,0x05,0xbb,0xa5,0x0e,0xdd,0xb4,0x53,0xd0,0xa4,0x09,0x6a,0x05,
-  0x4b,0x15,0x36,0x39,0x3a,0x2a,0x0d,0x5a,0x65,0xab,0x87,0x05,0x17,0x28,0xd0,0xbd,
-  0x7a,0x35,0x6b,0x50,0x34,0x68,0xcf,0x0a,0xcd,0xd2,0x56,0x6b,0xd5,0x21,0x2c,0x2c,
-  0xb2,0xc8,0x99,0xb4,0x8d,0x8a,0x87,0x08,0x0f,0x9e,0xa5,0xb2,0x36,0x2b,0x15,0x34,
-  0x71,0xd0,0x76,0x79,0x12,0x93,0x43,0xca,0x14,0x1d,0x29,0x42,0xac,0xe1,0x94,0x48,
-  0xd3,0x8a,0x0a,0x0c,0xe4,0xbd,0x8b,0x85,0x8b,0x55,0x34,0x67,0x82,0x7c,0xf9,0x59,
-  0x62,0xa3,0x85,0x08,0x07,0x11,0x42,0x60,0xd9,0xe4,0xca,0x1a,0x0f,0x08,0x14,0xa4,
-  0xa5,0xab,0x45,0x2b,0xd5,0x33,0x69,0xa9,0x6a,0x61,0x22,0xe3,0x63,0xc5,0x88,0x09,
-  0x12,0x5e,0xa4,0x59,0xe4,0x88,0xdb,0x19,0x0c,0x22,0xa0,0xc5,0x93,0x36,0x48,0x50,
-  0xb5,0x61,0xda,0x58,0x35,0xf2,0xe3,0xa5,0x89,0x0a,0x12,0x15,0x2a,0x34,0xd9,0x13,
-  0xc7,0xcd,0xa7,0x1f,0x45,0x1e,0x95,0x22,0x47,0x2e,0x56,0xa3,0x4d,0x98,0x6c,0xc5,
-  0xff,0xa2,0x24,0x87,0x8e,0x8f,0x1b,0x2d,0x1c,0xe0,0xa0,0x56,0xae,0x5c,0xb5,0x5f,
-  0x39,0xda,0x2d,0x3b,0x37,0x8f,0x5c,0x9b,0x3f,0x9e,0x14,0x0d,0xb2,0x55,0x09,0x54,
-  0x1d,0x25,0x34,0x34,0xf0,0xc1,0x2a,0xe1,0x84,0xf3,0x4c,0x1b,0x1d,0x20,0x40,0x4f,
-  0x1e,0xdf,0xc0,0xd3,0x08,0x1d,0x71,0x40,0x52,0x4d,0x2b,0xbd,0x30,0x03,0x0a,0x15,
-  0x5a,0x90,0xc0,0x02,0x24,0x68,0x49,0xd3,0xc5,0x10,0x02,0x08,0x40,0x4f,0x02,0xa3,
-  0xc4,0x02,0xc7,0x17,0x95,0xcc,0x42,0x4d,0x2d,0xc2,0x74,0x02,0xc6,0x12,0x3c,0x8c,
-  0xf1,0xcb,0x35,0xa6,0x64,0x23,0x09,0x19,0x21,0x86,0xc8,0x46,0x19,0x73,0x88,0xd2,
-  0x09,0x37,0xad,0xa4,0x32,0x0b,0x25,0x7e,0x8c,0xb1,0x84,0x1e,0xd1,0x74,0xb3,0xc7,
-  0x1f,0x6b,0x6c,0x90,0xa3,0x01,0xf4,0x6c,0x61,0x05,0x20,0xa0,0x78,0x73,0x4d,0x39,
-  0xa8,0x08,0xb3,0xc9,0x1c,0x40,0x04,0xa1,0x8c,0x22,0xcc,0x5c,0xc2,0xc7,0x09,0x39,
-  0x0a,0x70,0xc0,0x13,0x51,0x98,0x01,0x87,0x26,0xc3,0xb8,0xd2,0x0a,0x2e,0xde,0xc8,
-  0x41,0x84,0x10,0x71,0x24,0x12,0xc9,0x1b,0x5a,0x8c,0x50,0x26,0x01,0x49,0x54,0x11,
-  0xc6,0x18,0x6f,0x1c,0x83,0x08,0x2a,0xaf,0xf4,0xf2,0xc6,0x18,0x62,0x64,0x51,0x84,
-  0x0d,0x1a,0x28,0xa0,0x67,0x8e,0x07,0x70,0x41,0xc3,0x1d,0x75,0xd4,0xd1,0x49,0x24,
-  0xb5,0x50,0x33,0x0b,0x32,0x7e,0xcc,0xb1,0x86,0x16,0x4e,0xd8,0x30,0x43,0x11,0x65,
-  0xd6,0x43,0x0a,0x0b,0x60,0x44,0xf2,0xc9,0x1d,0x7c,0x44,0x62,0xcb,0x2b,0xb4,0xe4,
-  0x88,0x12,0xc9,0x31,0x7c,0x88,0x81,0xc6,0x1f,0x4a,0x94,0x09,0x25,0x0c,0x4a,0xe8,
-  0x62,0x0d,0x24,0x99,0xf4,0x51,0xc9,0x22,0x86,0xac,0xe2,0x4a,0x2c,0x86,0x1c,0x53,
-  0x89,0x1d,0x2b,0x94,0x29,0xc0,0x00,0x31,0xec,0xd0,0x88,0x2b,0x81,0xb8,0x62,0x08,
-  0x31,0x91,0x18,0x53,0xcc,0x2f,0x8a,0xfc,0xd2,0x8b,0x27,0x2c,0xa4,0xe0,0x6c,0x01,
-  0x32,0x30,0x81,0x8c,0x2b,0xa9,0xa4,0x3b,0x08,0x2c,0xb1,0x68,0x73,0x88,0x30,0x8b,
-  0xec,0x21,0xc5,0x11,0x4e,0x96,0x59,0x00,0x14,0x2a,0x5c,0xa2,0x4a,0x2a,0xa6,0x50,
-  0x83,0xca,0x35,0xb2,0xc8,0xa2,0xcb,0x2f,0xc0,0x5c,0x72,0x05,0x0e,0x8f,0xe6,0x58,
-  0x0f,0x12,0x35,0xc4,0x61,0x4d,0x2a,0xd4,0xb4,0xa2,0xca,0x2b,0xb5,0x18,0xc2,0x8b,
-  0x30,0x94,0x84,0x72,0x46,0x0b,0x14,0x04,0x04,0x00,0x3b
-  };
-
-// Parallel projection
-const unsigned char parallel[]={
-  0x47,0x49,0x46,0x38,0x37,0x61,0x10,0x00,0x10,0x00,0xf1,0x00,0x00,0xb2,0xc0,0xdc,
-  0x00,0x00,0x00,0xff,0xff,0xff,0x00,0x00,0x00,0x2c,0x00,0x00,0x00,0x00,0x10,0x00,
-  0x10,0x00,0x00,0x02,0x31,0x84,0x6f,0x11,0xc8,0xa7,0xa0,0x56,0x83,0x12,0xa6,0x4a,
-  0x19,0x8e,0x6f,0x66,0x25,0x08,0x9d,0x53,0x81,0xa1,0xb8,0x8c,0xd7,0x79,0x62,0x24,
-  0x1b,0x4a,0xa3,0xc9,0x6e,0x69,0x00,0x8b,0x0d,0x07,0xdb,0x08,0x2d,0x73,0xbd,0x22,
-  0x9e,0x9f,0xb0,0x58,0x2c,0x00,0x00,0x3b
-  };
-
-// Perspective projection
-const unsigned char perspective[]={
-  0x47,0x49,0x46,0x38,0x37,0x61,0x10,0x00,0x10,0x00,0xf1,0x00,0x00,0xb2,0xc0,0xdc,
-  0x00,0x00,0x00,0xff,0xff,0xff,0x00,0x00,0x00,0x2c,0x00,0x00,0x00,0x00,0x10,0x00,
-  0x10,0x00,0x00,0x02,0x2d,0x84,0x8f,0xa9,0x10,0xbb,0x01,0xa1,0x33,0xad,0x51,0x9b,
-  0x2c,0xbe,0x08,0x6f,0x26,0x31,0xdd,0x11,0x56,0x1f,0x38,0x06,0x42,0x79,0x56,0xc2,
-  0x1b,0xa2,0x14,0xf3,0xae,0x8a,0xa4,0xa9,0x27,0x47,0x46,0xbe,0x3f,0x09,0x0a,0x87,
-  0x8b,0x02,0x00,0x3b
-  };
-
-
-
-#endif
+/*
+@file wxyzMainWindow.h
+
+Main window UI
+*/
+
+#ifndef WXYZMAINWINDOW_H
+#define WXYZMAINWINDOW_H
+
+// standard fox objects
+#include "fx.h"
+#include "fx3d.h"
+// my fox object
+#include "FXGLPM.h"
+#include "FXGLAxis.h"
+#include "FXGLGrid.h"
+#include "FXSmoothCanvas.h"
+
+// Main Window
+class WxyzMainWindow : public FXMainWindow
+{
+
+	FXDECLARE(WxyzMainWindow)
+
+private:
+	FXMenuPane		*filemenu;		// file menu
+	FXMenuPane		*helpmenu;		// help menu
+	FXStatusBar		*statusbar;		// Status bar
+	FXMenuBar		*menubar;		// Menu bar
+	FXSmoothCanvas	*canvas;        // Canvas to draw into
+	FXSlider		*pmLevelSlider; // display the current level
+	FXGLVisual		*glvisual;		// enables opengl window
+	FXGLViewer		*gldisplay;		// place to draw
+	FXSpinner		*neighborhoodSelectionLevelSpinner;
+	FXSpinner	*range;				// range of the frequency
+
+	FXGLPM		*pmMesh;		// scene object
+	FXGLAxis	*glAxis;
+	FXGLGrid	*glGrid;
+	FXGLGroup	*foxScene;		// scene object
+
+	FXGLSphere	*fxSphere;
+	FXDial	*radiusSlider; 
+	bool flagSphere;
+	PM::Point center;
+	float radius,oldradius;
+	FXdouble dminscale;
+	FXDataTarget       dt;
+
+	// slider transition, see onGeomorphTimeout()
+	int geomorphFrame;
+	int geomorphTarget;			// level at the end
+	bool geomorphCoarsening;	// morph towards the coarse level
+	bool geomorphPending;		// a timeout is on its way
+
+protected:
+	WxyzMainWindow(){};
+	void initVariables();
+	void initGUI();
+	void updateSphere();
+	void fitView();
+
+public:
+	enum
+	{
+		ID_ABOUT=FXMainWindow::ID_LAST,
+		ID_OPEN,
+		ID_SAVE,
+		ID_GLVIEWER,
+		ID_BUILD_PM,
+		ID_PM_LEVEL_CHANGE,
+		// ID_SMOOTH_PM,
+		ID_RECOMPUTE_DETAIL,
+		ID_NEIGHBORHOOD_LEVEL_CHANGE,
+		ID_SPHERE,
+		ID_RADIUS_CHANGE,
+		ID_SHADING,
+		ID_REALTIME,
+		ID_APPLY,				// apply the frequency function
+		ID_CHANGE_RANGE,		// range of the frequency function
+		ID_RESET,				// reset range
+		ID_STREAM_TIMEOUT,		// read more of a PM stream
+		ID_GEOMORPH_TIMEOUT,	// next frame of a level transition
+		ID_REFINE_SELECTION		// selective refinement
+	};
+
+	// ms between reads of a PM stream
+	enum { STREAM_POLL_INTERVAL = 100 };
+
+	// level transitions of the slider: frames, ms per frame
+	enum { GEOMORPH_FRAMES = 8, GEOMORPH_INTERVAL = 30 };
+
+	
+	// WxyzMainWindow constructor
+	WxyzMainWindow(FXApp* a);
+
+	// Initialize
+	virtual void create();
+
+	// WxyzMainWindow destructor
+	virtual ~WxyzMainWindow();
+
+	// set of message handlers
+	long onPaint(FXObject*,FXSelector,void*);
+	long onMouseDown(FXObject*,FXSelector,void*);
+	long onRightBtClicked(FXObject*,FXSelector,void*);
+	long onMouseMove(FXObject*,FXSelector,void*);
+	long onMouseRelease(FXObject*,FXSelector,void*);
+
+	long onCmdOpen(FXObject*,FXSelector,void*);
+	long onCmdSave(FXObject*,FXSelector,void*);
+	long onCmdAbout(FXObject*,FXSelector,void*);
+	long onUpdatePMLevel(FXObject*,FXSelector,void*);
+	long onBuildPM(FXObject*,FXSelector,void*);
+	// long onSmoothPM(FXObject*,FXSelector,void*);
+	long onRecomputeDetail(FXObject*,FXSelector,void*);
+	long onNeighborhoodLevelChange(FXObject*,FXSelector,void*);
+	long onSphere(FXObject*,FXSelector,void*);
+	long onRadiusChange(FXObject*,FXSelector,void*);
+	long onApply(FXObject*,FXSelector,void*);
+	long onChangeRealtime(FXObject*,FXSelector,void*);
+	long onApplyRealTime(FXObject*,FXSelector,void*);
+	long onChangeRange(FXObject*,FXSelector,void*);
+	long onReset(FXObject*,FXSelector,void*);
+	long onChangeShading(FXObject*,FXSelector,void*);
+	long onStreamTimeout(FXObject*,FXSelector,void*);
+	long onGeomorphTimeout(FXObject*,FXSelector,void*);
+	long onRefineSelection(FXObject*,FXSelector,void*);
+
+	// update
+	void updateScene();
+};
+
+FXDEFMAP(WxyzMainWindow) WxyzMainWindowMap[]={
+
+	//________Message_Type_____________________ID____________Message_Handler_______
+	FXMAPFUNC(SEL_LEFTBUTTONPRESS,  WxyzMainWindow::ID_ABOUT, WxyzMainWindow::onMouseDown),
+	FXMAPFUNC(SEL_RIGHTBUTTONPRESS,	WxyzMainWindow::ID_ABOUT, WxyzMainWindow::onRightBtClicked),
+	FXMAPFUNC(SEL_MOTION,			WxyzMainWindow::ID_ABOUT, WxyzMainWindow::onMouseMove),
+	FXMAPFUNC(SEL_LEFTBUTTONRELEASE,WxyzMainWindow::ID_ABOUT, WxyzMainWindow::onMouseRelease),
+	FXMAPFUNC(SEL_PAINT,   WxyzMainWindow::ID_ABOUT, WxyzMainWindow::onPaint),
+	FXMAPFUNC(SEL_COMMAND, WxyzMainWindow::ID_OPEN, WxyzMainWindow::onCmdOpen),
+	FXMAPFUNC(SEL_COMMAND, WxyzMainWindow::ID_SAVE, WxyzMainWindow::onCmdSave),
+	FXMAPFUNC(SEL_COMMAND, WxyzMainWindow::ID_ABOUT, WxyzMainWindow::onCmdAbout),
+	FXMAPFUNC(SEL_COMMAND, WxyzMainWindow::ID_BUILD_PM, WxyzMainWindow::onBuildPM),
+	FXMAPFUNC(SEL_CHANGED, WxyzMainWindow::ID_PM_LEVEL_CHANGE, WxyzMainWindow::onUpdatePMLevel),
+	// FXMAPFUNC(SEL_COMMAND, WxyzMainWindow::ID_SMOOTH_PM, WxyzMainWindow::onSmoothPM),
+	FXMAPFUNC(SEL_COMMAND, WxyzMainWindow::ID_RECOMPUTE_DETAIL, WxyzMainWindow::onRecomputeDetail),
+	FXMAPFUNC(SEL_COMMAND, WxyzMainWindow::ID_NEIGHBORHOOD_LEVEL_CHANGE, WxyzMainWindow::onNeighborhoodLevelChange),
+	FXMAPFUNC(SEL_COMMAND, WxyzMainWindow::ID_SPHERE, WxyzMainWindow::onSphere),
+	FXMAPFUNC(SEL_COMMAND, WxyzMainWindow::ID_REFINE_SELECTION, WxyzMainWindow::onRefineSelection),
+	FXMAPFUNC(SEL_COMMAND, WxyzMainWindow::ID_RADIUS_CHANGE, WxyzMainWindow::onRadiusChange),
+	FXMAPFUNC(SEL_COMMAND, WxyzMainWindow::ID_APPLY,  WxyzMainWindow::onApply),
+	FXMAPFUNC(SEL_COMMAND, WxyzMainWindow::ID_CHANGE_RANGE,  WxyzMainWindow::onChangeRange),
+	FXMAPFUNC(SEL_COMMAND, WxyzMainWindow::ID_RESET,  WxyzMainWindow::onReset),
+	FXMAPFUNC(SEL_COMMAND, WxyzMainWindow::ID_SHADING,  WxyzMainWindow::onChangeShading),
+	FXMAPFUNC(SEL_COMMAND, WxyzMainWindow::ID_REALTIME,  WxyzMainWindow::onChangeRealtime),
+	FXMAPFUNC(SEL_TIMEOUT, WxyzMainWindow::ID_STREAM_TIMEOUT,  WxyzMainWindow::onStreamTimeout),
+	FXMAPFUNC(SEL_TIMEOUT, WxyzMainWindow::ID_GEOMORPH_TIMEOUT,  WxyzMainWindow::onGeomorphTimeout),
+};
+
+// Bitmap icon data
+const unsigned char cowiconChar[]={
+  0x47,0x49,0x46,0x38,0x39,0x61,0x20,0x00,0x20,0x00,0xe6,0x00,0x00,0x00,0x00,0x00,
+  0xff,0xff,0xff,0x00,0x00,0x20,0x00,0x00,0x1b,0x00,0x00,0x19,0x00,0x00,0x15,0x00,
+  0x00,0x12,0x00,0x00,0x0c,0x00,0x00,0x09,0x00,0x00,0x04,0x00,0x01,0x22,0x00,0x04,
+  0x25,0x00,0x08,0x29,0x00,0x0c,0x2c,0x00,0x0f,0x33,0x00,0x0e,0x2f,0x00,0x13,0x37,
+  0x00,0x14,0x38,0x00,0x16,0x3a,0x00,0x1b,0x42,0x00,0x1a,0x40,0x00,0x20,0x45,0x00,
+  0x22,0x47,0x00,0x29,0x52,0x00,0x27,0x4c,0x00,0x25,0x4b,0x00,0x2e,0x57,0x00,0x2b,
+  0x53,0x00,0x32,0x5c,0x00,0x31,0x59,0x00,0x39,0x63,0x00,0x35,0x5e,0x00,0x3c,0x65,
+  0x00,0x38,0x60,0x01,0x40,0x6a,0x00,0x3e,0x67,0x01,0x45,0x6d,0x04,0x4a,0x71,0x04,
+  0x47,0x6f,0x07,0x50,0x77,0x07,0x4c,0x75,0x09,0x51,0x78,0x0d,0x53,0x7c,0x0f,0x5a,
+  0x83,0x0f,0x58,0x80,0x13,0x5f,0x89,0x13,0x5c,0x85,0x19,0x66,0x90,0x19,0x63,0x8c,
+  0x1b,0x67,0x92,0x21,0x6f,0x9a,0x0d,0x57,0x7e,0x15,0x62,0x8a,0x1b,0x6a,0x95,0x1e,
+  0x6d,0x97,0x21,0x71,0x9c,0x27,0x78,0xa1,0x27,0x76,0x9e,0x2b,0x7a,0xa4,0x2e,0x80,
+  0xa8,0x2e,0x7d,0xa5,0x31,0x82,0xab,0x33,0x84,0xad,0x3c,0x8c,0xb5,0x24,0x75,0x9c,
+  0x33,0x85,0xad,0x37,0x89,0xaf,0x39,0x8b,0xb3,0x3c,0x90,0xb6,0x3f,0x92,0xba,0x42,
+  0x95,0xba,0x45,0x98,0xc0,0x45,0x97,0xbc,0x47,0x9c,0xc1,0x4b,0x9e,0xc3,0x4d,0x9f,
+  0xc7,0x59,0xab,0xd0,0x4d,0xa3,0xc7,0x51,0xa4,0xc8,0x53,0xa7,0xca,0x57,0xaa,0xce,
+  0x5c,0xaf,0xd3,0x5c,0xae,0xd0,0x60,0xb3,0xd5,0x63,0xb5,0xd8,0x66,0xb6,0xd8,0x6f,
+  0xbd,0xdf,0x75,0xc2,0xe2,0x7d,0xc9,0xe9,0x80,0xcd,0xec,0x83,0xce,0xed,0x8b,0xd5,
+  0xf3,0x96,0xdc,0xf8,0x69,0xba,0xda,0x6c,0xbc,0xdc,0x71,0xc1,0xdf,0x75,0xc6,0xe3,
+  0x77,0xc8,0xe6,0x7a,0xc8,0xe6,0x85,0xd0,0xed,0x89,0xd4,0xf0,0x8f,0xd8,0xf4,0x92,
+  0xdb,0xf4,0x98,0xdf,0xfa,0x9e,0xe3,0xfe,0x9c,0xe1,0xfa,0xa4,0xe8,0xff,0xa1,0xe6,
+  0xff,0xaa,0xec,0xff,0xad,0xef,0xff,0xd0,0xff,0xff,0xa7,0xeb,0xff,0xb3,0xf3,0xff,
+  0xc3,0xfe,0xff,0xdf,0xff,0xff,0xeb,0xff,0xff,0xaf,0xf2,0xff,0xff,0xff,0xff,0xff,
+  0xff,0xff,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+  0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x21,0xf9,0x04,
+  0x01,0x00,0x00,0x76,0x00,0x2c,0x00,0x00,0x00,0x00,0x20,0x00,0x20,0x00,0x00,0x07,
+  0xff,0x80,0x76,0x82,0x83,0x84,0x83,0x4d,0x85,0x88,0x89,0x8a,0x83,0x4e,0x47,0x8b,
+  0x8f,0x8f,0x28,0x47,0x1c,0x90,0x95,0x88,0x29,0x11,0x96,0x88,0x4e,0x8f,0x14,0x00,
+  0x9a,0x83,0x38,0x22,0x90,0x00,0x02,0x38,0xa0,0x2a,0x0a,0x94,0x8f,0x0d,0x2a,0x5f,
+  0x64,0x4a,0x50,0x46,0x61,0x89,0x50,0x47,0x4c,0x38,0x07,0x89,0x5c,0x71,0x84,0x1e,
+  0x21,0x5a,0x6b,0x66,0x51,0x3e,0x3e,0x3b,0x32,0x38,0x37,0x47,0x60,0x68,0x69,0x3f,
+  0x27,0x88,0x55,0x67,0x60,0x58,0x44,0x3e,0x41,0x82,0x31,0x18,0x2c,0x2e,0x2a,0x31,
+  0x30,0x35,0x36,0x40,0x2f,0x35,0x51,0x62,0x26,0x8a,0x64,0x67,0xd3,0x66,0x40,0x39,
+  0x37,0x45,0x76,0x29,0x45,0x3a,0x5d,0x52,0x54,0x42,0x3a,0x38,0x43,0x41,0x3e,0x37,
+  0x82,0x59,0x10,0xc5,0x51,0xc3,0x85,0x4c,0x14,0x25,0x28,0x68,0xfc,0xc8,0x72,0xc6,
+  0x07,0x8e,0x28,0x60,0xc0,0x88,0x91,0x32,0x64,0x48,0x12,0x25,0x4e,0xa8,0xe8,0x10,
+  0xd1,0x64,0x4d,0xa1,0x34,0x67,0xb6,0x90,0xe1,0x02,0xe6,0x01,0x45,0x30,0x3c,0xbc,
+  0x68,0x81,0xc2,0xa5,0xcc,0x98,0x22,0x3d,0x76,0x28,0xa1,0x02,0xe6,0x47,0x93,0x1f,
+  0x3e,0x10,0xad,0xd9,0xb2,0x05,0x4d,0x17,0x23,0x20,0x98,0xb0,0xf0,0x40,0x83,0x8d,
+  0x0e,0x34,0x66,0xc6,0x80,0xb1,0xb2,0x83,0xc7,0x0f,0x29,0x49,0x9c,0x80,0x49,0x93,
+  0x28,0x0c,0x17,0x34,0x4b,0x62,0x90,0x98,0x30,0x23,0x42,0x93,0x2c,0x58,0xcc,0x70,
+  0x39,0x43,0xe5,0x48,0x93,0x21,0x38,0x64,0xfc,0xb8,0x72,0x68,0xd1,0x1b,0x8f,0x82,
+  0xff,0x44,0x88,0x10,0xc2,0x64,0xe4,0x96,0x2c,0x3f,0x98,0x3c,0x39,0x82,0x63,0x05,
+  0x0d,0xaa,0xa0,0x4a,0x5c,0xa8,0xb1,0x44,0x4a,0x19,0x2d,0x52,0x88,0x18,0x51,0x8c,
+  0x04,0x19,0x28,0x3b,0x21,0x60,0x6c,0xb8,0xd1,0x24,0x09,0x18,0x32,0x43,0x88,0xdc,
+  0xf8,0x71,0xc3,0xc6,0x8d,0x17,0xa0,0x32,0x6c,0x78,0xf1,0x01,0x48,0x90,0x24,0x4f,
+  0xc0,0x10,0x01,0x62,0xc3,0x05,0x8a,0x15,0x2d,0x5e,0xa0,0xa8,0x04,0x21,0x83,0x02,
+  0x0c,0x32,0x52,0xdc,0xe8,0x51,0xe4,0xc8,0x12,0x19,0x39,0x46,0x7c,0x48,0x02,0x85,
+  0xc8,0x91,0x24,0x4c,0x0b,0xcd,0x00,0x20,0x41,0x82,0x85,0x14,0x22,0x08,0x40,0xb0,
+  0x91,0xa3,0x46,0x90,0x1e,0x46,0x74,0xdc,0x00,0x21,0xc1,0x08,0x0d,0x2d,0x57,0xd0,
+  0x7c,0xd9,0xf2,0x66,0x90,0x8b,0x0e,0x19,0x30,0x38,0x38,0xf1,0x62,0x46,0x87,0x02,
+  0x02,0x54,0xe0,0xe8,0xd1,0xe3,0x74,0x10,0x18,0x29,0x20,0x2c,0xd1,0x42,0x62,0x88,
+  0x8e,0x23,0x66,0xa0,0xf1,0x84,0x1d,0x3d,0xc4,0xc0,0x01,0x06,0x12,0x88,0x70,0x43,
+  0x0e,0x2e,0x50,0xb0,0x80,0x03,0x30,0xd0,0xd0,0x82,0x10,0x45,0x20,0xf1,0xc4,0x06,
+  0x13,0xb0,0x90,0x03,0x18,0x3d,0xc0,0x50,0x46,0x10,0x64,0x88,0x11,0x86,0x0b,0x50,
+  0x74,0x40,0x01,0x08,0x19,0xbc,0x90,0x44,0x10,0x34,0x58,0x30,0xc0,0x03,0x17,0xe4,
+  0xc0,0x03,0x0b,0x36,0xc8,0x40,0x83,0x06,0x1a,0x20,0xd1,0x43,0x13,0xaf,0x54,0x61,
+  0xc4,0x16,0x5d,0x54,0xd1,0xc1,0x08,0x10,0x8c,0xe0,0x40,0x0c,0x31,0x3c,0x51,0x04,
+  0xf8,0x10,0x11,0x48,0x10,0x41,0x02,0x10,0xa0,0x10,0xc3,0x0c,0x2c,0xcc,0x50,0x02,
+  0x05,0x1c,0xf0,0x30,0x44,0x13,0x42,0xe0,0x80,0x44,0x11,0x39,0x40,0xa6,0x01,0x08,
+  0x11,0x88,0x30,0xc3,0x11,0x5e,0x74,0xe1,0xc3,0x05,0x16,0x50,0x70,0x01,0x00,0x00,
+  0x44,0xe0,0xc0,0x03,0x0f,0xc0,0x27,0x84,0x05,0x2d,0x28,0xd1,0x04,0x10,0x50,0x2c,
+  0x21,0x88,0x07,0x23,0xcc,0xf0,0x00,0x6c,0x47,0x5c,0x71,0x05,0x0f,0x25,0x74,0xf0,
+  0xc1,0x81,0x08,0x38,0x00,0x42,0x09,0x2e,0x8c,0x50,0x00,0x9c,0x0a,0xa8,0xa0,0x01,
+  0x09,0x33,0x0c,0xa2,0xc1,0x08,0x21,0x50,0xa0,0x02,0x11,0x58,0x88,0x01,0x85,0x0e,
+  0x30,0x90,0xf0,0x01,0x08,0x5b,0xc1,0xa9,0xaa,0x0a,0x8f,0x9c,0x50,0x02,0x03,0x22,
+  0xb0,0xe0,0x84,0x19,0x69,0x08,0x01,0x44,0x0c,0x2e,0x84,0x10,0x9c,0x0d,0x2d,0xc4,
+  0x60,0xc3,0x06,0x95,0xa8,0x40,0x42,0x03,0x30,0xf0,0x10,0x45,0x19,0x6f,0x04,0x01,
+  0xc4,0x38,0x2e,0xe8,0x20,0x03,0x0f,0x3a,0xf0,0xd0,0x83,0xb4,0x90,0xac,0x30,0x82,
+  0x05,0x30,0x38,0x61,0x45,0x1a,0x6f,0x08,0x11,0x84,0x0e,0x2f,0xc8,0x98,0x0c,0x0e,
+  0x3c,0xd8,0x10,0x05,0x0c,0x90,0xd0,0x60,0x22,0x0c,0x50,0x8c,0x71,0xc6,0x1a,0x45,
+  0x04,0xb1,0x43,0x0e,0x3b,0x38,0x04,0x04,0x0e,0x3b,0x3c,0xe0,0x04,0xba,0x8f,0xb4,
+  0x20,0x42,0x07,0x2f,0xa8,0xb4,0x45,0x1a,0x47,0x5c,0x87,0x6f,0x10,0x3f,0xf4,0x20,
+  0xc4,0x0e,0x10,0x08,0x01,0xcd,0x23,0x81,0x00,0x00,0x3b
+  };
+
+
+// File Open
+const unsigned char fileopeniconChar[]=
+{
+	0x47,0x49,0x46,0x38,0x37,0x61,0x10,0x00,0x10,0x00,0xf2,0x00,0x00,0xb2,0xc0,0xdc,
+	0x00,0x00,0x00,0x00,0xff,0x00,0xff,0xff,0x00,0x80,0x80,0x80,0xff,0xff,0xff,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x2c,0x00,0x00,0x00,0x00,0x10,0x00,0x10,0x00,0x00,0x03,
+	0x45,0x08,0xba,0x1c,0xfe,0x2c,0xae,0x20,0x44,0x90,0x91,0xd6,0x8b,0x95,0xb6,0x1c,
+	0x00,0x79,0x95,0x25,0x3e,0x03,0x31,0x3c,0xa5,0x73,0xaa,0xf0,0xda,0xae,0x5e,0xfa,
+	0xdc,0xb8,0xa3,0x06,0xc5,0xd0,0xff,0x3e,0x9f,0xc3,0x16,0x04,0x02,0x75,0x81,0xa2,
+	0xb2,0x77,0x49,0xf2,0x96,0xc5,0x26,0x21,0x69,0x54,0x36,0xa9,0x50,0xa6,0xe7,0x59,
+	0xfd,0x71,0x72,0x60,0x4e,0x02,0x00,0x3b
+};
+
+
+// File Save
+const unsigned char filesaveiconChar[]={
+  0x47,0x49,0x46,0x38,0x37,0x61,0x10,0x00,0x10,0x00,0xf3,0x00,0x00,0x80,0x80,0x80,
+  0xb2,0xc0,0xdc,0xff,0xff,0xff,0xff,0xff,0x00,0x00,0x00,0x00,0x80,0x80,0x00,0x00,
+  0x00,0xff,0x00,0xff,0xff,0x00,0x00,0x80,0xc0,0xc0,0xc0,0x00,0x80,0x80,0x00,0x00,
+  0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x2c,0x00,0x00,
+  0x00,0x00,0x10,0x00,0x10,0x00,0x00,0x04,0x5a,0x10,0xc8,0x19,0xaa,0xbd,0x40,0x0c,
+  0x91,0xc1,0xfd,0xc0,0x36,0x10,0x24,0xf1,0x59,0x99,0x58,0x4c,0x2c,0xba,0x19,0x5a,
+  0x26,0xcc,0x9c,0x17,0x64,0xc6,0x01,0xcb,0x74,0x77,0xe7,0x07,0x9d,0x0c,0xc6,0x99,
+  0x49,0x04,0x40,0x1d,0x12,0xd1,0x29,0x85,0x90,0x41,0xdd,0x81,0x39,0x4b,0x24,0x08,
+  0x29,0x68,0x94,0x4a,0xc3,0x8a,0xb4,0x53,0x9e,0x00,0x5b,0x4a,0x86,0x69,0xe3,0x89,
+  0x01,0xc1,0x6e,0x8b,0x4d,0x16,0x85,0x02,0x3b,0x41,0xc3,0x31,0x68,0xfb,0x09,0x50,
+  0xea,0x93,0x22,0x00,0x3b
+  };
+
+
+// No shading
+const unsigned char nolight[]={
+  0x47,0x49,0x46,0x38,0x37,0x61,0x10,0x00,0x10,0x00,0xf2,0x00,0x00,0xb2,0xc0,0xdc,
+  0x00,0x00,0x00,0xc0,0xc0,0xc0,0x80,0x80,0x00,0x00,0x00,0x80,0x80,0x80,0x80,0x00,
+  0x00,0x00,0x00,0x00,0x00,0x2c,0x00,0x00,0x00,0x00,0x10,0x00,0x10,0x00,0x00,0x03,
+  0x33,0x08,0x1a,0xac,0xfe,0x2e,0x88,0x19,0x20,0x94,0x02,0x57,0xbb,0xb2,0xdf,0x9c,
+  0x24,0x66,0x5c,0x24,0x82,0x25,0xc0,0xa0,0x69,0x30,0xb0,0x0f,0x11,0xbd,0x1c,0x61,
+  0x9b,0xb0,0x7d,0x3b,0x85,0xa5,0xef,0xa5,0x1f,0xb0,0x26,0x4c,0x09,0x87,0x90,0xa3,
+  0x2c,0x65,0x49,0x00,0x00,0x3b
+  };
+
+// Shading
+const unsigned char light[]={
+  0x47,0x49,0x46,0x38,0x37,0x61,0x10,0x00,0x10,0x00,0xf2,0x00,0x00,0xb2,0xc0,0xdc,
+  0x00,0x00,0x00,0xff,0xff,0x00,0xff,0xff,0xff,0x80,0x80,0x00,0x00,0x00,0xff,0x80,
+  0x80,0x80,0x00,0x00,0x00,0x2c,0x00,0x00,0x00,0x00,0x10,0x00,0x10,0x00,0x00,0x03,
+  0x34,0x08,0x10,0xac,0xfe,0x2e,0x88,0x19,0x20,0x94,0x62,0x50,0x1b,0xb3,0xaf,0xdc,
+  0xe2,0x69,0x60,0xc8,0x08,0x4d,0x18,0xa5,0xaa,0x12,0x10,0xa5,0x55,0x14,0x2e,0xcc,
+  0xcd,0xb3,0xcb,0x3a,0x78,0xae,0x18,0xb2,0x1e,0x2d,0x24,0xf4,0xdd,0x8a,0xc4,0xe2,
+  0x30,0x88,0x6c,0x41,0x12,0x00,0x3b
+  };
+
+/* Generated by reswrap from file milo24.gif */
+const unsigned char miloIconChar[]={
+  0x47,0x49,0x46,0x38,0x39,0x61,0x18,0x00,0x18,0x00,0xf7,0x00,0x00,0x00,0x00,0x00,
+  0xff,0xff,0xff,0x68,0x68,0x68,0x65,0x64,0x65,0x64,0x64,0x66,0x63,0x63,0x65,0x67,
+  0x67,0x68,0x65,0x66,0x67,0x68,0x69,0x69,0x6b,0x6b,0x6a,0xd0,0xcc,0xad,0xdb,0xd7,
+  0xb7,0xd4,0xd0,0xb1,0xc8,0xc4,0xa7,0xc7,0xc3,0xa6,0xd9,0xd4,0xb4,0xd0,0xcb,0xad,
+  0xcf,0xca,0xac,0xce,0xc9,0xab,0xc8,0xc3,0xa6,0xc7,0xc2,0xa5,0xc4,0xbf,0xa3,0xd5,
+  0xd0,0xb2,0xd3,0xce,0xb0,0xd1,0xcc,0xae,0xce,0xc9,0xac,0xcc,0xc7,0xaa,0xbd,0xb7,
+  0x9b,0xcb,0xc5,0xa7,0xc6,0xc0,0xa3,0xcb,0xc5,0xa8,0xbc,0xb5,0x99,0xc0,0xb9,0x9d,
+  0xbf,0xb9,0x9e,0xc3,0xbd,0xa2,0xc2,0xbc,0xa1,0xc0,0xba,0x9f,0xba,0xb2,0x96,0xab,
+  0xa4,0x8a,0xbc,0xb5,0x9a,0xbb,0xb4,0x99,0xb7,0xb0,0x96,0xb6,0xaf,0x95,0xb5,0xae,
+  0x94,0xb4,0xad,0x93,0xba,0xb3,0x99,0xc7,0xc0,0xa5,0xc2,0xbb,0xa1,0xad,0xa7,0x90,
+  0x9f,0x9a,0x87,0x94,0x90,0x82,0xaf,0xa7,0x8e,0xad,0xa5,0x8c,0xb9,0xb1,0x97,0xb2,
+  0xaa,0x91,0xb1,0xa9,0x90,0xb0,0xa8,0x8f,0x9a,0x91,0x79,0x9f,0x96,0x7e,0xac,0xa3,
+  0x89,0xa9,0xa0,0x87,0xa5,0x9c,0x84,0xa4,0x9b,0x83,0xac,0xa3,0x8a,0xab,0xa2,0x89,
+  0xa6,0x9d,0x85,0xb0,0xa7,0x8e,0xaf,0xa6,0x8d,0xab,0xa2,0x8a,0xaa,0xa1,0x89,0xa9,
+  0xa0,0x88,0xb3,0xaa,0x92,0x91,0x8b,0x7b,0x86,0x82,0x76,0x9f,0x95,0x7d,0xa3,0x99,
+  0x81,0xb3,0xa9,0x8f,0xa1,0x98,0x81,0xaf,0xa5,0x8d,0x8d,0x87,0x78,0x88,0x84,0x7a,
+  0xa3,0x98,0x7f,0x96,0x8c,0x75,0x95,0x8b,0x74,0x91,0x87,0x71,0xa1,0x96,0x7e,0xa0,
+  0x95,0x7d,0x9f,0x95,0x7e,0xa1,0x97,0x80,0xa5,0x9b,0x84,0xa8,0x9e,0x87,0x95,0x8d,
+  0x7b,0x7b,0x78,0x71,0x84,0x79,0x63,0x96,0x8a,0x73,0x8f,0x84,0x6e,0x8e,0x83,0x6d,
+  0x96,0x8b,0x74,0x95,0x8a,0x73,0x94,0x89,0x73,0x93,0x88,0x72,0x86,0x7c,0x68,0x9a,
+  0x8f,0x78,0x9d,0x92,0x7b,0x98,0x8d,0x77,0x9b,0x90,0x7a,0xa2,0x97,0x80,0x9d,0x92,
+  0x7c,0x6b,0x6a,0x68,0x77,0x6c,0x58,0x80,0x74,0x5f,0x82,0x76,0x61,0x8b,0x7f,0x69,
+  0x88,0x7c,0x67,0x87,0x7b,0x66,0x8d,0x81,0x6b,0x93,0x87,0x71,0x90,0x84,0x6f,0x8d,
+  0x82,0x6d,0x8b,0x80,0x6b,0x93,0x87,0x72,0x6a,0x66,0x5f,0x6c,0x60,0x4d,0x6f,0x63,
+  0x50,0x7f,0x73,0x5f,0x7f,0x73,0x60,0x85,0x79,0x65,0x88,0x7c,0x68,0x8c,0x80,0x6c,
+  0x4a,0x3e,0x2d,0x45,0x3a,0x2a,0x4e,0x42,0x30,0x4f,0x43,0x32,0x4d,0x42,0x31,0x5f,
+  0x52,0x3f,0x67,0x59,0x45,0x61,0x54,0x41,0x65,0x58,0x45,0x67,0x5a,0x47,0x6b,0x5e,
+  0x4a,0x69,0x5c,0x49,0x6a,0x5d,0x4a,0x63,0x57,0x45,0x5a,0x4f,0x3f,0x6c,0x5f,0x4c,
+  0x6f,0x62,0x4f,0x76,0x69,0x55,0x73,0x66,0x53,0x72,0x65,0x52,0x75,0x68,0x55,0x76,
+  0x69,0x56,0x7c,0x6f,0x5b,0x77,0x6a,0x57,0x7e,0x71,0x5d,0x79,0x6c,0x59,0x7b,0x6e,
+  0x5b,0x7e,0x71,0x5e,0x7d,0x70,0x5d,0x83,0x76,0x62,0x86,0x79,0x65,0x84,0x77,0x63,
+  0x88,0x7b,0x67,0x8b,0x7e,0x6a,0x60,0x59,0x4f,0x6f,0x6d,0x6a,0x4a,0x3d,0x2b,0x4d,
+  0x40,0x2f,0x48,0x3c,0x2c,0x52,0x45,0x33,0x4a,0x3e,0x2e,0x53,0x46,0x34,0x50,0x43,
+  0x32,0x54,0x47,0x35,0x51,0x44,0x33,0x52,0x45,0x34,0x56,0x49,0x37,0x57,0x4a,0x38,
+  0x58,0x4b,0x39,0x5e,0x50,0x3d,0x59,0x4c,0x3a,0x56,0x49,0x38,0x5b,0x4e,0x3c,0x5c,
+  0x4f,0x3d,0x53,0x47,0x37,0x63,0x55,0x42,0x5d,0x50,0x3e,0x64,0x56,0x43,0x5e,0x51,
+  0x3f,0x65,0x57,0x44,0x68,0x5a,0x47,0x61,0x54,0x42,0x69,0x5b,0x48,0x6a,0x5c,0x49,
+  0x60,0x53,0x42,0x6c,0x5e,0x4b,0x65,0x58,0x46,0x67,0x5a,0x48,0x6e,0x60,0x4d,0x72,
+  0x64,0x51,0x75,0x67,0x54,0x74,0x66,0x53,0x6e,0x61,0x4f,0x6d,0x60,0x4e,0x52,0x48,
+  0x3b,0x7b,0x6d,0x5a,0x3e,0x32,0x23,0x3f,0x33,0x24,0x41,0x35,0x26,0x42,0x36,0x27,
+  0x43,0x37,0x28,0x44,0x38,0x29,0x4c,0x3f,0x2f,0x4d,0x40,0x30,0x4e,0x41,0x31,0x5b,
+  0x4d,0x3b,0x5a,0x4c,0x3b,0x60,0x52,0x40,0x5d,0x4f,0x3e,0x61,0x53,0x41,0x66,0x57,
+  0x45,0x67,0x59,0x47,0x5d,0x50,0x40,0x71,0x63,0x51,0x4f,0x45,0x39,0x3c,0x30,0x22,
+  0x3a,0x2e,0x21,0x40,0x34,0x26,0x46,0x39,0x2a,0x3f,0x33,0x26,0x47,0x3a,0x2b,0x4a,
+  0x3d,0x2e,0x43,0x37,0x2a,0x4c,0x3f,0x30,0x46,0x3a,0x2d,0x4e,0x41,0x33,0x45,0x38,
+  0x2b,0x4a,0x40,0x36,0x66,0x63,0x60,0x41,0x35,0x2a,0x3c,0x31,0x27,0x39,0x2c,0x21,
+  0x34,0x28,0x1f,0x31,0x25,0x1d,0x2a,0x1f,0x19,0x69,0x69,0x69,0x67,0x67,0x67,0xff,
+  0xff,0xff,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+  0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x21,0xf9,0x04,
+  0x01,0x00,0x00,0xf6,0x00,0x2c,0x00,0x00,0x00,0x00,0x18,0x00,0x18,0x00,0x00,0x08,
+  0xff,0x00,0xe1,0x89,0x73,0x94,0x2c,0x11,0xa3,0x5c,0xb9,0x80,0x71,0xc2,0x53,0x45,
+  0x4b,0x91,0x2b,0x58,0x8c,0x18,0x51,0x91,0x61,0x01,0x8b,0x2e,0x25,0x9e,0x99,0x1b,
+  0x47,0xc8,0x96,0xad,0x55,0x86,0x70,0x59,0x0a,0xf5,0xe5,0x8e,0x1c,0x40,0x8b,0x64,
+  0xbd,0x1a,0xa6,0xe6,0x82,0x09,0x4b,0x6e,0xd8,0xb9,0x5b,0x17,0x0e,0xda,0xba,0x55,
+  0xaa,0x54,0xed,0xe2,0x06,0x09,0x52,0x27,0x3c,0x9a,0xa8,0x35,0x03,0xc7,0x08,0x04,
+  0x07,0x20,0x3b,0x24,0x05,0xbb,0xa5,0x0e,0xdd,0xb4,0x53,0xd0,0xa4,0x09,0x6a,0x05,
+  0x4b,0x15,0x36,0x39,0x3a,0x2a,0x0d,0x5a,0x65,0xab,0x87,0x05,0x17,0x28,0xd0,0xbd,
+  0x7a,0x35,0x6b,0x50,0x34,0x68,0xcf,0x0a,0xcd,0xd2,0x56,0x6b,0xd5,0x21,0x2c,0x2c,
+  0xb2,0xc8,0x99,0xb4,0x8d,0x8a,0x87,0x08,0x0f,0x9e,0xa5,0xb2,0x36,0x2b,0x15,0x34,
+  0x71,0xd0,0x76,0x79,0x12,0x93,0x43,0xca,0x14,0x1d,0x29,0x42,0xac,0xe1,0x94,0x48,
+  0xd3,0x8a,0x0a,0x0c,0xe4,0xbd,0x8b,0x85,0x8b,0x55,0x34,0x67,0x82,0x7c,0xf9,0x59,
+  0x62,0xa3,0x85,0x08,0x07,0x11,0x42,0x60,0xd9,0xe4,0xca,0x1a,0x0f,0x08,0x14,0xa4,
+  0xa5,0xab,0x45,0x2b,0xd5,0x33,0x69,0xa9,0x6a,0x61,0x22,0xe3,0x63,0xc5,0x88,0x09,
+  0x12,0x5e,0xa4,0x59,0xe4,0x88,0xdb,0x19,0x0c,0x22,0xa0,0xc5,0x93,0x36,0x48,0x50,
+  0xb5,0x61,0xda,0x58,0x35,0xf2,0xe3,0xa5,0x89,0x0a,0x12,0x15,0x2a,0x34,0xd9,0x13,
+  0xc7,0xcd,0xa7,0x1f,0x45,0x1e,0x95,0x22,0x47,0x2e,0x56,0xa3,0x4d,0x98,0x6c,0xc5,
+  0xff,0xa2,0x24,0x87,0x8e,0x8f,0x1b,0x2d,0x1c,0xe0,0xa0,0x56,0xae,0x5c,0xb5,0x5f,
+  0x39,0xda,0x2d,0x3b,0x37,0x8f,0x5c,0x9b,0x3f,0x9e,0x14,0x0d,0xb2,0x55,0x09,0x54,
+  0x1d,0x25,0x34,0x34,0xf0,0xc1,0x2a,0xe1,0x84,0xf3,0x4c,0x1b,0x1d,0x20,0x40,0x4f,
+  0x1e,0xdf,0xc0,0xd3,0x08,0x1d,0x71,0x40,0x52,0x4d,0x2b,0xbd,0x30,0x03,0x0a,0x15,
+  0x5a,0x90,0xc0,0x02,0x24,0x68,0x49,0xd3,0xc5,0x10,0x02,0x08,0x40,0x4f,0x02,0xa3,
+  0xc4,0x02,0xc7,0x17,0x95,0xcc,0x42,0x4d,0x2d,0xc2,0x74,0x02,0xc6,0x12,0x3c,0x8c,
+  0xf1,0xcb,0x35,0xa6,0x64,0x23,0x09,0x19,0x21,0x86,0xc8,0x46,0x19,0x73,0x88,0xd2,
+  0x09,0x37,0xad,0xa4,0x32,0x0b,0x25,0x7e,0x8c,0xb1,0x84,0x1e,0xd1,0x74,0xb3,0xc7,
+  0x1f,0x6b,0x6c,0x90,0xa3,0x01,0xf4,0x6c,0x61,0x05,0x20,0xa0,0x78,0x73,0x4d,0x39,
+  0xa8,0x08,0xb3,0xc9,0x1c,0x40,0x04,0xa1,0x8c,0x22,0xcc,0x5c,0xc2,0xc7,0x09,0x39,
+  0x0a,0x70,0xc0,0x13,0x51,0x98,0x01,0x87,0x26,0xc3,0xb8,0xd2,0x0a,0x2e,0xde,0xc8,
+  0x41,0x84,0x10,0x71,0x24,0x12,0xc9,0x1b,0x5a,0x8c,0x50,0x26,0x01,0x49,0x54,0x11,
+  0xc6,0x18,0x6f,0x1c,0x83,0x08,0x2a,0xaf,0xf4,0xf2,0xc6,0x18,0x62,0x64,0x51,0x84,
+  0x0d,0x1a,0x28,0xa0,0x67,0x8e,0x07,0x70,0x41,0xc3,0x1d,0x75,0xd4,0xd1,0x49,0x24,
+  0xb5,0x50,0x33,0x0b,0x32,0x7e,0xcc,0xb1,0x86,0x16,0x4e,0xd8,0x30,0x43,0x11,0x65,
+  0xd6,0x43,0x0a,0x0b,0x60,0x44,0xf2,0xc9,0x1d,0x7c,0x44,0x62,0xcb,0x2b,0xb4,0xe4,
+  0x88,0x12,0xc9,0x31,0x7c,0x88,0x81,0xc6,0x1f,0x4a,0x94,0x09,0x25,0x0c,0x4a,0xe8,
+  0x62,0x0d,0x24,0x99,0xf4,0x51,0xc9,0x22,0x86,0xac,0xe2,0x4a,0x2c,0x86,0x1c,0x53,
+  0x89,0x1d,0x2b,0x94,0x29,0xc0,0x00,0x31,0xec,0xd0,0x88,0x2b,0x81,0xb8,0x62,0x08,
+  0x31,0x91,0x18,0x53,0xcc,0x2f,0x8a,0xfc,0xd2,0x8b,0x27,0x2c,0xa4,0xe0,0x6c,0x01,
+  0x32,0x30,0x81,0x8c,0x2b,0xa9,0xa4,0x3b,0x08,0x2c,0xb1,0x68,0x73,0x88,0x30,0x8b,
+  0xec,0x21,0xc5,0x11,0x4e,0x96,0x59,0x00,0x14,0x2a,0x5c,0xa2,0x4a,0x2a,0xa6,0x50,
+  0x83,0xca,0x35,0xb2,0xc8,0xa2,0xcb,0x2f,0xc0,0x5c,0x72,0x05,0x0e,0x8f,0xe6,0x58,
+  0x0f,0x12,0x35,0xc4,0x61,0x4d,0x2a,0xd4,0xb4,0xa2,0xca,0x2b,0xb5,0x18,0xc2,0x8b,
+  0x30,0x94,0x84,0x72,0x46,0x0b,0x14,0x04,0x04,0x00,0x3b
+  };
+
+// Parallel projection
+const unsigned char parallel[]={
+  0x47,0x49,0x46,0x38,0x37,0x61,0x10,0x00,0x10,0x00,0xf1,0x00,0x00,0xb2,0xc0,0xdc,
+  0x00,0x00,0x00,0xff,0xff,0xff,0x00,0x00,0x00,0x2c,0x00,0x00,0x00,0x00,0x10,0x00,
+  0x10,0x00,0x00,0x02,0x31,0x84,0x6f,0x11,0xc8,0xa7,0xa0,0x56,0x83,0x12,0xa6,0x4a,
+  0x19,0x8e,0x6f,0x66,0x25,0x08,0x9d,0x53,0x81,0xa1,0xb8,0x8c,0xd7,0x79,0x62,0x24,
+  0x1b,0x4a,0xa3,0xc9,0x6e,0x69,0x00,0x8b,0x0d,0x07,0xdb,0x08,0x2d,0x73,0xbd,0x22,
+  0x9e,0x9f,0xb0,0x58,0x2c,0x00,0x00,0x3b
+  };
+
+// Perspective projection
+const unsigned char perspective[]={
+  0x47,0x49,0x46,0x38,0x37,0x61,0x10,0x00,0x10,0x00,0xf1,0x00,0x00,0xb2,0xc0,0xdc,
+  0x00,0x00,0x00,0xff,0xff,0xff,0x00,0x00,0x00,0x2c,0x00,0x00,0x00,0x00,0x10,0x00,
+  0x10,0x00,0x00,0x02,0x2d,0x84,0x8f,0xa9,0x10,0xbb,0x01,0xa1,0x33,0xad,0x51,0x9b,
+  0x2c,0xbe,0x08,0x6f,0x26,0x31,0xdd,0x11,0x56,0x1f,0x38,0x06,0x42,0x79,0x56,0xc2,
+  0x1b,0xa2,0x14,0xf3,0xae,0x8a,0xa4,0xa9,0x27,0x47,0x46,0xbe,0x3f,0x09,0x0a,0x87,
+  0x8b,0x02,0x00,0x3b
+  };
+
+
+
+#endif